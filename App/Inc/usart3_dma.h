@@ -6,13 +6,20 @@
 #include <stdint.h>
 
 #include "attr.h"
+#include "sync.h"
 
 #include "stm32f4xx_ll_dma.h"
 #include "stm32f4xx_ll_usart.h"
 
+#define usart3DMA_TX_OK ((int32_t) 0)
+#define usart3DMA_TX_ERROR ((int32_t) -1)
+
 void usart3_dma_init(void (*recv_func)(const void *data, size_t len));
 void usart3_dma_rx_check(void);
-void usart3_send_string(const char *str);
+bool usart3_dma_send_async(const void *data, size_t len,
+                           Completion_t *completion);
+void usart3_dma_send_abort(void);
+bool usart3_send_string(const char *str);
 
 /** 
  * @brief Check if the DMA half-transfer interrupt flag is set
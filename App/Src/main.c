@@ -1,4 +1,5 @@
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "kernel.h"
@@ -7,45 +8,57 @@
 #include "shell.h"
 #include "sync.h"
 #include "usart3_dma.h"
+#include "workq.h"
 
 #define QUEUE_SIZE 10
+#define PONG0_READY (1U << 0)
 
 static int help_func(int argc, char **argv);
 static int ping_func(int argc, char **argv);
 static int list_func(int argc, char **argv);
+static int jobs_func(int argc, char **argv);
+#if OCTOS_CRITICAL_PROFILING
+static int crit_func(int argc, char **argv);
+#endif
+void shell_thread(void);
+void led3_thread(void);
+void pong0_thread(void);
+void pong1_thread(void);
+void pong2_thread(void);
+void pong3_thread(void);
 
-static TaskHandle_t usart_dma_rx_thread_handle;
-static TaskHandle_t pong0_thread_handle;
 static Shell_t shell;
 static ShellCommand_t commands[] = {{.name = "help", .handler = &help_func},
                                     {.name = "ping", .handler = &ping_func},
-                                    {.name = "list", .handler = &list_func}};
-static MsgQueue_t usart3_rx_queue;
-static uint8_t usart3_rx_queue_storage[QUEUE_SIZE];
-static Mutex_t shell_print_mutex;
-static Barrier_t pong_barrier;
-static MsgQueue_t pong_queue;
-static uint8_t pong_queue_storage[QUEUE_SIZE];
-static Event_t pong0_event;
+                                    {.name = "list", .handler = &list_func},
+                                    {.name = "jobs", .handler = &jobs_func},
+#if OCTOS_CRITICAL_PROFILING
+                                    {.name = "crit", .handler = &crit_func},
+#endif
+};
+static OCTOS_MQUEUE_DEFINE(usart3_rx_queue, 1, QUEUE_SIZE);
+static OCTOS_MUTEX_DEFINE(shell_print_mutex);
+static OCTOS_BARRIER_DEFINE(pong_barrier, 4);
+static OCTOS_MQUEUE_DEFINE(pong_queue, 1, QUEUE_SIZE);
+static OCTOS_EVENT_GROUP_DEFINE(pong_events);
+OCTOS_TASK_DEFINE(shell_thread_handle, &shell_thread, NULL, "SHELL", 3, 512);
+OCTOS_TASK_DEFINE_CCMRAM(led3_thread_handle, &led3_thread, NULL, "LED 3", 0,
+                         256);
+OCTOS_TASK_DEFINE(pong0_thread_handle, &pong0_thread, NULL, "PONG 0", 1, 256);
+OCTOS_TASK_DEFINE(pong1_thread_handle, &pong1_thread, NULL, "PONG 1", 1, 256);
+OCTOS_TASK_DEFINE(pong2_thread_handle, &pong2_thread, NULL, "PONG 2", 2, 256);
+OCTOS_TASK_DEFINE(pong3_thread_handle, &pong3_thread, NULL, "PONG 3", 2, 256);
+static WorkQueue_t system_workq;
+static Work_t usart3_rx_work;
+static TaskPeriodic_t led1_periodic;
+static TaskPeriodic_t led2_periodic;
 
 
 /* Simple LED Threads --------------------------------------------------------*/
 
-void led1_thread(void) {
-    BSP_LED_Toggle(LED1);
-    while (1) {
-        task_delay(time_to_ticks(1, SECONDS));
-        BSP_LED_Toggle(LED1);
-    }
-}
+void led1_job(void) { BSP_LED_Toggle(LED1); }
 
-void led2_thread(void) {
-    BSP_LED_Toggle(LED2);
-    while (1) {
-        task_delay(time_to_ticks(2, SECONDS));
-        BSP_LED_Toggle(LED2);
-    }
-}
+void led2_job(void) { BSP_LED_Toggle(LED2); }
 
 void led3_thread(void) {
     uint32_t cnt = 0;
@@ -66,11 +79,13 @@ void shell_process_char_wrapper(const void *data, size_t len) {
     }
 }
 
-void usart_dma_rx_thread(void) {
-    while (1) {
-        task_notify_wait(0, 0, NULL, UINT32_MAX);
-        usart3_dma_rx_check(); /* <-- Will call shell_process_char_wrapper */
-    }
+void usart_dma_rx_work(OCTOS_UNUSED void *args) {
+    usart3_dma_rx_check(); /* <-- Will call shell_process_char_wrapper */
+}
+
+void shell_print_wrapper(const char *str) {
+    /* Shell output is best effort, a failed line is dropped */
+    (void) usart3_send_string(str);
 }
 
 /* Pong Threads --------------------------------------------------------------*/
@@ -79,7 +94,7 @@ void pong0_thread(void) {
     const char msg[] = "pong0000000000000000000000000000000\r\n";
     while (1) {
         task_notify_wait(0, 0, NULL, UINT32_MAX);
-        event_set(&pong0_event);
+        event_group_set(&pong_events, PONG0_READY);
         barrier_wait(&pong_barrier, UINT32_MAX);
         mutex_acquire(&shell_print_mutex, UINT32_MAX);
         for (size_t i = 0; msg[i] != '\0'; i++) {
@@ -92,8 +107,8 @@ void pong0_thread(void) {
 void pong1_thread(void) {
     const char msg[] = "pong111111111111111111111111111111\r\n";
     while (1) {
-        event_wait(&pong0_event, UINT32_MAX);
-        event_clear(&pong0_event);
+        event_group_wait(&pong_events, PONG0_READY, WaitAll, true, NULL,
+                         UINT32_MAX);
         barrier_wait(&pong_barrier, UINT32_MAX);
         mutex_acquire(&shell_print_mutex, UINT32_MAX);
         for (size_t i = 0; msg[i] != '\0'; i++) {
@@ -179,9 +194,57 @@ int list_func(OCTOS_UNUSED int argc, OCTOS_UNUSED char **argv) {
     return 0;
 }
 
+int jobs_func(OCTOS_UNUSED int argc, OCTOS_UNUSED char **argv) {
+    TaskPeriodic_t *const periodics[] = {&led1_periodic, &led2_periodic};
+    const char *const names[] = {"LED 1", "LED 2"};
+    char buffer[128];
+
+    mutex_acquire(&shell_print_mutex, UINT32_MAX);
+    for (size_t i = 0; i < sizeof(periodics) / sizeof(periodics[0]); i++) {
+        TaskPeriodicStats_t stats;
+        task_periodic_get_stats(periodics[i], &stats);
+
+        const uint32_t mean_jitter_ns =
+                stats.Jobs > 0 ? (uint32_t) (stats.TotalJitterNs / stats.Jobs)
+                               : 0;
+        snprintf(buffer, sizeof(buffer),
+                 "%-8s jobs %lu overruns %lu response %lu "
+                 "jitter mean/max %lu/%lu ns\r\n",
+                 names[i], (unsigned long) stats.Jobs,
+                 (unsigned long) stats.Overruns,
+                 (unsigned long) stats.MaxResponse,
+                 (unsigned long) mean_jitter_ns,
+                 (unsigned long) stats.MaxJitterNs);
+        shell.print(buffer);
+    }
+    mutex_release(&shell_print_mutex);
+
+    return 0;
+}
+
+#if OCTOS_CRITICAL_PROFILING
+int crit_func(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "reset") == 0) {
+        profile_critical_reset();
+        return 0;
+    }
+
+    char *buffer = OCTOS_MALLOC(1024 * sizeof(char));
+    if (buffer == NULL) return 1;
+    profile_critical_report(buffer, 1024);
+
+    mutex_acquire(&shell_print_mutex, UINT32_MAX);
+    shell.print(buffer);
+    mutex_release(&shell_print_mutex);
+
+    OCTOS_FREE(buffer);
+    return 0;
+}
+#endif
+
 void shell_thread(void) {
     shell_init(&shell, commands, sizeof(commands) / sizeof(commands[0]),
-               &usart3_send_string);
+               &shell_print_wrapper);
     char buffer;
     while (1) {
         if (mqueue_recv(&usart3_rx_queue, &buffer, UINT32_MAX)) {
@@ -193,27 +256,17 @@ void shell_thread(void) {
 /* Main Functions ------------------------------------------------------------*/
 
 int main(void) {
-    mqueue_init(&usart3_rx_queue, usart3_rx_queue_storage, 1, QUEUE_SIZE);
-    mqueue_init(&pong_queue, pong_queue_storage, 1, QUEUE_SIZE);
-    mutex_init(&shell_print_mutex);
-    event_init(&pong0_event);
-    barrier_init(&pong_barrier, 4);
     usart3_dma_init(&shell_process_char_wrapper);
     BSP_LED_Init(LED1);
     BSP_LED_Init(LED2);
     BSP_LED_Init(LED3);
 
-    task_create((TaskFunc_t) &usart_dma_rx_thread, NULL, "UART DMA RX", 4, 512,
-                &usart_dma_rx_thread_handle);
-    task_create((TaskFunc_t) &shell_thread, NULL, "SHELL", 3, 512, NULL);
-    task_create((TaskFunc_t) &led1_thread, NULL, "LED 1", 1, 256, NULL);
-    task_create((TaskFunc_t) &led2_thread, NULL, "LED 2", 1, 256, NULL);
-    task_create((TaskFunc_t) &led3_thread, NULL, "LED 3", 0, 256, NULL);
-    task_create((TaskFunc_t) &pong0_thread, NULL, "PONG 0", 1, 256,
-                &pong0_thread_handle);
-    task_create((TaskFunc_t) &pong1_thread, NULL, "PONG 1", 1, 256, NULL);
-    task_create((TaskFunc_t) &pong2_thread, NULL, "PONG 2", 2, 256, NULL);
-    task_create((TaskFunc_t) &pong3_thread, NULL, "PONG 3", 2, 256, NULL);
+    work_init(&usart3_rx_work, &usart_dma_rx_work, NULL, 0);
+    workq_init(&system_workq, "WORKQ", 4, 1, 512);
+    task_create_periodic(&led1_periodic, (TaskFunc_t) &led1_job, NULL, "LED 1",
+                         1, 256, time_to_ticks(1, SECONDS), 0, NULL);
+    task_create_periodic(&led2_periodic, (TaskFunc_t) &led2_job, NULL, "LED 2",
+                         1, 256, time_to_ticks(2, SECONDS), 0, NULL);
 
     Quanta_t quanta = {.Unit = MILISECONDS, .Value = 1};
     kernel_launch(&quanta);
@@ -225,12 +278,12 @@ void DMA1_Stream1_IRQHandler(void) {
     bool switch_required = false;
 
     if (usart3_dma_rx_check_ht()) {
-        task_notify_from_isr(usart_dma_rx_thread_handle, 0, NoAction,
-                             &switch_required);
+        workq_submit_from_isr(&system_workq, &usart3_rx_work,
+                              &switch_required);
     }
     if (usart3_dma_rx_check_tc()) {
-        task_notify_from_isr(usart_dma_rx_thread_handle, 0, NoAction,
-                             &switch_required);
+        workq_submit_from_isr(&system_workq, &usart3_rx_work,
+                              &switch_required);
     }
 
     task_yield_from_isr(switch_required);
@@ -240,8 +293,8 @@ void USART3_IRQHandler(void) {
     bool switch_required = false;
 
     if (usart3_dma_rx_check_idle()) {
-        task_notify_from_isr(usart_dma_rx_thread_handle, 0, NoAction,
-                             &switch_required);
+        workq_submit_from_isr(&system_workq, &usart3_rx_work,
+                              &switch_required);
     }
 
     task_yield_from_isr(switch_required);
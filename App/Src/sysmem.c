@@ -24,6 +24,8 @@
 #include <errno.h>
 #include <stdint.h>
 
+#include "list.h"
+
 /**
  * Pointer to the current high watermark of the heap usage
  */
@@ -58,6 +60,13 @@ void *_sbrk(ptrdiff_t incr) {
     const uint8_t *max_heap = (uint8_t *) stack_limit;
     uint8_t *prev_heap_end;
 
+#if OCTOS_COMPACT_LIST
+    /* Task pages come from the heap, keep them within reach of the compact
+     * links of the lists in .data and .bss */
+    extern uint8_t _sdata;
+    if (max_heap > &_sdata + LIST_LINK_REACH) max_heap = &_sdata + LIST_LINK_REACH;
+#endif
+
     /* Initialize heap end at first call */
     if (NULL == __sbrk_heap_end) {
         __sbrk_heap_end = &_end;
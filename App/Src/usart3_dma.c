@@ -2,15 +2,21 @@
 
 #include "usart3_dma.h"
 
+#include "Arch/stm32f4xx/Inc/api.h"
+#include "sync.h"
+
 #include "stm32f4xx_ll_bus.h"
 #include "stm32f4xx_ll_dma.h"
 #include "stm32f4xx_ll_gpio.h"
 #include "stm32f4xx_ll_usart.h"
 
 #define UART_DMA_RX_BUFFER_SIZE 64
+#define UART_DMA_TX_MAX_LENGTH UINT16_MAX
 
 static uint8_t usart_rx_dma_buffer[UART_DMA_RX_BUFFER_SIZE];
 static void (*usart3_dma_recv_func)(const void *data, size_t len) = NULL;
+static Completion_t *volatile usart3_tx_completion = NULL;
+static Mutex_t usart3_tx_mutex;
 
 /** 
  * @brief Initialize USART3 with DMA for receiving data
@@ -61,6 +67,28 @@ void usart3_dma_init(void (*recv_func)(const void *data, size_t len)) {
     NVIC_SetPriority(DMA1_Stream1_IRQn, 13);
     NVIC_EnableIRQ(DMA1_Stream1_IRQn);
 
+    /* Configure USART3 TX DMA, memory address and length are set per
+     * transfer */
+    LL_DMA_SetChannelSelection(DMA1, LL_DMA_STREAM_3, LL_DMA_CHANNEL_4);
+    LL_DMA_SetDataTransferDirection(DMA1, LL_DMA_STREAM_3,
+                                    LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+    LL_DMA_SetStreamPriorityLevel(DMA1, LL_DMA_STREAM_3, LL_DMA_PRIORITY_LOW);
+    LL_DMA_SetMode(DMA1, LL_DMA_STREAM_3, LL_DMA_MODE_NORMAL);
+    LL_DMA_SetPeriphIncMode(DMA1, LL_DMA_STREAM_3, LL_DMA_PERIPH_NOINCREMENT);
+    LL_DMA_SetMemoryIncMode(DMA1, LL_DMA_STREAM_3, LL_DMA_MEMORY_INCREMENT);
+    LL_DMA_SetPeriphSize(DMA1, LL_DMA_STREAM_3, LL_DMA_PDATAALIGN_BYTE);
+    LL_DMA_SetMemorySize(DMA1, LL_DMA_STREAM_3, LL_DMA_MDATAALIGN_BYTE);
+    LL_DMA_DisableFifoMode(DMA1, LL_DMA_STREAM_3);
+    LL_DMA_SetPeriphAddress(DMA1, LL_DMA_STREAM_3,
+                            LL_USART_DMA_GetRegAddr(USART3));
+
+    /* Enable TC & TE interrupts */
+    LL_DMA_EnableIT_TC(DMA1, LL_DMA_STREAM_3);
+    LL_DMA_EnableIT_TE(DMA1, LL_DMA_STREAM_3);
+    NVIC_SetPriority(DMA1_Stream3_IRQn, 13);
+    NVIC_EnableIRQ(DMA1_Stream3_IRQn);
+    mutex_init(&usart3_tx_mutex);
+
     /* USART configuration */
     LL_USART_InitTypeDef usart_init = {0};
     usart_init.BaudRate = 115200;
@@ -73,6 +101,7 @@ void usart3_dma_init(void (*recv_func)(const void *data, size_t len)) {
     LL_USART_Init(USART3, &usart_init);
     LL_USART_ConfigAsyncMode(USART3);
     LL_USART_EnableDMAReq_RX(USART3);
+    LL_USART_EnableDMAReq_TX(USART3);
     LL_USART_EnableIT_IDLE(USART3);
 
     /* USART interrupt */
@@ -148,11 +177,138 @@ void usart3_dma_rx_check(void) {
     }
 }
 
+/**
+ * @brief Start an asynchronous transmission via USART3 DMA
+ * @note The completion is completed from the DMA interrupt with
+ *       usart3DMA_TX_OK or usart3DMA_TX_ERROR. The data must stay valid and
+ *       must not live in CCM RAM until then
+ * @param data: Pointer to the data to be transmitted
+ * @param len: Length of the data, at most UINT16_MAX bytes
+ * @param completion: Pointer to the completion tracking the transmission
+ * @retval true If the transmission was started
+ * @retval false If a transmission is already in flight or len is invalid
+ */
+bool usart3_dma_send_async(const void *data, size_t len,
+                           Completion_t *completion) {
+    if (len == 0 || len > UART_DMA_TX_MAX_LENGTH) return false;
+
+    bool busy = true;
+
+    OCTOS_ENTER_CRITICAL();
+    if (usart3_tx_completion == NULL) {
+        usart3_tx_completion = completion;
+        busy = false;
+    }
+    OCTOS_EXIT_CRITICAL();
+
+    if (busy) return false;
+
+    completion_reset(completion);
+
+    /* Stream flags must be cleared before the stream is enabled again */
+    LL_DMA_ClearFlag_TC3(DMA1);
+    LL_DMA_ClearFlag_HT3(DMA1);
+    LL_DMA_ClearFlag_TE3(DMA1);
+    LL_DMA_ClearFlag_DME3(DMA1);
+    LL_DMA_ClearFlag_FE3(DMA1);
+
+    LL_DMA_SetMemoryAddress(DMA1, LL_DMA_STREAM_3, (uint32_t) data);
+    LL_DMA_SetDataLength(DMA1, LL_DMA_STREAM_3, len);
+    LL_USART_ClearFlag_TC(USART3);
+    LL_DMA_EnableStream(DMA1, LL_DMA_STREAM_3);
+
+    return true;
+}
+
+/**
+ * @brief Abort the transmission in flight via USART3 DMA
+ * @note The completion of the aborted transmission is left uncompleted, the
+ *       stream is idle and ready for the next transmission on return
+ * @return None
+ */
+void usart3_dma_send_abort(void) {
+    /* Disabling the stream raises its transfer complete flag, detach the
+     * completion first so that the interrupt does not complete it */
+    OCTOS_ENTER_CRITICAL();
+    usart3_tx_completion = NULL;
+    OCTOS_EXIT_CRITICAL();
+
+    LL_DMA_DisableStream(DMA1, LL_DMA_STREAM_3);
+    while (LL_DMA_IsEnabledStream(DMA1, LL_DMA_STREAM_3));
+}
+
+/**
+ * @brief Handle the USART3 TX DMA interrupt
+ * @note Owned by the driver so every application linking it gets the TX
+ *       completion
+ * @return None
+ */
+void DMA1_Stream3_IRQHandler(void) {
+    bool switch_required = false;
+    int32_t status;
+
+    if (LL_DMA_IsEnabledIT_TE(DMA1, LL_DMA_STREAM_3) &&
+        LL_DMA_IsActiveFlag_TE3(DMA1)) {
+        LL_DMA_ClearFlag_TE3(DMA1);
+        status = usart3DMA_TX_ERROR;
+    } else if (LL_DMA_IsEnabledIT_TC(DMA1, LL_DMA_STREAM_3) &&
+               LL_DMA_IsActiveFlag_TC3(DMA1)) {
+        LL_DMA_ClearFlag_TC3(DMA1);
+        status = usart3DMA_TX_OK;
+    } else {
+        return;
+    }
+
+    /* The stream disables itself on both transfer complete and error */
+    Completion_t *const completion = usart3_tx_completion;
+    usart3_tx_completion = NULL;
+
+    if (completion != NULL)
+        completion_complete_from_isr(completion, status, &switch_required);
+
+    task_yield_from_isr(switch_required);
+}
+
 /** 
  * @brief Send a string via USART3
+ * @note Blocks the calling task until the string is transmitted, the CPU is
+ *       free for other tasks meanwhile. Must be called from a task
+ * @note On a transfer error the transmission is aborted, the rest of the
+ *       string is not sent
  * @param str: Pointer to the string to be sent
- * @return None
+ * @retval true If the whole string was transmitted
+ * @retval false If a transmission could not be started or failed
  */
-void usart3_send_string(const char *str) {
-    usart3_dma_process_data(str, strlen(str));
+bool usart3_send_string(const char *str) {
+    Completion_t completion;
+    size_t len = strlen(str);
+    bool result = true;
+
+    completion_init(&completion);
+    mutex_acquire(&usart3_tx_mutex, UINT32_MAX);
+
+    while (len > 0) {
+        const size_t chunk = len > UART_DMA_TX_MAX_LENGTH
+                                     ? UART_DMA_TX_MAX_LENGTH
+                                     : len;
+
+        if (!usart3_dma_send_async(str, chunk, &completion)) {
+            result = false;
+            break;
+        }
+
+        if (!completion_wait(&completion, UINT32_MAX) ||
+            completion_get_status(&completion) != usart3DMA_TX_OK) {
+            usart3_dma_send_abort();
+            result = false;
+            break;
+        }
+
+        str += chunk;
+        len -= chunk;
+    }
+
+    mutex_release(&usart3_tx_mutex);
+
+    return result;
 }
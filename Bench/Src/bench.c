@@ -0,0 +1,517 @@
+/**
+ * @file bench.c
+ * @brief On-target kernel benchmark suite
+ * @note Every result is printed on USART3 as one CSV line
+ *       "BENCH,<name>,<param>,<samples>,<min>,<mean>,<max>" in CPU cycles,
+ *       the run ends with a "BENCH_DONE" line
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "Arch/stm32f4xx/Inc/api.h"
+#include "kernel.h"
+#include "usart3_dma.h"
+
+#define BENCH_ITERATIONS 1000
+#define BENCH_PRIORITY 3
+#define BENCH_PAGE_SIZE 256
+#define BENCH_MQUEUE_LENGTH 16
+#define BENCH_MQUEUE_MAX_ITEM 64
+#define BENCH_TICK_SAMPLES 100
+#define BENCH_TICK_MARGIN 1000
+#define BENCH_MAX_SLEEPERS 16
+#define BENCH_RPC_SIZE 16
+
+/**
+ * @brief Cycle statistics of a benchmark
+ */
+typedef struct BenchStats {
+    uint32_t Count;       /*!< Number of samples */
+    uint32_t MinCycles;   /*!< Shortest sample */
+    uint32_t MaxCycles;   /*!< Longest sample */
+    uint64_t TotalCycles; /*!< Sum of the samples */
+} BenchStats_t;
+
+static Sema_t bench_done;
+static Sema_t bench_ping;
+static Sema_t bench_pong;
+static Mutex_t bench_mutex;
+static Event_t bench_event_ping;
+static Event_t bench_event_pong;
+static MsgQueue_t bench_mqueue;
+static uint8_t
+        bench_mqueue_storage[BENCH_MQUEUE_LENGTH * BENCH_MQUEUE_MAX_ITEM];
+static MsgQueue_t bench_mqueue_reply;
+static uint8_t bench_mqueue_reply_storage[BENCH_RPC_SIZE];
+static IpcEndpoint_t bench_ipc;
+static BenchStats_t bench_helper_stats;
+static TaskHandle_t bench_notify_task;
+static volatile uint32_t bench_start_cycles;
+static volatile Tick_t bench_wake_tick;
+
+/* Helpers -------------------------------------------------------------------*/
+
+static void bench_stats_init(BenchStats_t *stats) {
+    stats->Count = 0;
+    stats->MinCycles = UINT32_MAX;
+    stats->MaxCycles = 0;
+    stats->TotalCycles = 0;
+}
+
+static void bench_stats_add(BenchStats_t *stats, uint32_t cycles) {
+    stats->Count++;
+    stats->TotalCycles += cycles;
+    if (cycles < stats->MinCycles) stats->MinCycles = cycles;
+    if (cycles > stats->MaxCycles) stats->MaxCycles = cycles;
+}
+
+static void bench_report(const char *name, uint32_t param,
+                         BenchStats_t *stats) {
+    char line[96];
+    const uint32_t mean =
+            stats->Count > 0 ? (uint32_t) (stats->TotalCycles / stats->Count)
+                             : 0;
+    const uint32_t min = stats->Count > 0 ? stats->MinCycles : 0;
+
+    snprintf(line, sizeof(line), "BENCH,%s,%lu,%lu,%lu,%lu,%lu\r\n", name,
+             (unsigned long) param, (unsigned long) stats->Count,
+             (unsigned long) min, (unsigned long) mean,
+             (unsigned long) stats->MaxCycles);
+    usart3_send_string(line);
+}
+
+/**
+ * @brief Spawn a helper task for a benchmark
+ * @param func: Helper task body, must end with bench_park
+ * @param priority: Priority of the helper task
+ * @return Handle of the helper task
+ */
+static TaskHandle_t bench_spawn(void (*func)(void), uint8_t priority) {
+    TaskHandle_t handle = NULL;
+    task_create((TaskFunc_t) func, NULL, "BENCH HELPER", priority,
+                BENCH_PAGE_SIZE, &handle);
+    OCTOS_ASSERT(handle != NULL);
+    return handle;
+}
+
+/**
+ * @brief Signal the end of a helper task and park it until it is deleted
+ * @note Parked helpers are in no event list, deleting them is safe
+ * @return None
+ */
+static void bench_park(void) {
+    sema_release(&bench_done);
+    while (1) task_delay(BENCH_TICK_MARGIN);
+}
+
+/**
+ * @brief Wait for a helper task to finish and delete it
+ * @param handle: Handle of the helper task
+ * @return None
+ */
+static void bench_reap(TaskHandle_t handle) {
+    sema_acquire(&bench_done, UINT32_MAX);
+    task_delete(handle);
+}
+
+/* Scheduler -----------------------------------------------------------------*/
+
+static void bench_yield(void) {
+    BenchStats_t stats;
+    bench_stats_init(&stats);
+
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        const uint32_t start = OCTOS_CYCLE_COUNTER();
+        task_yield();
+        bench_stats_add(&stats, OCTOS_CYCLE_COUNTER() - start);
+    }
+
+    bench_report("yield", 0, &stats);
+}
+
+static void bench_ctx_switch_helper(void) {
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) task_yield();
+    bench_park();
+}
+
+static void bench_ctx_switch(void) {
+    BenchStats_t stats;
+    bench_stats_init(&stats);
+
+    TaskHandle_t helper =
+            bench_spawn(&bench_ctx_switch_helper, BENCH_PRIORITY);
+
+    /* Each round trip is two context switches */
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        const uint32_t start = OCTOS_CYCLE_COUNTER();
+        task_yield();
+        bench_stats_add(&stats, (OCTOS_CYCLE_COUNTER() - start) / 2);
+    }
+
+    bench_reap(helper);
+    bench_report("ctx_switch", 0, &stats);
+}
+
+static void bench_task_create_delete(void) {
+    BenchStats_t create_stats;
+    BenchStats_t delete_stats;
+    bench_stats_init(&create_stats);
+    bench_stats_init(&delete_stats);
+
+    /* Created below the bench priority, the tasks never run */
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        TaskHandle_t handle = NULL;
+
+        const uint32_t start = OCTOS_CYCLE_COUNTER();
+        task_create((TaskFunc_t) &bench_park, NULL, "BENCH TMP", 1,
+                    BENCH_PAGE_SIZE, &handle);
+        const uint32_t created = OCTOS_CYCLE_COUNTER();
+        task_delete(handle);
+        const uint32_t deleted = OCTOS_CYCLE_COUNTER();
+
+        bench_stats_add(&create_stats, created - start);
+        bench_stats_add(&delete_stats, deleted - created);
+    }
+
+    bench_report("task_create", BENCH_PAGE_SIZE, &create_stats);
+    bench_report("task_delete", BENCH_PAGE_SIZE, &delete_stats);
+}
+
+/* Synchronization -----------------------------------------------------------*/
+
+static void bench_sema_helper(void) {
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        sema_acquire(&bench_ping, UINT32_MAX);
+        sema_release(&bench_pong);
+    }
+    bench_park();
+}
+
+static void bench_sema_ping_pong(void) {
+    BenchStats_t stats;
+    bench_stats_init(&stats);
+
+    TaskHandle_t helper = bench_spawn(&bench_sema_helper, BENCH_PRIORITY);
+
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        const uint32_t start = OCTOS_CYCLE_COUNTER();
+        sema_release(&bench_ping);
+        sema_acquire(&bench_pong, UINT32_MAX);
+        bench_stats_add(&stats, OCTOS_CYCLE_COUNTER() - start);
+    }
+
+    bench_reap(helper);
+    bench_report("sema_ping_pong", 0, &stats);
+}
+
+static void bench_mutex_helper(void) {
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        sema_acquire(&bench_ping, UINT32_MAX);
+        mutex_acquire(&bench_mutex, UINT32_MAX);
+        bench_stats_add(&bench_helper_stats,
+                        OCTOS_CYCLE_COUNTER() - bench_start_cycles);
+        mutex_release(&bench_mutex);
+    }
+    bench_park();
+}
+
+static void bench_mutex_acquire_release(void) {
+    BenchStats_t stats;
+    bench_stats_init(&stats);
+    bench_stats_init(&bench_helper_stats);
+
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        const uint32_t start = OCTOS_CYCLE_COUNTER();
+        mutex_acquire(&bench_mutex, UINT32_MAX);
+        mutex_release(&bench_mutex);
+        bench_stats_add(&stats, OCTOS_CYCLE_COUNTER() - start);
+    }
+    bench_report("mutex_uncontended", 0, &stats);
+
+    /* The helper preempts, blocks on the held mutex and boosts the bench
+     * task, the release hands the mutex over to the helper */
+    TaskHandle_t helper = bench_spawn(&bench_mutex_helper, BENCH_PRIORITY + 1);
+    task_delay(1);
+
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        mutex_acquire(&bench_mutex, UINT32_MAX);
+        sema_release(&bench_ping);
+        bench_start_cycles = OCTOS_CYCLE_COUNTER();
+        mutex_release(&bench_mutex);
+    }
+
+    bench_reap(helper);
+    bench_report("mutex_handoff", 0, &bench_helper_stats);
+}
+
+static void bench_event_helper(void) {
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        event_wait(&bench_event_ping, UINT32_MAX);
+        event_clear(&bench_event_ping);
+        event_set(&bench_event_pong);
+    }
+    bench_park();
+}
+
+static void bench_event_ping_pong(void) {
+    BenchStats_t stats;
+    bench_stats_init(&stats);
+
+    TaskHandle_t helper = bench_spawn(&bench_event_helper, BENCH_PRIORITY);
+
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        const uint32_t start = OCTOS_CYCLE_COUNTER();
+        event_set(&bench_event_ping);
+        event_wait(&bench_event_pong, UINT32_MAX);
+        event_clear(&bench_event_pong);
+        bench_stats_add(&stats, OCTOS_CYCLE_COUNTER() - start);
+    }
+
+    bench_reap(helper);
+    bench_report("event_ping_pong", 0, &stats);
+}
+
+/* Message Queue -------------------------------------------------------------*/
+
+static void bench_mqueue_throughput(size_t item_size) {
+    BenchStats_t send_stats;
+    BenchStats_t recv_stats;
+    uint8_t item[BENCH_MQUEUE_MAX_ITEM];
+    bench_stats_init(&send_stats);
+    bench_stats_init(&recv_stats);
+
+    memset(item, 0xA5, sizeof(item));
+    mqueue_init(&bench_mqueue, bench_mqueue_storage, item_size,
+                BENCH_MQUEUE_LENGTH);
+
+    /* Fill then drain, per item cost without blocking */
+    for (uint32_t i = 0; i < BENCH_ITERATIONS / BENCH_MQUEUE_LENGTH; i++) {
+        const uint32_t start = OCTOS_CYCLE_COUNTER();
+        for (size_t k = 0; k < BENCH_MQUEUE_LENGTH; k++)
+            mqueue_send(&bench_mqueue, item, 0);
+        const uint32_t sent = OCTOS_CYCLE_COUNTER();
+        for (size_t k = 0; k < BENCH_MQUEUE_LENGTH; k++)
+            mqueue_recv(&bench_mqueue, item, 0);
+        const uint32_t received = OCTOS_CYCLE_COUNTER();
+
+        bench_stats_add(&send_stats, (sent - start) / BENCH_MQUEUE_LENGTH);
+        bench_stats_add(&recv_stats,
+                        (received - sent) / BENCH_MQUEUE_LENGTH);
+    }
+
+    bench_report("mqueue_send", item_size, &send_stats);
+    bench_report("mqueue_recv", item_size, &recv_stats);
+}
+
+/* Request and Response ------------------------------------------------------*/
+
+static void bench_mqueue_server(void) {
+    uint8_t message[BENCH_RPC_SIZE];
+
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        mqueue_recv(&bench_mqueue, message, UINT32_MAX);
+        mqueue_send(&bench_mqueue_reply, message, UINT32_MAX);
+    }
+    bench_park();
+}
+
+static void bench_ipc_server(void) {
+    uint8_t message[BENCH_RPC_SIZE];
+    TaskHandle_t caller;
+
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        ipc_recv(&bench_ipc, message, &caller, UINT32_MAX);
+        ipc_reply(&bench_ipc, caller, message);
+    }
+    bench_park();
+}
+
+/**
+ * @brief Compare a request and response over a pair of message queues with
+ *        a synchronous IPC call, server and client at the same priority
+ * @return None
+ */
+static void bench_rpc_round_trip(void) {
+    BenchStats_t mqueue_stats;
+    BenchStats_t ipc_stats;
+    uint8_t message[BENCH_RPC_SIZE];
+    bench_stats_init(&mqueue_stats);
+    bench_stats_init(&ipc_stats);
+
+    memset(message, 0xA5, sizeof(message));
+    mqueue_init(&bench_mqueue, bench_mqueue_storage, BENCH_RPC_SIZE, 1);
+    mqueue_init(&bench_mqueue_reply, bench_mqueue_reply_storage,
+                BENCH_RPC_SIZE, 1);
+    ipc_init(&bench_ipc, BENCH_RPC_SIZE, BENCH_RPC_SIZE);
+
+    TaskHandle_t helper = bench_spawn(&bench_mqueue_server, BENCH_PRIORITY);
+
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        const uint32_t start = OCTOS_CYCLE_COUNTER();
+        mqueue_send(&bench_mqueue, message, UINT32_MAX);
+        mqueue_recv(&bench_mqueue_reply, message, UINT32_MAX);
+        bench_stats_add(&mqueue_stats, OCTOS_CYCLE_COUNTER() - start);
+    }
+
+    bench_reap(helper);
+    helper = bench_spawn(&bench_ipc_server, BENCH_PRIORITY);
+
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        const uint32_t start = OCTOS_CYCLE_COUNTER();
+        ipc_call(&bench_ipc, message, message, UINT32_MAX);
+        bench_stats_add(&ipc_stats, OCTOS_CYCLE_COUNTER() - start);
+    }
+
+    bench_reap(helper);
+    bench_report("mqueue_round_trip", BENCH_RPC_SIZE, &mqueue_stats);
+    bench_report("ipc_round_trip", BENCH_RPC_SIZE, &ipc_stats);
+}
+
+/* Interrupt Latency ---------------------------------------------------------*/
+
+/**
+ * @brief Software triggered interrupt notifying the waiting helper
+ */
+void EXTI0_IRQHandler(void) {
+    bool switch_required = false;
+
+    task_notify_from_isr(bench_notify_task, 0, NoAction, &switch_required);
+
+    task_yield_from_isr(switch_required);
+}
+
+static void bench_isr_notify_helper(void) {
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        task_notify_wait(0, 0, NULL, UINT32_MAX);
+        bench_stats_add(&bench_helper_stats,
+                        OCTOS_CYCLE_COUNTER() - bench_start_cycles);
+    }
+    bench_park();
+}
+
+static void bench_isr_notify(void) {
+    bench_stats_init(&bench_helper_stats);
+
+    NVIC_SetPriority(EXTI0_IRQn, 13);
+    NVIC_EnableIRQ(EXTI0_IRQn);
+
+    /* The helper blocks before the first trigger */
+    bench_notify_task =
+            bench_spawn(&bench_isr_notify_helper, BENCH_PRIORITY + 1);
+    task_delay(1);
+
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        bench_start_cycles = OCTOS_CYCLE_COUNTER();
+        NVIC_SetPendingIRQ(EXTI0_IRQn);
+        OCTOS_DSB();
+        OCTOS_ISB();
+    }
+
+    NVIC_DisableIRQ(EXTI0_IRQn);
+    bench_reap(bench_notify_task);
+    bench_report("isr_notify_latency", 0, &bench_helper_stats);
+}
+
+/* Tick ----------------------------------------------------------------------*/
+
+static void bench_sleeper(void) {
+    task_delay((uint32_t) (bench_wake_tick - task_get_tick()));
+    bench_park();
+}
+
+/**
+ * @brief Measure task_tick_increment with sleeping tasks in the delayed list
+ * @note Ticks are advanced by hand within a critical section, as SysTick
+ *       does, so the sleepers all wake on the measured tick
+ * @param sleepers: Number of sleeping tasks
+ * @return None
+ */
+static void bench_tick(size_t sleepers) {
+    TaskHandle_t handles[BENCH_MAX_SLEEPERS];
+    BenchStats_t idle_stats;
+    BenchStats_t wake_stats;
+    bench_stats_init(&idle_stats);
+    bench_stats_init(&wake_stats);
+
+    bench_wake_tick = task_get_tick() + BENCH_TICK_MARGIN;
+    for (size_t i = 0; i < sleepers; i++)
+        handles[i] = bench_spawn(&bench_sleeper, BENCH_PRIORITY - 1);
+
+    /* Let the sleepers block */
+    task_delay(1);
+
+    for (uint32_t i = 0; i < BENCH_TICK_SAMPLES; i++) {
+        OCTOS_ENTER_CRITICAL();
+        const uint32_t start = OCTOS_CYCLE_COUNTER();
+        task_tick_increment();
+        bench_stats_add(&idle_stats, OCTOS_CYCLE_COUNTER() - start);
+        OCTOS_EXIT_CRITICAL();
+    }
+
+    OCTOS_ENTER_CRITICAL();
+    while (task_get_tick() + 1 < bench_wake_tick) task_tick_increment();
+    const uint32_t start = OCTOS_CYCLE_COUNTER();
+    task_tick_increment();
+    bench_stats_add(&wake_stats, OCTOS_CYCLE_COUNTER() - start);
+    OCTOS_EXIT_CRITICAL();
+
+    for (size_t i = 0; i < sleepers; i++) bench_reap(handles[i]);
+
+    bench_report("tick_idle", sleepers, &idle_stats);
+    if (sleepers > 0) bench_report("tick_wake", sleepers, &wake_stats);
+}
+
+/* Main Functions ------------------------------------------------------------*/
+
+static void bench_thread(void) {
+    static const size_t mqueue_item_sizes[] = {1, 4, 16, 64};
+    static const size_t tick_sleepers[] = {0, 1, 4, 16};
+
+    usart3_send_string("BENCH,name,param,samples,min,mean,max\r\n");
+
+    bench_yield();
+    bench_ctx_switch();
+    bench_task_create_delete();
+    bench_sema_ping_pong();
+    bench_mutex_acquire_release();
+    bench_event_ping_pong();
+    const size_t mqueue_item_count =
+            sizeof(mqueue_item_sizes) / sizeof(mqueue_item_sizes[0]);
+    for (size_t i = 0; i < mqueue_item_count; i++)
+        bench_mqueue_throughput(mqueue_item_sizes[i]);
+    bench_rpc_round_trip();
+    bench_isr_notify();
+    const size_t tick_count = sizeof(tick_sleepers) / sizeof(tick_sleepers[0]);
+    for (size_t i = 0; i < tick_count; i++) bench_tick(tick_sleepers[i]);
+
+    usart3_send_string("BENCH_DONE\r\n");
+    while (1) task_delay(BENCH_TICK_MARGIN);
+}
+
+int main(void) {
+    sema_init(&bench_done, 0);
+    sema_init(&bench_ping, 0);
+    sema_init(&bench_pong, 0);
+    mutex_init(&bench_mutex);
+    event_init(&bench_event_ping);
+    event_init(&bench_event_pong);
+    usart3_dma_init(NULL);
+    OCTOS_SETUP_CYCLE_COUNTER();
+
+    task_create((TaskFunc_t) &bench_thread, NULL, "BENCH", BENCH_PRIORITY,
+                1024, NULL);
+
+    Quanta_t quanta = {.Unit = MILISECONDS, .Value = 1};
+    kernel_launch(&quanta);
+}
+
+/* IRQHandler ----------------------------------------------------------------*/
+
+void DMA1_Stream1_IRQHandler(void) {
+    usart3_dma_rx_check_ht();
+    usart3_dma_rx_check_tc();
+}
+
+void USART3_IRQHandler(void) { usart3_dma_rx_check_idle(); }
@@ -0,0 +1,12 @@
+#ifndef __ARCH_PORT_H__
+#define __ARCH_PORT_H__
+
+/* Architecture port selection, the firmware build uses the STM32F4 port and
+ * the host build defines OCTOS_PORT_POSIX */
+#if defined(OCTOS_PORT_POSIX)
+#include "Arch/posix/Inc/api.h"// IWYU pragma: export
+#else
+#include "Arch/stm32f4xx/Inc/api.h"// IWYU pragma: export
+#endif
+
+#endif
@@ -0,0 +1,241 @@
+#ifndef __ARCH_POSIX_API_H__
+#define __ARCH_POSIX_API_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Kernel/Inc/config.h"
+#include "Kernel/Inc/profile.h"
+#include "Kernel/Inc/utils.h"
+#include "attr.h"
+
+/*
+ * POSIX port, runs the scheduler inside a single host process
+ *
+ * Interrupts         Signals, SIGALRM from setitimer() drives the tick
+ * BASEPRI masking    sigprocmask() blocking the port signals
+ * Task contexts      ucontext_t stored at the top of each task page
+ * PendSV             Deferred until the critical section or signal handler
+ *                    ends, then swapcontext() to the selected task
+ * LDREX/STREX        Emulated with a single reservation address that is
+ *                    cleared on every context switch and signal
+ * DWT->CYCCNT        CLOCK_MONOTONIC in nanoseconds
+ * TIM5 one-shot      POSIX timer on CLOCK_MONOTONIC raising SIGRTMIN
+ */
+
+/* Task pages come from malloc(), far out of reach of compact list links */
+#if OCTOS_COMPACT_LIST
+#error "OCTOS_COMPACT_LIST is target-only, the POSIX port does not support it"
+#endif
+
+#define OCTOS_DSB() __sync_synchronize()
+#define OCTOS_ISB() __sync_synchronize()
+#define OCTOS_ASSERT(x)                                                        \
+    if ((x) == 0) OCTOS_ASSERT_CALLED(__FILE__, __LINE__)
+
+extern volatile uint32_t critical_nesting;
+extern volatile void *volatile posix_exclusive_addr;
+
+void OCTOS_SCHED_LAUNCH(void);
+void OCTOS_SETUP_INTPRI(void);
+void OCTOS_SETUP_SYSTICK(Quanta_t *quanta);
+void OCTOS_ENABLE_SYSTICK(void);
+void OCTOS_SETUP_CYCLE_COUNTER(void);
+uint32_t OCTOS_CYCLE_COUNTER(void);
+uint32_t OCTOS_SYSTICK_ELAPSED_NS(bool *tick_pending);
+void OCTOS_SETUP_HRTIMER(void);
+void OCTOS_HRTIMER_ARM(uint32_t delay_us);
+void OCTOS_HRTIMER_DISARM(void);
+void OCTOS_ASSERT_CALLED(const char *file, uint64_t line);
+void *OCTOS_MALLOC(size_t wanted_size);
+void OCTOS_FREE(void *ptr_to_free);
+uint32_t *OCTOS_INIT_STACK(uint32_t *stack_limit, uint32_t *stack_end,
+                           void (*func)(void *args), void *args);
+void OCTOS_WAIT_FOR_INTERRUPT(void);
+
+bool posix_mask_interrupts(void);
+void posix_unmask_interrupts(void);
+void posix_yield(void);
+
+/**
+ * @brief Enter critical section by blocking the port signals
+ * @note Called through OCTOS_ENTER_CRITICAL, which passes the call site
+ * @param file Source file of the call site
+ * @param line Source line of the call site
+ * @return None
+ */
+OCTOS_INLINE static inline void OCTOS_ENTER_CRITICAL_AT(const char *file,
+                                                        uint32_t line) {
+#if OCTOS_CRITICAL_PROFILING
+    /* Resolved before masking, the nesting only reads zero when outermost */
+    CriticalSite_t *const site =
+            critical_nesting == 0 ? profile_critical_site(file, line) : NULL;
+#endif
+    posix_mask_interrupts();
+    critical_nesting++;
+#if OCTOS_CRITICAL_PROFILING
+    if (critical_nesting == 1) profile_critical_enter(site);
+#else
+    (void) file;
+    (void) line;
+#endif
+}
+
+/**
+ * @brief Exit critical section, unblocks the port signals at nesting 0
+ * @note A context switch requested inside the section happens here
+ * @return None
+ */
+OCTOS_INLINE static inline void OCTOS_EXIT_CRITICAL(void) {
+    OCTOS_ASSERT(critical_nesting > 0);
+#if OCTOS_CRITICAL_PROFILING
+    if (critical_nesting == 1) profile_critical_exit();
+#endif
+    critical_nesting--;
+    if (critical_nesting == 0) posix_unmask_interrupts();
+}
+
+#if OCTOS_CRITICAL_PROFILING
+#define OCTOS_ENTER_CRITICAL() OCTOS_ENTER_CRITICAL_AT(__FILE__, __LINE__)
+#else
+#define OCTOS_ENTER_CRITICAL() OCTOS_ENTER_CRITICAL_AT(NULL, 0)
+#endif
+
+/**
+ * @brief Block the port signals from ISR context
+ * @note Called through OCTOS_ENTER_CRITICAL_FROM_ISR with the call site
+ * @param file Source file of the call site
+ * @param line Source line of the call site
+ * @return Non-zero if the signals were already blocked
+ */
+OCTOS_INLINE static inline uint32_t
+OCTOS_ENTER_CRITICAL_FROM_ISR_AT(const char *file, uint32_t line) {
+#if OCTOS_CRITICAL_PROFILING
+    /* Resolved before masking, the signal mask is only known afterwards */
+    CriticalSite_t *const site = profile_critical_site(file, line);
+#endif
+    const uint32_t was_masked = posix_mask_interrupts();
+#if OCTOS_CRITICAL_PROFILING
+    if (was_masked == 0) profile_critical_enter(site);
+#else
+    (void) file;
+    (void) line;
+#endif
+    return was_masked;
+}
+
+/**
+ * @brief Restore the signal mask from ISR context
+ * @param new_mask_value Value returned by OCTOS_ENTER_CRITICAL_FROM_ISR
+ * @return None
+ */
+OCTOS_INLINE static inline void
+OCTOS_EXIT_CRITICAL_FROM_ISR(uint32_t new_mask_value) {
+#if OCTOS_CRITICAL_PROFILING
+    if (new_mask_value == 0) profile_critical_exit();
+#endif
+    if (new_mask_value == 0) posix_unmask_interrupts();
+}
+
+#if OCTOS_CRITICAL_PROFILING
+#define OCTOS_ENTER_CRITICAL_FROM_ISR()                                        \
+    OCTOS_ENTER_CRITICAL_FROM_ISR_AT(__FILE__, __LINE__)
+#else
+#define OCTOS_ENTER_CRITICAL_FROM_ISR()                                        \
+    OCTOS_ENTER_CRITICAL_FROM_ISR_AT(NULL, 0)
+#endif
+
+/**
+ * @brief Emulated exclusive load of a word
+ * @param addr Address of the word to load
+ * @return The loaded value
+ */
+OCTOS_INLINE static inline uint32_t OCTOS_LDREX(volatile uint32_t *addr) {
+    posix_exclusive_addr = addr;
+    return *addr;
+}
+
+/**
+ * @brief Emulated exclusive store of a word
+ * @param addr Address of the word to store
+ * @param value Value to store
+ * @retval true If the store succeeded
+ * @retval false If a signal or a context switch happened since OCTOS_LDREX
+ */
+OCTOS_INLINE static inline bool OCTOS_STREX(volatile uint32_t *addr,
+                                            uint32_t value) {
+    const bool was_masked = posix_mask_interrupts();
+    const bool success = (posix_exclusive_addr == addr);
+    if (success) *addr = value;
+    posix_exclusive_addr = NULL;
+    if (!was_masked) posix_unmask_interrupts();
+    return success;
+}
+
+/**
+ * @brief Emulated exclusive load of a pointer
+ * @param addr Address of the pointer to load
+ * @return The loaded pointer
+ */
+OCTOS_INLINE static inline void *OCTOS_LDREX_PTR(void *volatile *addr) {
+    posix_exclusive_addr = addr;
+    return *addr;
+}
+
+/**
+ * @brief Emulated exclusive store of a pointer
+ * @param addr Address of the pointer to store
+ * @param value Pointer to store
+ * @retval true If the store succeeded
+ * @retval false If a signal or a context switch happened since the load
+ */
+OCTOS_INLINE static inline bool OCTOS_STREX_PTR(void *volatile *addr,
+                                                void *value) {
+    const bool was_masked = posix_mask_interrupts();
+    const bool success = (posix_exclusive_addr == addr);
+    if (success) *addr = value;
+    posix_exclusive_addr = NULL;
+    if (!was_masked) posix_unmask_interrupts();
+    return success;
+}
+
+/**
+ * @brief Clear the emulated reservation after an abandoned OCTOS_LDREX
+ * @return None
+ */
+OCTOS_INLINE static inline void OCTOS_CLREX(void) {
+    posix_exclusive_addr = NULL;
+}
+
+/**
+ * @brief Request a context switch from the tick handler
+ * @return None
+ */
+OCTOS_INLINE static inline void OCTOS_CTX_SWITCH(void) { posix_yield(); }
+
+/**
+ * @brief No interrupt priorities on the host, every signal may call the API
+ * @return None
+ */
+OCTOS_INLINE static inline void
+OCTOS_ASSERT_IF_INTERRUPT_PRIORITY_INVALID(void) {}
+
+/**
+ * @brief Request a context switch
+ * @note Deferred while signals are masked or inside a signal handler,
+ *       as PendSV is on the target
+ * @return None
+ */
+OCTOS_INLINE static inline void OCTOS_YIELD(void) { posix_yield(); }
+
+/**
+ * @brief Request a context switch from a signal handler
+ * @param flag Boolean flag to indicate whether a yield should occur
+ * @return None
+ */
+OCTOS_INLINE static inline void OCTOS_YIELD_FROM_ISR(bool flag) {
+    if (flag) posix_yield();
+}
+
+#endif
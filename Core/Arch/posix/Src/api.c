@@ -0,0 +1,406 @@
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <time.h>
+#include <ucontext.h>
+
+#include "Arch/posix/Inc/api.h"
+#include "Kernel/Inc/utils.h"
+#include "clock.h"
+#include "task.h"
+
+#define posixMIN_STACK_SIZE (16U * 1024U)
+#define posixSTACK_ALIGNMENT ((uintptr_t) 16)
+#define posixHRTIMER_SIGNAL (SIGRTMIN)
+
+/**
+ * @brief Task context stored at the top of the task page
+ */
+typedef struct PosixFrame {
+    ucontext_t Context;       /*!< Saved context of the task */
+    void (*Func)(void *args); /*!< Task entry function */
+    void *Args;               /*!< Argument passed to the task entry */
+} PosixFrame_t;
+
+extern TCB_t *volatile current_tcb;
+
+volatile uint32_t critical_nesting = 0;
+volatile void *volatile posix_exclusive_addr = NULL;
+
+static sigset_t posix_interrupt_set;
+static struct itimerval posix_tick_interval;
+static timer_t posix_hrtimer;
+static volatile bool posix_scheduler_running = false;
+static volatile bool posix_in_interrupt = false;
+static volatile bool posix_switch_pending = false;
+
+/* Private Helpers -----------------------------------------------------------*/
+
+/**
+ * @brief Get the saved context of a task
+ * @param tcb Pointer to the TCB of the task
+ * @return Pointer to the context
+ */
+static ucontext_t *posix_context(TCB_t *tcb) {
+    return &(((PosixFrame_t *) tcb->StackTop)->Context);
+}
+
+/**
+ * @brief Switch to the highest priority ready task
+ * @note Must be called with the port signals blocked
+ * @return None
+ */
+static void posix_switch(void) {
+    posix_switch_pending = false;
+    posix_exclusive_addr = NULL;
+
+    TCB_t *const prev = current_tcb;
+    task_context_switch();
+    TCB_t *const next = current_tcb;
+
+    if (prev != next) swapcontext(posix_context(prev), posix_context(next));
+}
+
+/**
+ * @brief First function run on a task context
+ * @note makecontext() only passes int arguments, the frame pointer is split
+ *       into two halves
+ * @param high Upper half of the frame pointer
+ * @param low Lower half of the frame pointer
+ * @return None
+ */
+static void posix_task_entry(uint32_t high, uint32_t low) {
+    PosixFrame_t *const frame =
+            (PosixFrame_t *) (uintptr_t) (((uint64_t) high << 32) | low);
+
+    frame->Func(frame->Args);
+
+    /* Returning from a task faults on the target, end it cleanly here */
+    task_delete(task_get_current());
+    for (;;);
+}
+
+/**
+ * @brief Run an interrupt service routine from a signal handler
+ * @param isr Service routine, returns whether a context switch is required
+ * @return None
+ */
+static void posix_run_isr(bool (*isr)(void)) {
+    const int saved_errno = errno;
+
+    posix_in_interrupt = true;
+    posix_exclusive_addr = NULL;
+    if (isr()) posix_switch_pending = true;
+    posix_in_interrupt = false;
+
+    /* Leaves the handler frame on the interrupted task stack, it returns
+     * when the task is switched in again */
+    if (posix_switch_pending) posix_switch();
+
+    errno = saved_errno;
+}
+
+/**
+ * @brief SIGALRM handler, the SysTick of the port
+ * @param signo Signal number (unused)
+ * @return None
+ */
+static void posix_tick_handler(OCTOS_UNUSED int signo) {
+    posix_run_isr(&task_tick_increment);
+}
+
+#if OCTOS_HRTIMER
+/**
+ * @brief High-resolution timer signal handler, the TIM5 interrupt of the port
+ * @param signo Signal number (unused)
+ * @return None
+ */
+static void posix_hrtimer_handler(OCTOS_UNUSED int signo) {
+    posix_run_isr(&hrtimer_process_from_isr);
+}
+#endif
+
+/* Interrupt Masking ---------------------------------------------------------*/
+
+/**
+ * @brief Block the port signals
+ * @retval true If the signals were already blocked
+ * @retval false Otherwise
+ */
+bool posix_mask_interrupts(void) {
+    sigset_t previous;
+    sigprocmask(SIG_BLOCK, &posix_interrupt_set, &previous);
+    return sigismember(&previous, SIGALRM) == 1;
+}
+
+/**
+ * @brief Unblock the port signals and run a deferred context switch
+ * @note Signal handlers keep their mask, it is restored when they return
+ * @return None
+ */
+void posix_unmask_interrupts(void) {
+    if (posix_in_interrupt) return;
+
+    if (posix_switch_pending && posix_scheduler_running) posix_switch();
+    sigprocmask(SIG_UNBLOCK, &posix_interrupt_set, NULL);
+}
+
+/**
+ * @brief Request a context switch
+ * @note Switches immediately from task context, otherwise the switch is
+ *       deferred until the signals are unblocked or the handler ends
+ * @return None
+ */
+void posix_yield(void) {
+    if (!posix_scheduler_running || posix_in_interrupt ||
+        critical_nesting > 0) {
+        posix_switch_pending = true;
+        return;
+    }
+
+    sigset_t previous;
+    sigprocmask(SIG_BLOCK, &posix_interrupt_set, &previous);
+    posix_switch();
+    sigprocmask(SIG_SETMASK, &previous, NULL);
+}
+
+/* Port API ------------------------------------------------------------------*/
+
+/**
+ * @brief Launch the first task
+ * @note The signal mask of the task context unblocks the tick, the stack of
+ *       the caller is abandoned
+ * @return None
+ */
+void OCTOS_SCHED_LAUNCH(void) {
+    posix_scheduler_running = true;
+    posix_switch_pending = false;
+    setcontext(posix_context(current_tcb));
+
+    /* setcontext() only returns on failure */
+    OCTOS_ASSERT(0);
+}
+
+/**
+ * @brief Install the tick handler and block the port signals
+ * @note Equivalent of interrupts being disabled until the first task runs
+ * @return None
+ */
+void OCTOS_SETUP_INTPRI(void) {
+    struct sigaction action = {0};
+
+    sigemptyset(&posix_interrupt_set);
+    sigaddset(&posix_interrupt_set, SIGALRM);
+    sigaddset(&posix_interrupt_set, posixHRTIMER_SIGNAL);
+
+    action.sa_handler = &posix_tick_handler;
+    action.sa_mask = posix_interrupt_set;
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGALRM, &action, NULL);
+#if OCTOS_HRTIMER
+    action.sa_handler = &posix_hrtimer_handler;
+    sigaction(posixHRTIMER_SIGNAL, &action, NULL);
+#endif
+
+    sigprocmask(SIG_BLOCK, &posix_interrupt_set, NULL);
+}
+
+/**
+ * @brief Compute the tick interval from the time quantum
+ * @param quanta Pointer to Quanta structure containing timer configuration
+ * @return None
+ */
+void OCTOS_SETUP_SYSTICK(Quanta_t *quanta) {
+    const uint64_t interval_us =
+            ((uint64_t) quanta->Value * MICROSECONDS) / quanta->Unit;
+
+    posix_tick_interval.it_interval.tv_sec = interval_us / 1000000U;
+    posix_tick_interval.it_interval.tv_usec = interval_us % 1000000U;
+    posix_tick_interval.it_value = posix_tick_interval.it_interval;
+}
+
+/**
+ * @brief Start the tick timer
+ * @return None
+ */
+void OCTOS_ENABLE_SYSTICK(void) {
+    setitimer(ITIMER_REAL, &posix_tick_interval, NULL);
+}
+
+/**
+ * @brief Read the time elapsed within the current tick
+ * @note Must call within critical section. An expiry whose signal is still
+ *       blocked is reported
+ * @param tick_pending Set to true if a tick is pending
+ * @return Nanoseconds since the last tick timer expiry
+ */
+uint32_t OCTOS_SYSTICK_ELAPSED_NS(bool *tick_pending) {
+    struct itimerval remaining;
+    sigset_t pending;
+
+    sigpending(&pending);
+    const bool pending_before = sigismember(&pending, SIGALRM) == 1;
+    getitimer(ITIMER_REAL, &remaining);
+    sigpending(&pending);
+    *tick_pending = sigismember(&pending, SIGALRM) == 1;
+    /* The timer may have reloaded after the first read */
+    if (*tick_pending && !pending_before) getitimer(ITIMER_REAL, &remaining);
+
+    const struct timeval *const interval = &posix_tick_interval.it_interval;
+    const uint64_t interval_us =
+            (uint64_t) interval->tv_sec * 1000000U + interval->tv_usec;
+    const uint64_t remaining_us =
+            (uint64_t) remaining.it_value.tv_sec * 1000000U +
+            remaining.it_value.tv_usec;
+
+    if (remaining_us == 0 || remaining_us > interval_us) return 0;
+    return (uint32_t) ((interval_us - remaining_us) * 1000U);
+}
+
+/**
+ * @brief Create the high-resolution one-shot timer
+ * @note Expiry raises the high-resolution timer signal, installed with the
+ *       other port signals
+ * @return None
+ */
+void OCTOS_SETUP_HRTIMER(void) {
+    struct sigevent event = {0};
+
+    event.sigev_notify = SIGEV_SIGNAL;
+    event.sigev_signo = posixHRTIMER_SIGNAL;
+    timer_create(CLOCK_MONOTONIC, &event, &posix_hrtimer);
+}
+
+/**
+ * @brief Arm the high-resolution one-shot timer
+ * @param delay_us Delay before the signal in microseconds
+ * @return None
+ */
+void OCTOS_HRTIMER_ARM(uint32_t delay_us) {
+    struct itimerspec expiry = {0};
+
+    expiry.it_value.tv_sec = delay_us / 1000000U;
+    expiry.it_value.tv_nsec = (long) (delay_us % 1000000U) * 1000;
+    timer_settime(posix_hrtimer, 0, &expiry, NULL);
+}
+
+/**
+ * @brief Disarm the high-resolution one-shot timer
+ * @return None
+ */
+void OCTOS_HRTIMER_DISARM(void) {
+    struct itimerspec expiry = {0};
+    timer_settime(posix_hrtimer, 0, &expiry, NULL);
+}
+
+/**
+ * @brief Nothing to enable, the cycle counter is the monotonic clock
+ * @return None
+ */
+void OCTOS_SETUP_CYCLE_COUNTER(void) {}
+
+/**
+ * @brief Read the cycle counter
+ * @return CLOCK_MONOTONIC in nanoseconds, wrapping at 2^32
+ */
+uint32_t OCTOS_CYCLE_COUNTER(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t) ((uint64_t) now.tv_sec * 1000000000U + now.tv_nsec);
+}
+
+/**
+ * @brief Report a failed assertion and abort the process
+ * @param file Source file where assertion failed
+ * @param line Line number where assertion failed
+ * @return None
+ */
+void OCTOS_ASSERT_CALLED(const char *file, uint64_t line) {
+    posix_mask_interrupts();
+    fprintf(stderr, "OCTOS assertion failed at %s:%llu\n", file,
+            (unsigned long long) line);
+    abort();
+}
+
+/**
+ * @brief Allocate memory in a thread-safe manner
+ * @param wanted_size The size of the memory block to allocate
+ * @return Pointer to the allocated memory block, or NULL if allocation fails
+ */
+void *OCTOS_MALLOC(size_t wanted_size) {
+    void *result;
+
+    task_suspend_all();
+
+    result = malloc(wanted_size);
+
+    task_resume_all();
+
+    return result;
+}
+
+/**
+ * @brief Free memory in a thread-safe manner
+ * @param ptr_to_free Pointer to the memory block to free
+ * @return None
+ */
+void OCTOS_FREE(void *ptr_to_free) {
+    if (ptr_to_free) {
+        task_suspend_all();
+
+        free(ptr_to_free);
+
+        task_resume_all();
+    }
+}
+
+/**
+ * @brief Build the initial context of a task on its stack
+ * @note The context itself takes the top of the stack, host tasks need
+ *       pages of at least posixMIN_STACK_SIZE bytes for libc calls
+ * @param stack_limit Lowest usable word of the stack
+ * @param stack_end One past the highest word of the stack
+ * @param func Task entry function
+ * @param args Argument passed to the task entry function
+ * @return Pointer to the saved context, stored as the task stack top
+ */
+uint32_t *OCTOS_INIT_STACK(uint32_t *stack_limit, uint32_t *stack_end,
+                           void (*func)(void *args), void *args) {
+    const uintptr_t frame_addr =
+            ((uintptr_t) stack_end - sizeof(PosixFrame_t)) &
+            ~(posixSTACK_ALIGNMENT - 1);
+    PosixFrame_t *const frame = (PosixFrame_t *) frame_addr;
+
+    OCTOS_ASSERT(frame_addr > (uintptr_t) stack_limit);
+    OCTOS_ASSERT(frame_addr - (uintptr_t) stack_limit >= posixMIN_STACK_SIZE);
+
+    frame->Func = func;
+    frame->Args = args;
+
+    getcontext(&(frame->Context));
+    frame->Context.uc_stack.ss_sp = stack_limit;
+    frame->Context.uc_stack.ss_size = frame_addr - (uintptr_t) stack_limit;
+    frame->Context.uc_link = NULL;
+    sigemptyset(&(frame->Context.uc_sigmask));
+
+    const uint64_t frame_bits = (uint64_t) frame_addr;
+    makecontext(&(frame->Context), (void (*)(void)) & posix_task_entry, 2,
+                (uint32_t) (frame_bits >> 32), (uint32_t) frame_bits);
+
+    return (uint32_t *) frame;
+}
+
+/**
+ * @brief Sleep until the next signal, for idle tasks
+ * @return None
+ */
+void OCTOS_WAIT_FOR_INTERRUPT(void) {
+    sigset_t unblocked;
+    sigemptyset(&unblocked);
+    sigsuspend(&unblocked);
+}
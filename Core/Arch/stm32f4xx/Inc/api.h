@@ -6,6 +6,7 @@
 #include <stdint.h>
 
 #include "Kernel/Inc/config.h"
+#include "Kernel/Inc/profile.h"
 #include "Kernel/Inc/utils.h"
 #include "attr.h"
 
@@ -22,18 +23,43 @@ OCTOS_NAKED void OCTOS_SCHED_LAUNCH(void);
 void OCTOS_SETUP_INTPRI(void);
 void OCTOS_SETUP_SYSTICK(Quanta_t *quanta);
 void OCTOS_ENABLE_SYSTICK(void);
+void OCTOS_SETUP_CYCLE_COUNTER(void);
+uint32_t OCTOS_SYSTICK_ELAPSED_NS(bool *tick_pending);
+void OCTOS_SETUP_HRTIMER(void);
+void OCTOS_HRTIMER_ARM(uint32_t delay_us);
+void OCTOS_HRTIMER_DISARM(void);
 void OCTOS_ASSERT_CALLED(const char *file, uint64_t line);
 void *OCTOS_MALLOC(size_t wanted_size);
 void OCTOS_FREE(void *ptr_to_free);
+uint32_t *OCTOS_INIT_STACK(uint32_t *stack_limit, uint32_t *stack_end,
+                           void (*func)(void *args), void *args);
+
+/**
+ * @brief Read the free-running CPU cycle counter
+ * @note Requires OCTOS_SETUP_CYCLE_COUNTER to be called once
+ * @return The DWT cycle count
+ */
+OCTOS_INLINE static inline uint32_t OCTOS_CYCLE_COUNTER(void) {
+    return DWT->CYCCNT;
+}
 
 /**
  * @brief Enter critical section by setting BASEPRI register to mask interrupts
  * @note Uses BASEPRI register to disable interrupts with priority less than or equal to 
  *       OCTOS_MAX_SYSCALL_INTERRUPT_PRIORITY
  * @note Priority levels are mapped to bits [7:4] according to Cortex-M4 architecture
+ * @note Called through OCTOS_ENTER_CRITICAL, which passes the call site
+ * @param file Source file of the call site
+ * @param line Source line of the call site
  * @return None
  */
-OCTOS_INLINE static inline void OCTOS_ENTER_CRITICAL(void) {
+OCTOS_INLINE static inline void OCTOS_ENTER_CRITICAL_AT(const char *file,
+                                                        uint32_t line) {
+#if OCTOS_CRITICAL_PROFILING
+    /* Resolved before masking, the nesting only reads zero when outermost */
+    CriticalSite_t *const site =
+            critical_nesting == 0 ? profile_critical_site(file, line) : NULL;
+#endif
     // according to
     // * Cortex-M4 Devices Generic User Guide (Page 2-9), bits [31:8] are reserved
     // * RM0090 Rev 21 (Page 374), 4 bits of interrupt priority (16 levels) are used
@@ -43,6 +69,12 @@ OCTOS_INLINE static inline void OCTOS_ENTER_CRITICAL(void) {
     __DSB();
     __ISB();
     critical_nesting++;
+#if OCTOS_CRITICAL_PROFILING
+    if (critical_nesting == 1) profile_critical_enter(site);
+#else
+    (void) file;
+    (void) line;
+#endif
 }
 
 /**
@@ -52,19 +84,38 @@ OCTOS_INLINE static inline void OCTOS_ENTER_CRITICAL(void) {
  */
 OCTOS_INLINE static inline void OCTOS_EXIT_CRITICAL(void) {
     OCTOS_ASSERT(critical_nesting > 0);
+#if OCTOS_CRITICAL_PROFILING
+    if (critical_nesting == 1) profile_critical_exit();
+#endif
     critical_nesting--;
     if (critical_nesting == 0) { __set_BASEPRI(0); }
 }
 
+#if OCTOS_CRITICAL_PROFILING
+#define OCTOS_ENTER_CRITICAL() OCTOS_ENTER_CRITICAL_AT(__FILE__, __LINE__)
+#else
+#define OCTOS_ENTER_CRITICAL() OCTOS_ENTER_CRITICAL_AT(NULL, 0)
+#endif
+
 /**
  * @brief Set interrupt mask from ISR context by configuring BASEPRI register
  * @note Uses BASEPRI register to disable interrupts with priority less than or equal to
  *       OCTOS_MAX_SYSCALL_INTERRUPT_PRIORITY
  * @note Priority levels are mapped to bits [7:4] according to Cortex-M4 architecture  
+ * @note Called through OCTOS_ENTER_CRITICAL_FROM_ISR with the call site
+ * @param file Source file of the call site
+ * @param line Source line of the call site
  * @return Original BASEPRI value before masking
  */
-OCTOS_INLINE static inline uint32_t OCTOS_ENTER_CRITICAL_FROM_ISR(void) {
+OCTOS_INLINE static inline uint32_t
+OCTOS_ENTER_CRITICAL_FROM_ISR_AT(const char *file, uint32_t line) {
     uint32_t original_base_priority = __get_BASEPRI();
+#if OCTOS_CRITICAL_PROFILING
+    /* Resolved before masking, only when interrupts were not masked yet */
+    CriticalSite_t *const site = original_base_priority == 0
+                                         ? profile_critical_site(file, line)
+                                         : NULL;
+#endif
     // according to
     // * Cortex-M4 Devices Generic User Guide (Page 2-9), bits [31:8] are reserved
     // * RM0090 Rev 21 (Page 374), 4 bits of interrupt priority (16 levels) are used
@@ -73,6 +124,12 @@ OCTOS_INLINE static inline uint32_t OCTOS_ENTER_CRITICAL_FROM_ISR(void) {
                   << (8 - __NVIC_PRIO_BITS));
     __DSB();
     __ISB();
+#if OCTOS_CRITICAL_PROFILING
+    if (original_base_priority == 0) profile_critical_enter(site);
+#else
+    (void) file;
+    (void) line;
+#endif
     return original_base_priority;
 }
 
@@ -83,9 +140,71 @@ OCTOS_INLINE static inline uint32_t OCTOS_ENTER_CRITICAL_FROM_ISR(void) {
  */
 OCTOS_INLINE static inline void
 OCTOS_EXIT_CRITICAL_FROM_ISR(uint32_t new_mask_value) {
+#if OCTOS_CRITICAL_PROFILING
+    if (new_mask_value == 0) profile_critical_exit();
+#endif
     __set_BASEPRI(new_mask_value);
 }
 
+#if OCTOS_CRITICAL_PROFILING
+#define OCTOS_ENTER_CRITICAL_FROM_ISR()                                        \
+    OCTOS_ENTER_CRITICAL_FROM_ISR_AT(__FILE__, __LINE__)
+#else
+#define OCTOS_ENTER_CRITICAL_FROM_ISR()                                        \
+    OCTOS_ENTER_CRITICAL_FROM_ISR_AT(NULL, 0)
+#endif
+
+/**
+ * @brief Exclusive load of a word
+ * @note Pairs with OCTOS_STREX. The exclusive monitor is cleared on exception
+ *       entry and return, so a pair interrupted by an ISR or a context switch
+ *       always fails the store
+ * @param addr Address of the word to load
+ * @return The loaded value
+ */
+OCTOS_INLINE static inline uint32_t OCTOS_LDREX(volatile uint32_t *addr) {
+    return __LDREXW(addr);
+}
+
+/**
+ * @brief Exclusive store of a word
+ * @param addr Address of the word to store
+ * @param value Value to store
+ * @retval true If the store succeeded
+ * @retval false If exclusivity was lost since the matching OCTOS_LDREX
+ */
+OCTOS_INLINE static inline bool OCTOS_STREX(volatile uint32_t *addr,
+                                            uint32_t value) {
+    return __STREXW(value, addr) == 0;
+}
+
+/**
+ * @brief Exclusive load of a pointer
+ * @param addr Address of the pointer to load
+ * @return The loaded pointer
+ */
+OCTOS_INLINE static inline void *OCTOS_LDREX_PTR(void *volatile *addr) {
+    return (void *) __LDREXW((volatile uint32_t *) addr);
+}
+
+/**
+ * @brief Exclusive store of a pointer
+ * @param addr Address of the pointer to store
+ * @param value Pointer to store
+ * @retval true If the store succeeded
+ * @retval false If exclusivity was lost since the matching OCTOS_LDREX_PTR
+ */
+OCTOS_INLINE static inline bool OCTOS_STREX_PTR(void *volatile *addr,
+                                                void *value) {
+    return __STREXW((uint32_t) value, (volatile uint32_t *) addr) == 0;
+}
+
+/**
+ * @brief Clear the exclusive monitor after an abandoned OCTOS_LDREX
+ * @return None
+ */
+OCTOS_INLINE static inline void OCTOS_CLREX(void) { __CLREX(); }
+
 /**
  * @brief Trigger PendSV exception to perform context switch
  * @note Sets PENDSVSET bit in ICSR register to trigger PendSV exception
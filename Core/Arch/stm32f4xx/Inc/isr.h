@@ -48,6 +48,7 @@ extern "C" {
 /* Exported functions prototypes ---------------------------------------------*/
 OCTOS_NAKED void PendSV_Handler(void);
 void SysTick_Handler(void);
+void TIM5_IRQHandler(void);
 /* USER CODE BEGIN EFP */
 
 /* USER CODE END EFP */
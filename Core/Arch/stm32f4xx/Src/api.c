@@ -77,6 +77,91 @@ void OCTOS_SETUP_SYSTICK(Quanta_t *quanta) {
  */
 void OCTOS_ENABLE_SYSTICK(void) { SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk; }
 
+/**
+ * @brief Enables the DWT cycle counter
+ * @note The counter runs at the core clock and wraps every 2^32 cycles
+ * @return None
+ */
+void OCTOS_SETUP_CYCLE_COUNTER(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief Read the time elapsed within the current tick
+ * @note Must call within critical section. SysTick counts down from LOAD,
+ *       a reload not yet handled by SysTick_Handler is reported
+ * @param tick_pending Set to true if a tick is pending
+ * @return Nanoseconds since the last SysTick reload
+ */
+uint32_t OCTOS_SYSTICK_ELAPSED_NS(bool *tick_pending) {
+    uint32_t value = SysTick->VAL;
+
+    *tick_pending = (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0;
+    /* The counter may have reloaded after the first read */
+    if (*tick_pending) value = SysTick->VAL;
+
+    const uint64_t counts = SysTick->LOAD - value;
+    return (uint32_t) ((counts * 1000000000U) / SystemCoreClock);
+}
+
+/**
+ * @brief Configures TIM5 as the high-resolution one-shot timer
+ * @note TIM5 free runs at 1 MHz over its 32-bit range, the one-shot is a
+ *       compare match on channel 1
+ * @return None
+ */
+void OCTOS_SETUP_HRTIMER(void) {
+    const uint32_t ppre1 = (RCC->CFGR & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos;
+    uint32_t timer_clock = SystemCoreClock >> APBPrescTable[ppre1];
+    /* APB1 timers run at twice the bus clock when the bus is divided */
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) timer_clock *= 2;
+
+    RCC->APB1ENR |= RCC_APB1ENR_TIM5EN;
+    (void) RCC->APB1ENR;
+
+    TIM5->CR1 = 0;
+    TIM5->DIER = 0;
+    TIM5->PSC = (timer_clock / MICROSECONDS) - 1;
+    TIM5->ARR = UINT32_MAX;
+    /* Load the prescaler */
+    TIM5->EGR = TIM_EGR_UG;
+    TIM5->SR = 0;
+
+    NVIC_SetPriority(TIM5_IRQn, OCTOS_MAX_SYSCALL_INTERRUPT_PRIORITY);
+    NVIC_EnableIRQ(TIM5_IRQn);
+
+    TIM5->CR1 = TIM_CR1_CEN;
+}
+
+/**
+ * @brief Arm the one-shot compare of TIM5
+ * @note Must call within critical section
+ * @param delay_us Delay before the interrupt in microseconds
+ * @return None
+ */
+void OCTOS_HRTIMER_ARM(uint32_t delay_us) {
+    const uint32_t compare = TIM5->CNT + delay_us;
+
+    TIM5->CCR1 = compare;
+    TIM5->SR = ~TIM_SR_CC1IF;
+    TIM5->DIER |= TIM_DIER_CC1IE;
+
+    /* A higher priority interrupt may have delayed the write past the
+     * compare value, the match would then only happen after a wrap */
+    if ((int32_t) (compare - TIM5->CNT) <= 0) TIM5->EGR = TIM_EGR_CC1G;
+}
+
+/**
+ * @brief Disarm the one-shot compare of TIM5
+ * @return None
+ */
+void OCTOS_HRTIMER_DISARM(void) {
+    TIM5->DIER &= ~TIM_DIER_CC1IE;
+    TIM5->SR = ~TIM_SR_CC1IF;
+}
+
 /**
  * @brief Handles assertion failure by entering a critical section and halting execution
  * @param file Source file where assertion failed
@@ -91,6 +176,31 @@ void OCTOS_ASSERT_CALLED(OCTOS_UNUSED const char *file,
     for (;;);
 }
 
+/**
+ * @brief Build the initial context of a task on its stack
+ * @note Lays out the exception frame popped by OCTOS_SCHED_LAUNCH and the
+ *       R4-R11 block popped by PendSV_Handler
+ * @param stack_limit Lowest usable word of the stack (unused)
+ * @param stack_end One past the highest word of the stack
+ * @param func Task entry function
+ * @param args Argument passed to the task entry function
+ * @return The initial stack pointer of the task
+ */
+uint32_t *OCTOS_INIT_STACK(OCTOS_UNUSED uint32_t *stack_limit,
+                           uint32_t *stack_end, void (*func)(void *args),
+                           void *args) {
+    uint32_t *stack_top = stack_end - 16;
+    stack_top[15] = (uint32_t) (1U << 24);// PSR
+    stack_top[14] = (uint32_t) func;      // PC
+    stack_top[13] = 0;                    // LR
+    stack_top[12] = 0;                    // R12
+    stack_top[11] = 0;                    // R3
+    stack_top[10] = 0;                    // R2
+    stack_top[9] = 0;                     // R1
+    stack_top[8] = (uint32_t) args;       // R0
+    return stack_top;
+}
+
 /**
  * @brief Allocate memory in a thread-safe manner
  * @note This function suspends all tasks before allocating memory to ensure thread safety
@@ -23,6 +23,8 @@
 /* USER CODE BEGIN Includes */
 #include "Arch/stm32f4xx/Inc/api.h"
 #include "attr.h"
+#include "clock.h"
+#include "config.h"
 #include "stm32f4xx.h"// IWYU pragma: keep
 #include "task.h"
 /* USER CODE END Includes */
@@ -110,3 +112,14 @@ OCTOS_NAKED void PendSV_Handler(void) {
 void SysTick_Handler(void) {
     if (task_tick_increment()) OCTOS_CTX_SWITCH();
 }
+
+#if OCTOS_HRTIMER
+/**
+ * @brief This function handles TIM5 global interrupt.
+ */
+void TIM5_IRQHandler(void) {
+    if ((TIM5->SR & TIM_SR_CC1IF) == 0) return;
+    TIM5->SR = ~TIM_SR_CC1IF;
+    OCTOS_YIELD_FROM_ISR(hrtimer_process_from_isr());
+}
+#endif
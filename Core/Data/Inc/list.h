@@ -6,8 +6,56 @@
 #include <stdint.h>
 #include <string.h>
 
-#include "Arch/stm32f4xx/Inc/api.h"
+#include "Arch/port.h"
 #include "attr.h"
+#include "config.h"
+
+#if OCTOS_COMPACT_LIST
+
+/**
+ * @brief Compact list link, a signed offset in words from an anchor
+ * @note Links are relative so a zero-initialized list is already linked to
+ *       its own end marker. A list and the objects linked into it must be
+ *       within LIST_LINK_REACH of each other, list_link asserts it. Keep
+ *       lists and task pages in .data, .bss or the heap, not on the MSP
+ *       stack. On the STM32F429 the linker script checks that these fit in
+ *       the first LIST_LINK_REACH of RAM and _sbrk caps the heap there. CCM
+ *       RAM is out of reach, OCTOS_TASK_DEFINE_CCMRAM does not build
+ */
+typedef int16_t ListLink_t;
+
+/**
+ * @brief Largest distance in bytes a compact link spans
+ */
+#define LIST_LINK_REACH ((uintptr_t) INT16_MAX * 4)
+
+/**
+ * @brief List item structure definition
+ */
+typedef struct ListItem {
+    uint32_t Value;    /*!< Value used for sorting */
+    ListLink_t Next;   /*!< Link to next item in list */
+    ListLink_t Prev;   /*!< Link to previous item in list */
+    ListLink_t Parent; /*!< Link to the list containing this item, 0 if none */
+} ListItem_t;
+
+/**
+ * @brief List structure definition
+ */
+typedef struct List {
+    uint16_t Length;    /*!< Number of items in the list */
+    ListLink_t Current; /*!< Used to walk through the list, from End */
+    ListItem_t End;     /*!< End marker of the list */
+} List_t;
+
+/**
+ * @brief Constant initializer of an empty list
+ * @note Equivalent to list_init, for lists with static storage duration
+ * @param list: The list being defined
+ */
+#define LIST_INITIALIZER(list) {.End = {.Value = UINT32_MAX}}
+
+#else
 
 /**
  * @brief List item structure definition
@@ -16,7 +64,6 @@ typedef struct ListItem {
     uint32_t Value;        /*!< Value used for sorting */
     struct ListItem *Next; /*!< Pointer to next item in list */
     struct ListItem *Prev; /*!< Pointer to previous item in list */
-    void *Owner;           /*!< Pointer to the owner of this item */
     struct List *Parent;   /*!< Pointer to the list containing this item */
 } ListItem_t;
 
@@ -29,6 +76,172 @@ typedef struct List {
     ListItem_t End;      /*!< End marker of the list */
 } List_t;
 
+/**
+ * @brief Constant initializer of an empty list
+ * @note Equivalent to list_init, for lists with static storage duration
+ * @param list: The list being defined
+ */
+#define LIST_INITIALIZER(list)                                                 \
+    {                                                                          \
+        .Length = 0, .Current = &((list).End),                                 \
+        .End = {.Value = UINT32_MAX,                                           \
+                .Next = &((list).End),                                         \
+                .Prev = &((list).End)},                                        \
+    }
+
+#endif
+
+/**
+ * @brief Get the structure embedding a list item
+ * @param item: Pointer to the list item
+ * @param type: Type of the owner structure
+ * @param member: Name of the list item member within the owner
+ */
+#define LIST_ITEM_OWNER(item, type, member)                                    \
+    ((type *) ((uint8_t *) (item) - offsetof(type, member)))
+
+/* Link ----------------------------------------------------------------------*/
+
+#if OCTOS_COMPACT_LIST
+
+/**
+ * @brief Encode a link from an anchor to a target
+ * @param anchor: Address the link is relative to
+ * @param target: Address linked to
+ * @return Offset in words from anchor to target
+ */
+OCTOS_INLINE static inline ListLink_t list_link(const void *anchor,
+                                                const void *target) {
+    const intptr_t offset = ((intptr_t) target - (intptr_t) anchor) / 4;
+    OCTOS_ASSERT(offset >= INT16_MIN && offset <= INT16_MAX);
+    return (ListLink_t) offset;
+}
+
+/**
+ * @brief Decode a link relative to an anchor
+ * @param anchor: Address the link is relative to
+ * @param link: Offset in words from anchor
+ * @return Address linked to
+ */
+OCTOS_INLINE static inline void *list_follow(const void *anchor,
+                                             ListLink_t link) {
+    return (uint8_t *) anchor + (intptr_t) link * 4;
+}
+
+#endif
+
+/**
+ * @brief Gets the next item of a list item
+ * @param item: Pointer to the ListItem_t structure
+ * @return Pointer to the next item, the end marker after the last item
+ */
+OCTOS_INLINE static inline ListItem_t *list_item_next(const ListItem_t *item) {
+#if OCTOS_COMPACT_LIST
+    return list_follow(item, item->Next);
+#else
+    return item->Next;
+#endif
+}
+
+/**
+ * @brief Gets the previous item of a list item
+ * @param item: Pointer to the ListItem_t structure
+ * @return Pointer to the previous item, the end marker before the first item
+ */
+OCTOS_INLINE static inline ListItem_t *list_item_prev(const ListItem_t *item) {
+#if OCTOS_COMPACT_LIST
+    return list_follow(item, item->Prev);
+#else
+    return item->Prev;
+#endif
+}
+
+/**
+ * @brief Gets the list containing a list item
+ * @param item: Pointer to the ListItem_t structure
+ * @return Pointer to the parent list, or NULL if the item is in no list
+ */
+OCTOS_INLINE static inline List_t *list_item_parent(const ListItem_t *item) {
+#if OCTOS_COMPACT_LIST
+    return item->Parent == 0 ? NULL : list_follow(item, item->Parent);
+#else
+    return item->Parent;
+#endif
+}
+
+/**
+ * @brief Gets the item a list walk is at
+ * @param list: Pointer to the List_t structure
+ * @return Pointer to the current item, or the end marker
+ */
+OCTOS_INLINE static inline ListItem_t *list_current(const List_t *list) {
+#if OCTOS_COMPACT_LIST
+    return list_follow(&(list->End), list->Current);
+#else
+    return list->Current;
+#endif
+}
+
+/**
+ * @brief Links a list item to its next item
+ * @param item: Pointer to the ListItem_t structure
+ * @param next: Pointer to the next item
+ * @return None
+ */
+OCTOS_INLINE static inline void list_item_set_next(ListItem_t *item,
+                                                   ListItem_t *next) {
+#if OCTOS_COMPACT_LIST
+    item->Next = list_link(item, next);
+#else
+    item->Next = next;
+#endif
+}
+
+/**
+ * @brief Links a list item to its previous item
+ * @param item: Pointer to the ListItem_t structure
+ * @param prev: Pointer to the previous item
+ * @return None
+ */
+OCTOS_INLINE static inline void list_item_set_prev(ListItem_t *item,
+                                                   ListItem_t *prev) {
+#if OCTOS_COMPACT_LIST
+    item->Prev = list_link(item, prev);
+#else
+    item->Prev = prev;
+#endif
+}
+
+/**
+ * @brief Sets the list containing a list item
+ * @param item: Pointer to the ListItem_t structure
+ * @param parent: Pointer to the parent list, or NULL
+ * @return None
+ */
+OCTOS_INLINE static inline void list_item_set_parent(ListItem_t *item,
+                                                     List_t *parent) {
+#if OCTOS_COMPACT_LIST
+    item->Parent = parent == NULL ? 0 : list_link(item, parent);
+#else
+    item->Parent = parent;
+#endif
+}
+
+/**
+ * @brief Sets the item a list walk is at
+ * @param list: Pointer to the List_t structure
+ * @param current: Pointer to the current item, or the end marker
+ * @return None
+ */
+OCTOS_INLINE static inline void list_set_current(List_t *list,
+                                                 ListItem_t *current) {
+#if OCTOS_COMPACT_LIST
+    list->Current = list_link(&(list->End), current);
+#else
+    list->Current = current;
+#endif
+}
+
 /* ListItem ------------------------------------------------------------------*/
 
 /**
@@ -37,7 +250,7 @@ typedef struct List {
  * @return None
  */
 OCTOS_INLINE static inline void list_item_init(ListItem_t *item) {
-    item->Parent = NULL;
+    list_item_set_parent(item, NULL);
     item->Value = 0;
 }
 
@@ -68,12 +281,13 @@ OCTOS_INLINE static inline uint32_t list_item_get_value(ListItem_t *item) {
  * @param list: Pointer to the List_t structure to initialize
  * @return None
  */
-OCTOS_INLINE inline void list_init(List_t *list) {
+OCTOS_INLINE static inline void list_init(List_t *list) {
     list->End.Value = UINT32_MAX;
 
-    list->End.Next = &(list->End);
-    list->End.Prev = &(list->End);
+    list_item_set_next(&(list->End), &(list->End));
+    list_item_set_prev(&(list->End), &(list->End));
 
+    list_set_current(list, &(list->End));
     list->Length = 0;
 }
 
@@ -99,20 +313,23 @@ OCTOS_INLINE static inline bool list_insert(List_t *list,
     OCTOS_DSB();
     OCTOS_ISB();
 
-    if (new_item->Parent != NULL) return false;
+    if (list_item_parent(new_item) != NULL) return false;
 
-    ListItem_t *iterator;
+    ListItem_t *iterator = &(list->End);
+    ListItem_t *next = list_item_next(iterator);
 
-    for (iterator = &(list->End); iterator->Next->Value < new_item->Value;
-         iterator = iterator->Next);
+    while (next->Value < new_item->Value) {
+        iterator = next;
+        next = list_item_next(iterator);
+    }
 
-    new_item->Next = iterator->Next;
-    new_item->Prev = iterator;
-    iterator->Next->Prev = new_item;
-    iterator->Next = new_item;
+    list_item_set_next(new_item, next);
+    list_item_set_prev(new_item, iterator);
+    list_item_set_prev(next, new_item);
+    list_item_set_next(iterator, new_item);
 
-    new_item->Parent = list;
-    if (list->Length == 0) list->Current = new_item;
+    list_item_set_parent(new_item, list);
+    if (list->Length == 0) list_set_current(list, new_item);
     list->Length++;
 
     return true;
@@ -131,17 +348,48 @@ OCTOS_INLINE static inline bool list_insert_end(List_t *list,
     OCTOS_DSB();
     OCTOS_ISB();
 
-    if (new_item->Parent != NULL) return false;
+    if (list_item_parent(new_item) != NULL) return false;
+
+    ListItem_t *last = list_item_prev(&(list->End));
+
+    list_item_set_next(new_item, &(list->End));
+    list_item_set_prev(new_item, last);
+    list_item_set_next(last, new_item);
+    list_item_set_prev(&(list->End), new_item);
+
+    list_item_set_parent(new_item, list);
+    if (list->Length == 0) list_set_current(list, new_item);
+    list->Length++;
+
+    return true;
+}
+
+/** 
+ * @brief Insert an item after a given position of a list
+ * @note Lets callers keep a list ordered by a key other than the item value
+ * @param list: Pointer to the list where the item will be inserted
+ * @param position: Item of the list, or its end marker to insert at the head
+ * @param new_item: Pointer to the item to be inserted
+ * @retval true If the insertion is successful 
+ * @retval false Otherwise
+ */
+OCTOS_INLINE static inline bool list_insert_after(List_t *list,
+                                                  ListItem_t *position,
+                                                  ListItem_t *new_item) {
+    OCTOS_DSB();
+    OCTOS_ISB();
+
+    if (list_item_parent(new_item) != NULL) return false;
 
-    ListItem_t *last = list->End.Prev;
+    ListItem_t *const next = list_item_next(position);
 
-    new_item->Next = &(list->End);
-    new_item->Prev = last;
-    last->Next = new_item;
-    list->End.Prev = new_item;
+    list_item_set_next(new_item, next);
+    list_item_set_prev(new_item, position);
+    list_item_set_prev(next, new_item);
+    list_item_set_next(position, new_item);
 
-    new_item->Parent = list;
-    if (list->Length == 0) list->Current = new_item;
+    list_item_set_parent(new_item, list);
+    if (list->Length == 0) list_set_current(list, new_item);
     list->Length++;
 
     return true;
@@ -149,8 +397,9 @@ OCTOS_INLINE static inline bool list_insert_end(List_t *list,
 
 /** 
  * @brief Remove an item from a list
- * @note This function removes the specified item from its parent list
- *       and updates the list's current pointer
+ * @note This function removes the specified item from its parent list.
+ *       The current pointer only steps back when it points at the removed
+ *       item, so the next walk resumes with the item that followed it
  * @param item_to_remove: Pointer to the list item to be removed
  * @retval true If the item was successfully removed
  * @retval false If the item has no parent list
@@ -159,18 +408,19 @@ OCTOS_INLINE static inline bool list_remove(ListItem_t *item_to_remove) {
     OCTOS_DSB();
     OCTOS_ISB();
 
-    if (item_to_remove->Parent == NULL) return false;
+    List_t *list = list_item_parent(item_to_remove);
+
+    if (list == NULL) return false;
 
-    List_t *list = item_to_remove->Parent;
+    ListItem_t *const prev = list_item_prev(item_to_remove);
+    ListItem_t *const next = list_item_next(item_to_remove);
 
-    list->Current = list->Current->Next == &(list->End)
-                            ? list->Current->Next->Next
-                            : list->Current->Next;
+    if (list_current(list) == item_to_remove) list_set_current(list, prev);
 
-    item_to_remove->Prev->Next = item_to_remove->Next;
-    item_to_remove->Next->Prev = item_to_remove->Prev;
+    list_item_set_next(prev, next);
+    list_item_set_prev(next, prev);
 
-    item_to_remove->Parent = NULL;
+    list_item_set_parent(item_to_remove, NULL);
     list->Length--;
     return true;
 }
@@ -183,7 +433,7 @@ OCTOS_INLINE static inline bool list_remove(ListItem_t *item_to_remove) {
  */
 OCTOS_INLINE static inline ListItem_t *list_head(List_t *list) {
     if (list->Length == 0) return NULL;
-    return list->End.Next;
+    return list_item_next(&(list->End));
 }
 
 /**
@@ -194,21 +444,21 @@ OCTOS_INLINE static inline ListItem_t *list_head(List_t *list) {
   */
 OCTOS_INLINE static inline ListItem_t *list_tail(List_t *list) {
     if (list->Length == 0) return NULL;
-    return list->End.Prev;
+    return list_item_prev(&(list->End));
 }
 
 /** 
- * @brief Get the owner of the next entry in the list
+ * @brief Get the next entry in the list
  * @note This function advances the list's current pointer to the next
- *       entry and returns the owner of that entry
- * @param list: Pointer to the list
- * @return Pointer to the owner of the next entry in the list
- */
-OCTOS_INLINE static inline void *list_get_owner_of_next_entry(List_t *list) {
-    list->Current = list->Current->Next == &(list->End)
-                            ? list->Current->Next->Next
-                            : list->Current->Next;
-    return list->Current->Owner;
+ *       entry, skipping the end marker, and returns that entry
+ * @param list: Pointer to the list, must not be empty
+ * @return Pointer to the next entry in the list
+ */
+OCTOS_INLINE static inline ListItem_t *list_get_next_entry(List_t *list) {
+    ListItem_t *next = list_item_next(list_current(list));
+    if (next == &(list->End)) next = list_item_next(next);
+    list_set_current(list, next);
+    return next;
 }
 
 #endif
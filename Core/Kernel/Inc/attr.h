@@ -8,5 +8,12 @@
 #define OCTOS_USED __attribute__((used))
 #define OCTOS_UNUSED __attribute__((unused))
 #define OCTOS_PACKED __attribute__((packed))
+#define OCTOS_WEAK __attribute__((weak))
+#define OCTOS_ALIGNED(n) __attribute__((aligned(n)))
+#define OCTOS_SECTION(name) __attribute__((section(name)))
+#define OCTOS_FALLTHROUGH __attribute__((fallthrough))
+
+/* Uninitialized CCM RAM, not copied from flash nor zeroed at startup */
+#define OCTOS_CCMRAM OCTOS_SECTION(".ccmbss")
 
 #endif
@@ -0,0 +1,50 @@
+#ifndef __CLOCK_H__
+#define __CLOCK_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "utils.h"
+
+/**
+ * @brief High-resolution timer function type
+ * @note Runs from the timer interrupt
+ * @param args Pointer to the timer's arguments
+ * @param switch_required Set to true if a context switch is required
+ */
+typedef void (*HrTimerFunc_t)(void *args, bool *const switch_required);
+
+/**
+ * @brief High-resolution one-shot timer structure definition
+ * @note A timer is owned by the caller and must stay valid while it is armed.
+ *       Armed timers share the hardware one-shot timer of the port
+ */
+typedef struct HrTimer {
+    struct HrTimer *Next; /*!< Next armed timer, sorted by deadline */
+    uint64_t Deadline;    /*!< Expiry time in nanoseconds */
+    HrTimerFunc_t Func;   /*!< Function run on expiry */
+    void *Args;           /*!< Arguments passed to the function */
+    volatile bool Armed;  /*!< Whether the timer is waiting for expiry */
+} HrTimer_t;
+
+/* Clock ---------------------------------------------------------------------*/
+uint64_t clock_now_ns(void);
+uint64_t clock_now_ns_from_isr(void);
+uint64_t clock_now_us(void);
+uint64_t clock_tick_to_ns(Tick_t tick);
+/* High-Resolution Timer -----------------------------------------------------*/
+#if OCTOS_HRTIMER
+void hrtimer_init(HrTimer_t *timer, HrTimerFunc_t func, void *args);
+bool hrtimer_is_armed(HrTimer_t *timer);
+void hrtimer_start(HrTimer_t *timer, uint32_t delay_us);
+void hrtimer_start_from_isr(HrTimer_t *timer, uint32_t delay_us);
+bool hrtimer_cancel(HrTimer_t *timer);
+bool hrtimer_cancel_from_isr(HrTimer_t *timer);
+void hrtimer_notify_task(void *task, bool *const switch_required);
+bool hrtimer_process_from_isr(void);
+void clock_delay_us(uint32_t delay_us);
+bool clock_delay_until_us(uint64_t *previous_wake_us, uint32_t period_us);
+#endif
+
+#endif
@@ -3,5 +3,14 @@
 
 #define OCTOS_MAX_SYSCALL_INTERRUPT_PRIORITY 5
 #define OCTOS_MAX_PRIORITIES 5
+#define OCTOS_MUTEX_CHAIN_DEPTH 8
+#define OCTOS_FUTEX_BUCKETS 8
+#define OCTOS_TASK_NOTIFY_SLOTS 2
+#define OCTOS_CRITICAL_PROFILING 0
+#define OCTOS_CRITICAL_PROFILING_SITES 32
+#define OCTOS_CRITICAL_PROFILING_BUCKETS 8
+#define OCTOS_HRTIMER 1
+#define OCTOS_COMPACT_LIST 0
+#define OCTOS_MQUEUE_BUCKETED_WAIT 1
 
 #endif
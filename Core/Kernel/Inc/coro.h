@@ -0,0 +1,158 @@
+#ifndef __CORO_H__
+#define __CORO_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "attr.h"
+#include "list.h"
+#include "mqueue.h"
+#include "sync.h"
+#include "task.h"
+
+/**
+ * @brief Coroutine status enumeration, returned on every suspension
+ */
+typedef enum OCTOS_PACKED CoroStatus {
+    CoroWaiting, /*!< Awaiting, parked until its continuation runs or polled */
+    CoroYielded, /*!< Yielded, run again without the host sleeping */
+    CoroDelayed, /*!< Sleeping until its wake tick */
+    CoroDone     /*!< Finished, removed from the host */
+} CoroStatus_t;
+
+struct Coro;
+struct CoroHost;
+
+/**
+ * @brief Coroutine function type
+ * @note The function is re-entered from the top on every resumption, local
+ *       variables do not survive a suspension point. Keep state in args
+ */
+typedef CoroStatus_t (*CoroFunc_t)(struct Coro *coro, void *args);
+
+/**
+ * @brief Coroutine structure definition (continuation record)
+ */
+typedef struct Coro {
+    ListItem_t Item;                 /*!< List item for the host's lists */
+    TaskContinuation_t Continuation; /*!< Armed on the object awaited */
+    struct CoroHost *Host;           /*!< Host running the coroutine */
+    CoroFunc_t Func;                 /*!< Coroutine function */
+    void *Args;                      /*!< Arguments passed to the function */
+    Tick_t WakeTick; /*!< Tick at which a delayed coroutine resumes */
+    uint32_t Line;   /*!< Resume point within the function */
+} Coro_t;
+
+/**
+ * @brief Coroutine host structure definition
+ * @note All coroutines of a host run on the stack of its host task
+ */
+typedef struct CoroHost {
+    List_t ActiveList;  /*!< Coroutines run on every host pass */
+    List_t TimerList;   /*!< Delayed coroutines, sorted by wake tick */
+    List_t StartList;   /*!< Coroutines started since the last pass */
+    TaskHandle_t Task;  /*!< Host task */
+    uint32_t PollTicks; /*!< Poll period of CORO_AWAIT() conditions */
+} CoroHost_t;
+
+/* Coroutine Body ------------------------------------------------------------*/
+
+/**
+ * @brief Begin a coroutine body
+ */
+#define CORO_BEGIN(coro)                                                       \
+    switch ((coro)->Line) {                                                    \
+        case 0:
+
+/**
+ * @brief End a coroutine body
+ */
+#define CORO_END(coro)                                                         \
+    }                                                                          \
+    (coro)->Line = 0;                                                          \
+    return CoroDone
+
+/**
+ * @brief Give the other coroutines and tasks a chance to run
+ */
+#define CORO_YIELD(coro)                                                       \
+    do {                                                                       \
+        (coro)->Line = __LINE__;                                               \
+        return CoroYielded;                                                    \
+        case __LINE__:;                                                        \
+    } while (0)
+
+/**
+ * @brief Suspend the coroutine until a condition holds
+ * @note The condition is evaluated on every host pass, it must not block.
+ *       Polled every PollTicks of the host unless coro_host_wake() is called
+ */
+#define CORO_AWAIT(coro, cond)                                                 \
+    do {                                                                       \
+        (coro)->Line = __LINE__;                                               \
+        OCTOS_FALLTHROUGH;                                                     \
+        case __LINE__:                                                         \
+            if (!(cond)) return CoroWaiting;                                   \
+    } while (0)
+
+/**
+ * @brief Suspend the coroutine until a condition on a kernel object holds
+ * @note The coroutine is armed on the continuation chain of the object and
+ *       parked, only a signal of the object runs it again
+ * @param chain: Pointer to the continuation chain of the object
+ */
+#define CORO_AWAIT_ON(coro, chain, cond)                                       \
+    do {                                                                       \
+        (coro)->Line = __LINE__;                                               \
+        OCTOS_FALLTHROUGH;                                                     \
+        case __LINE__:                                                         \
+            if (!(cond)) {                                                     \
+                task_continuation_arm((chain), &((coro)->Continuation));       \
+                if (!(cond)) return CoroWaiting;                               \
+                task_continuation_disarm(&((coro)->Continuation));             \
+            }                                                                  \
+    } while (0)
+
+/**
+ * @brief Suspend the coroutine for a number of ticks
+ */
+#define CORO_DELAY(coro, ticks)                                                \
+    do {                                                                       \
+        (coro)->WakeTick = task_get_tick() + (ticks);                          \
+        (coro)->Line = __LINE__;                                               \
+        return CoroDelayed;                                                    \
+        case __LINE__:;                                                        \
+    } while (0)
+
+/* Await Kernel Objects ------------------------------------------------------*/
+
+#define CORO_AWAIT_MQUEUE_RECV(coro, mqueue, buffer)                           \
+    CORO_AWAIT_ON(coro, &((mqueue)->Continuations),                            \
+                  mqueue_recv((mqueue), (buffer), 0))
+
+#define CORO_AWAIT_MQUEUE_SEND(coro, mqueue, item)                             \
+    CORO_AWAIT_ON(coro, &((mqueue)->Continuations),                            \
+                  mqueue_send((mqueue), (item), 0))
+
+#define CORO_AWAIT_SEMA(coro, sema)                                            \
+    CORO_AWAIT_ON(coro, &((sema)->Core.Continuations),                         \
+                  sema_acquire((sema), 0))
+
+#define CORO_AWAIT_EVENT(coro, event)                                          \
+    CORO_AWAIT_ON(coro, &((event)->Core.Continuations), event_is_set(event))
+
+#define CORO_AWAIT_EVENT_GROUP(coro, group, bits, mode, clear_on_exit, buffer) \
+    CORO_AWAIT_ON(coro, &((group)->Core.Continuations),                        \
+                  event_group_wait((group), (bits), (mode), (clear_on_exit),   \
+                                   (buffer), 0))
+
+/* Coroutine Host ------------------------------------------------------------*/
+bool coro_host_init(CoroHost_t *host, const char *name, uint8_t priority,
+                    size_t page_size_in_words, uint32_t poll_ticks);
+void coro_start(CoroHost_t *host, Coro_t *coro, CoroFunc_t func, void *args);
+bool coro_is_running(Coro_t *coro);
+void coro_host_wake(CoroHost_t *host);
+void coro_host_wake_from_isr(CoroHost_t *host, bool *const switch_required);
+
+#endif
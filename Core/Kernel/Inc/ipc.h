@@ -0,0 +1,43 @@
+#ifndef __IPC_H__
+#define __IPC_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "list.h"
+#include "task.h"
+
+/**
+ * @brief Synchronous IPC endpoint structure definition
+ * @note Clients call the endpoint and block until a server replies. The
+ *       request is copied once, straight into the buffer of the receiving
+ *       server, and the response straight into the buffer of the caller
+ */
+typedef struct IpcEndpoint {
+    List_t Callers;      /*!< Calls not yet received, sorted by priority */
+    List_t Servers;      /*!< Servers waiting for a call */
+    size_t RequestSize;  /*!< Size of a request in bytes */
+    size_t ResponseSize; /*!< Size of a response in bytes */
+} IpcEndpoint_t;
+
+/**
+ * @brief Define an IPC endpoint initialized at compile time
+ * @note May be preceded by static
+ */
+#define OCTOS_IPC_DEFINE(name, request_size_in_bytes, response_size_in_bytes)  \
+    IpcEndpoint_t name = {.Callers = LIST_INITIALIZER((name).Callers),         \
+                          .Servers = LIST_INITIALIZER((name).Servers),         \
+                          .RequestSize = (request_size_in_bytes),              \
+                          .ResponseSize = (response_size_in_bytes)}
+
+void ipc_init(IpcEndpoint_t *endpoint, size_t request_size_in_bytes,
+              size_t response_size_in_bytes);
+bool ipc_call(IpcEndpoint_t *endpoint, const void *request, void *response,
+              uint32_t timeout_ticks);
+bool ipc_recv(IpcEndpoint_t *endpoint, void *request, TaskHandle_t *caller,
+              uint32_t timeout_ticks);
+bool ipc_reply(IpcEndpoint_t *endpoint, TaskHandle_t caller,
+               const void *response);
+
+#endif
@@ -2,9 +2,14 @@
 #define __KERNEL_H__
 
 #include "Kernel/Inc/utils.h"
-#include "mqueue.h"// IWYU pragma: keep
-#include "sync.h"  // IWYU pragma: keep
-#include "task.h"  // IWYU pragma: keep
+#include "clock.h"   // IWYU pragma: keep
+#include "coro.h"    // IWYU pragma: keep
+#include "ipc.h"     // IWYU pragma: keep
+#include "mqueue.h"  // IWYU pragma: keep
+#include "profile.h" // IWYU pragma: keep
+#include "sync.h"    // IWYU pragma: keep
+#include "task.h"    // IWYU pragma: keep
+#include "workq.h"   // IWYU pragma: keep
 
 void kernel_launch(Quanta_t *quanta);
 
@@ -5,23 +5,59 @@
 #include <stdint.h>
 
 #include "attr.h"
+#include "config.h"
 #include "list.h"
 #include "queue.h"
+#include "task.h"
 
-#define queueUNLOCKED ((int8_t) -1)
-#define queueLOCKED_UNMODIFIED ((int8_t) 0)
+#define queueUNLOCKED ((int16_t) -1)
+#define queueLOCKED_UNMODIFIED ((int16_t) 0)
+
+/**
+ * @brief Waiting list of a message queue
+ * @note Bucketed lists make blocking and waking O(1) in the number of
+ *       waiters, sorted lists keep the structure small
+ */
+#if OCTOS_MQUEUE_BUCKETED_WAIT
+typedef EventList_t MsgQueueWaitList_t;
+#define MQUEUE_WAIT_LIST_INITIALIZER(list) EVENT_LIST_INITIALIZER
+#else
+typedef List_t MsgQueueWaitList_t;
+#define MQUEUE_WAIT_LIST_INITIALIZER(list) LIST_INITIALIZER(list)
+#endif
 
 /**
   * @brief Message queue structure containing queue and waiting lists
   */
 typedef struct MsgQueue {
     Queue_t Queue;       /*!< Underlying queue structure for message storage */
-    List_t SenderList;   /*!< List of tasks waiting to send messages */
-    List_t ReceiverList; /*!< List of tasks waiting to receive messages */
-    int8_t RxLock;       /*!< Lock for receiving messages */
-    int8_t TxLock;       /*!< Lock for sending messages */
+    MsgQueueWaitList_t SenderList;   /*!< Tasks waiting to send messages */
+    MsgQueueWaitList_t ReceiverList; /*!< Tasks waiting to receive messages */
+    TaskContinuation_t *Continuations; /*!< Run on every send and receive */
+    int16_t RxLock; /*!< Lock for receiving messages */
+    int16_t TxLock; /*!< Lock for sending messages */
 } MsgQueue_t;
 
+/**
+ * @brief Define a message queue and its storage initialized at compile time
+ * @note May be preceded by static. The storage is an unnamed array, so the
+ *       macro must be used at file scope
+ */
+#define OCTOS_MQUEUE_DEFINE(name, item_size_in_bytes, max_size)                \
+    MsgQueue_t name = {                                                        \
+            .Queue = {.Buffer =                                                \
+                              (uint8_t[(item_size_in_bytes) * (max_size)]){0}, \
+                      .ItemSize = (item_size_in_bytes),                        \
+                      .MaxSize = (max_size),                                   \
+                      .Size = 0,                                               \
+                      .WriteIndex = 0,                                         \
+                      .ReadIndex = 0},                                         \
+            .SenderList = MQUEUE_WAIT_LIST_INITIALIZER((name).SenderList),     \
+            .ReceiverList = MQUEUE_WAIT_LIST_INITIALIZER((name).ReceiverList), \
+            .Continuations = NULL,                                             \
+            .RxLock = queueUNLOCKED,                                           \
+            .TxLock = queueUNLOCKED}
+
 void mqueue_init(MsgQueue_t *mqueue, void *buffer, size_t item_size_in_bytes,
                  size_t max_size);
 bool mqueue_send(MsgQueue_t *mqueue, const void *item, uint32_t timeout_ticks);
@@ -0,0 +1,31 @@
+#ifndef __PROFILE_H__
+#define __PROFILE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config.h"
+
+/**
+ * @brief Critical section profile of a single call site
+ * @note Histogram bucket i counts sections shorter than 64 * 4^i cycles, the
+ *       last bucket counts every longer section
+ * @note Claimed by its line, zero while free, then published by its file
+ */
+typedef struct CriticalSite {
+    const char *File;        /*!< Source file of the call site */
+    volatile uint32_t Line;  /*!< Source line of the call site */
+    uint32_t Count;          /*!< Number of recorded sections */
+    uint32_t MaxCycles;      /*!< Longest masked duration in cycles */
+    uint64_t TotalCycles;    /*!< Sum of masked durations in cycles */
+    uint32_t Histogram[OCTOS_CRITICAL_PROFILING_BUCKETS]; /*!< Durations */
+} CriticalSite_t;
+
+/* Critical Section Profiling ------------------------------------------------*/
+CriticalSite_t *profile_critical_site(const char *file, uint32_t line);
+void profile_critical_enter(CriticalSite_t *site);
+void profile_critical_exit(void);
+void profile_critical_reset(void);
+size_t profile_critical_report(char *buffer, size_t size);
+
+#endif
@@ -4,18 +4,20 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "config.h"
 #include "list.h"
 #include "task.h"
 
-#define syncUNLOCKED ((int8_t) -1)
-#define syncLOCKED_UNMODIFIED ((int8_t) 0)
+#define syncUNLOCKED ((int16_t) -1)
+#define syncLOCKED_UNMODIFIED ((int16_t) 0)
 
 /**
  * @brief Synchronization Core structure definition
  */
 typedef struct SyncCore {
     List_t BlockedList; /*!< List of blocked tasks */
-    int8_t Lock;        /*!< Lock state of the synchronization object */
+    TaskContinuation_t *Continuations; /*!< Continuations armed on it */
+    int16_t Lock;       /*!< Lock state of the synchronization object */
 } SyncCore_t;
 
 /**
@@ -26,12 +28,23 @@ typedef struct Sema {
     SyncCore_t Core; /*!< Synchronization core */
 } Sema_t;
 
+/**
+ * @brief Mutex protocol enumeration
+ */
+typedef enum OCTOS_PACKED MutexProtocol {
+    MutexInherit, /*!< Priority inheritance, boost the owner on contention */
+    MutexCeiling  /*!< Immediate priority ceiling, boost the owner on acquire */
+} MutexProtocol_t;
+
 /**
  * @brief Mutex structure definition
  */
 typedef struct Mutex {
-    TaskHandle_t Owner; /*!< Pointer to the task that owns the mutex */
-    SyncCore_t Core;    /*!< Synchronization core */
+    TaskHandle_t Owner;       /*!< Pointer to the task that owns the mutex */
+    struct Mutex *NextHeld;   /*!< Next mutex held by the same owner */
+    MutexProtocol_t Protocol; /*!< Priority protocol of the mutex */
+    uint8_t Ceiling;          /*!< Ceiling priority (MutexCeiling only) */
+    SyncCore_t Core;          /*!< Synchronization core */
 } Mutex_t;
 
 /**
@@ -47,6 +60,7 @@ typedef struct Cond {
 typedef struct Barrier {
     uint16_t Parties; /*!< Number of parties required to release the barrier */
     uint16_t Count;   /*!< Current count of parties waiting at the barrier */
+    uint16_t Round;   /*!< Incremented on every release or reset */
     SyncCore_t Core;  /*!< Condition variable used for synchronization */
 } Barrier_t;
 
@@ -58,6 +72,154 @@ typedef struct Event {
     SyncCore_t Core; /*!< Synchronization core for managing blocked tasks */
 } Event_t;
 
+/**
+ * @brief Event group wait mode enumeration
+ */
+typedef enum OCTOS_PACKED EventGroupWaitMode {
+    WaitAny, /*!< Wait for any of the requested bits to be set */
+    WaitAll  /*!< Wait for all of the requested bits to be set */
+} EventGroupWaitMode_t;
+
+/**
+ * @brief Event group structure definition
+ */
+typedef struct EventGroup {
+    uint32_t Bits;   /*!< Event flag word */
+    SyncCore_t Core; /*!< Synchronization core for managing blocked tasks */
+} EventGroup_t;
+
+/**
+ * @brief Reader-writer lock hold structure definition
+ * @note A read hold is owned by the reader, usually on its stack, from
+ *       rwlock_read_acquire() until the matching rwlock_read_release(), so
+ *       any number of tasks may read at once. The write hold is part of the
+ *       lock
+ */
+typedef struct RwLockHold {
+    TaskHandle_t Owner;            /*!< Task holding the lock */
+    struct RwLock *Lock;           /*!< Lock held */
+    struct RwLockHold *NextReader; /*!< Next read hold of the same lock */
+    struct RwLockHold *NextHeld;   /*!< Next hold of the same owner */
+} RwLockHold_t;
+
+/**
+ * @brief Reader-writer lock structure definition
+ */
+typedef struct RwLock {
+    RwLockHold_t Write;      /*!< Hold of the writer, no owner if unlocked */
+    RwLockHold_t *Readers;   /*!< Chain of the read holds */
+    uint16_t WritersWaiting; /*!< Number of writers waiting for the lock */
+    SyncCore_t ReaderCore;   /*!< Synchronization core for blocked readers */
+    SyncCore_t WriterCore;   /*!< Synchronization core for blocked writers */
+} RwLock_t;
+
+/**
+ * @brief Completion state enumeration
+ */
+typedef enum OCTOS_PACKED CompletionState {
+    CompletionIdle,    /*!< No operation attached to the completion */
+    CompletionPending, /*!< Operation started, not completed yet */
+    CompletionDone     /*!< Operation completed, status is valid */
+} CompletionState_t;
+
+/**
+ * @brief Completion structure definition
+ * @note A completion is a one-shot future, a driver resets it when starting
+ *       an operation and completes it with a status, usually from an ISR.
+ *       Only one task may wait on a completion at a time
+ */
+typedef struct Completion {
+    volatile TaskHandle_t Waiter;     /*!< Task waiting on the completion */
+    volatile int32_t Status;          /*!< Status of the operation */
+    volatile CompletionState_t State; /*!< State of the completion */
+} Completion_t;
+
+/* Static Definition ---------------------------------------------------------*/
+
+/**
+ * @brief Constant initializer of a synchronization core
+ */
+#define SYNC_CORE_INITIALIZER(core)                                            \
+    {.BlockedList = LIST_INITIALIZER((core).BlockedList),                      \
+     .Continuations = NULL,                                                    \
+     .Lock = syncUNLOCKED}
+
+/**
+ * @brief Define a semaphore initialized at compile time
+ * @note May be preceded by static, the *_init call is not needed
+ */
+#define OCTOS_SEMA_DEFINE(name, initial_count)                                 \
+    Sema_t name = {.Count = (initial_count),                                   \
+                   .Core = SYNC_CORE_INITIALIZER((name).Core)}
+
+/**
+ * @brief Define a priority inheritance mutex initialized at compile time
+ */
+#define OCTOS_MUTEX_DEFINE(name)                                               \
+    Mutex_t name = {.Owner = NULL,                                             \
+                    .NextHeld = NULL,                                          \
+                    .Protocol = MutexInherit,                                  \
+                    .Ceiling = 0,                                              \
+                    .Core = SYNC_CORE_INITIALIZER((name).Core)}
+
+/**
+ * @brief Define a priority ceiling mutex initialized at compile time
+ */
+#define OCTOS_MUTEX_CEILING_DEFINE(name, ceiling)                              \
+    Mutex_t name = {.Owner = NULL,                                             \
+                    .NextHeld = NULL,                                          \
+                    .Protocol = MutexCeiling,                                  \
+                    .Ceiling = (ceiling),                                      \
+                    .Core = SYNC_CORE_INITIALIZER((name).Core)}
+
+/**
+ * @brief Define a reader-writer lock initialized at compile time
+ */
+#define OCTOS_RWLOCK_DEFINE(name)                                              \
+    RwLock_t name = {.Write = {.Owner = NULL,                                  \
+                               .Lock = &(name),                                \
+                               .NextReader = NULL,                             \
+                               .NextHeld = NULL},                              \
+                     .Readers = NULL,                                          \
+                     .WritersWaiting = 0,                                      \
+                     .ReaderCore = SYNC_CORE_INITIALIZER((name).ReaderCore),   \
+                     .WriterCore = SYNC_CORE_INITIALIZER((name).WriterCore)}
+
+/**
+ * @brief Define a condition variable initialized at compile time
+ */
+#define OCTOS_COND_DEFINE(name)                                                \
+    Cond_t name = {.Core = SYNC_CORE_INITIALIZER((name).Core)}
+
+/**
+ * @brief Define a barrier initialized at compile time
+ */
+#define OCTOS_BARRIER_DEFINE(name, parties)                                    \
+    Barrier_t name = {.Parties = (parties),                                    \
+                      .Count = 0,                                              \
+                      .Round = 0,                                              \
+                      .Core = SYNC_CORE_INITIALIZER((name).Core)}
+
+/**
+ * @brief Define an event initialized at compile time
+ */
+#define OCTOS_EVENT_DEFINE(name)                                               \
+    Event_t name = {.Flag = false, .Core = SYNC_CORE_INITIALIZER((name).Core)}
+
+/**
+ * @brief Define an event group initialized at compile time
+ */
+#define OCTOS_EVENT_GROUP_DEFINE(name)                                         \
+    EventGroup_t name = {.Bits = 0,                                            \
+                         .Core = SYNC_CORE_INITIALIZER((name).Core)}
+
+/**
+ * @brief Define a completion initialized at compile time
+ */
+#define OCTOS_COMPLETION_DEFINE(name)                                          \
+    Completion_t name = {                                                      \
+            .Waiter = NULL, .Status = 0, .State = CompletionIdle}
+
 /* Semaphore -----------------------------------------------------------------*/
 void sema_init(Sema_t *sema, int32_t initial_count);
 bool sema_acquire(Sema_t *sema, uint32_t timeout_ticks);
@@ -66,11 +228,20 @@ bool sema_acquire_from_isr(Sema_t *sema);
 void sema_release_from_isr(Sema_t *sema, bool *const switch_required);
 /* Mutex ---------------------------------------------------------------------*/
 void mutex_init(Mutex_t *mutex);
+void mutex_init_ceiling(Mutex_t *mutex, uint8_t ceiling);
 bool mutex_acquire(Mutex_t *mutex, uint32_t timeout_ticks);
 bool mutex_release(Mutex_t *mutex);
+/* Reader-Writer Lock --------------------------------------------------------*/
+void rwlock_init(RwLock_t *rwlock);
+bool rwlock_read_acquire(RwLock_t *rwlock, RwLockHold_t *hold,
+                         uint32_t timeout_ticks);
+bool rwlock_read_release(RwLock_t *rwlock, RwLockHold_t *hold);
+bool rwlock_write_acquire(RwLock_t *rwlock, uint32_t timeout_ticks);
+bool rwlock_write_release(RwLock_t *rwlock);
 /* Condtion ------------------------------------------------------------------*/
 void cond_init(Cond_t *cond);
 bool cond_wait(Cond_t *cond, uint32_t timeout_ticks);
+bool cond_wait_mutex(Cond_t *cond, Mutex_t *mutex, uint32_t timeout_ticks);
 void cond_notify(Cond_t *cond);
 void cond_notify_all(Cond_t *cond);
 void cond_notify_from_isr(Cond_t *cond, bool *const switch_required);
@@ -89,5 +260,44 @@ bool event_wait(Event_t *event, uint32_t timeout_ticks);
 bool event_is_set_from_isr(Event_t *event);
 void event_set_from_isr(Event_t *event, bool *const switch_required);
 void event_clear_from_isr(Event_t *event);
+/* Event Group ---------------------------------------------------------------*/
+void event_group_init(EventGroup_t *group);
+uint32_t event_group_get(EventGroup_t *group);
+void event_group_set(EventGroup_t *group, uint32_t bits);
+uint32_t event_group_clear(EventGroup_t *group, uint32_t bits);
+bool event_group_wait(EventGroup_t *group, uint32_t bits,
+                      EventGroupWaitMode_t mode, bool clear_on_exit,
+                      uint32_t *buffer, uint32_t timeout_ticks);
+uint32_t event_group_get_from_isr(EventGroup_t *group);
+void event_group_set_from_isr(EventGroup_t *group, uint32_t bits,
+                              bool *const switch_required);
+uint32_t event_group_clear_from_isr(EventGroup_t *group, uint32_t bits);
+/* Futex ---------------------------------------------------------------------*/
+void futex_init(void);
+bool futex_wait(volatile uint32_t *addr, uint32_t expected,
+                uint32_t timeout_ticks);
+size_t futex_wake(volatile uint32_t *addr, size_t count);
+void futex_wake_from_isr(volatile uint32_t *addr, size_t count,
+                         bool *const switch_required);
+/* Completion ----------------------------------------------------------------*/
+void completion_init(Completion_t *completion);
+void completion_reset(Completion_t *completion);
+bool completion_is_done(Completion_t *completion);
+int32_t completion_get_status(Completion_t *completion);
+void completion_complete(Completion_t *completion, int32_t status);
+void completion_complete_from_isr(Completion_t *completion, int32_t status,
+                                  bool *const switch_required);
+bool completion_wait(Completion_t *completion, uint32_t timeout_ticks);
+bool completion_wait_any(Completion_t *const *completions, size_t count,
+                         size_t *index, uint32_t timeout_ticks);
+bool completion_wait_all(Completion_t *const *completions, size_t count,
+                         uint32_t timeout_ticks);
+#if OCTOS_HRTIMER
+bool completion_wait_us(Completion_t *completion, uint32_t timeout_us);
+#endif
+/* Priority Donation ---------------------------------------------------------*/
+bool sync_donate_priority(TaskDonation_t *donation, TaskHandle_t donor,
+                          TaskHandle_t donee);
+bool sync_revoke_priority(TaskDonation_t *donation);
 
 #endif
@@ -4,14 +4,31 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "attr.h"
+#include "config.h"
 #include "list.h"
 #include "page.h"
+#include "utils.h"
 
 /* For zero struct padding */
 #define TCB_NAME_MAX_LENGTH 12
 
+/* Event group wait flags stored in TCB */
+#define taskEVENT_WAIT_ALL ((uint8_t) 0x01)
+#define taskEVENT_CLEAR_ON_EXIT ((uint8_t) 0x02)
+#define taskEVENT_DELIVERED ((uint8_t) 0x04)
+
+/* End marker value of the per-priority buckets of an EventList_t */
+#define taskEVENT_BUCKET_END ((uint32_t) 0xFFFFFFFE)
+
+/* Notification slot reserved for kernel services, slot 0 is left to users */
+#define taskKERNEL_NOTIFY_INDEX (OCTOS_TASK_NOTIFY_SLOTS - 1)
+#if OCTOS_TASK_NOTIFY_SLOTS < 2
+#error "OCTOS_TASK_NOTIFY_SLOTS must be at least 2, the last slot is reserved"
+#endif
+
 /**
   * @brief Function pointer type for tasks that can be executed by the scheduler
   * @param args Pointer to the task's arguments
@@ -30,6 +47,50 @@ typedef enum OCTOS_PACKED TaskState {
     INVALID     /*!< Invalid */
 } TaskState_t;
 
+/**
+ * @brief Kind of lock a thread is blocked on, for priority propagation
+ */
+typedef enum OCTOS_PACKED TaskBlockedOn {
+    BlockedOnNone,  /*!< Thread is not blocked on a lock */
+    BlockedOnMutex,   /*!< Thread is blocked on a Mutex_t */
+    BlockedOnRwLock,  /*!< Thread is blocked on a RwLock_t */
+    BlockedOnDonation /*!< Thread waits on the task of a TaskDonation_t */
+} TaskBlockedOn_t;
+
+/**
+ * @brief Priority lent by a blocked task to the task it waits on
+ * @note Linked into the Donations chain of the donee, e.g. an IPC server
+ *       serving a call runs at least at the priority of the caller
+ */
+typedef struct TaskDonation {
+    struct TaskDonation *Next; /*!< Next donation to the same donee */
+    struct TCB *Donor;         /*!< Task lending its priority */
+    struct TCB *Donee;         /*!< Task running at the lent priority */
+} TaskDonation_t;
+
+struct TaskContinuation;
+
+/**
+ * @brief Function run when the object of a continuation is signalled
+ * @note Runs within critical section, from a task or an ISR
+ * @return true to notify the task of the continuation
+ */
+typedef bool (*TaskContinuationFunc_t)(struct TaskContinuation *continuation);
+
+/**
+ * @brief Continuation record, waits on a kernel object without a task
+ * @note Armed on the continuation chain of an object, the next signal of
+ *       the object disarms and runs every continuation on it, then notifies
+ *       its task on the kernel notification slot. Lets stackless code such
+ *       as coroutines wait instead of polling
+ */
+typedef struct TaskContinuation {
+    struct TaskContinuation *Next;   /*!< Next continuation on the chain */
+    struct TaskContinuation **Chain; /*!< Chain armed on, NULL if disarmed */
+    TaskContinuationFunc_t Func;     /*!< Run when the object is signalled */
+    struct TCB *Task;                /*!< Task running the continuation */
+} TaskContinuation_t;
+
 /**
  * @brief Task notification state enumeration
  */
@@ -52,20 +113,31 @@ typedef enum OCTOS_PACKED TaskNotifyAction {
 
 /**
  * @brief Task Control Block structure definition
+ * @note The TCB sits at the start of its page, so the page address is the
+ *       TCB address. Members are ordered by alignment to avoid padding
  */
 typedef struct TCB {
-    uint32_t *StackTop;             /*!< Pointer to the top of task's stack */
-    Page_t Page;                    /*!< Memory page allocated for this task */
-    ListItem_t StateListItem;       /*!< List item for thread state lists */
-    ListItem_t EventListItem;       /*!< List item for event waiting lists */
+    uint32_t *StackTop;         /*!< Pointer to the top of task's stack */
+    uint32_t TCBNumber;         /*!< Unique identifier for the thread */
+    Tick_t WakeTick;            /*!< Tick at which a delayed task wakes */
+    ListItem_t StateListItem;   /*!< List item for thread state lists */
+    ListItem_t EventListItem;   /*!< List item for event waiting lists */
+    void *BlockedOn;            /*!< Lock the thread is blocked on */
+    struct Mutex *HeldMutexes;  /*!< Chain of mutexes held by the thread */
+    struct RwLockHold *HeldRwLocks; /*!< Chain of rwlock holds */
+    TaskDonation_t *Donations;  /*!< Chain of priorities lent to the thread */
+    volatile void *WaitContext; /*!< Object waited on by futex or cond */
+    struct TCB *volatile IsrWakeNext; /*!< Link on the ISR wake stack */
+    uint32_t EventBits;         /*!< Event group bits waited for or delivered */
+    uint32_t NotifiedValue[OCTOS_TASK_NOTIFY_SLOTS];        /*!< Slot values */
+    TaskNotifyState_t NotifyState[OCTOS_TASK_NOTIFY_SLOTS]; /*!< Slot states */
     uint8_t RootPriority;           /*!< Original priority of the thread */
     uint8_t Priority;               /*!< Current priority of the thread */
     uint8_t MutexHeld;              /*!< Current number of mutexes held */
+    TaskBlockedOn_t BlockedOnType;  /*!< Kind of the lock blocked on */
+    uint8_t EventFlags;             /*!< Event group wait flags */
+    uint8_t PagePolicy;             /*!< Allocation policy of the page */
     char Name[TCB_NAME_MAX_LENGTH]; /*!< Task name */
-    TaskNotifyState_t
-            NotifyState;    /*!< Current notification state of the task */
-    uint32_t NotifiedValue; /*!< Value associated with the notification */
-    uint32_t TCBNumber;     /*!< Unique identifier for the thread */
 } TCB_t;
 
 /**
@@ -73,6 +145,109 @@ typedef struct TCB {
  */
 typedef TCB_t *TaskHandle_t;
 
+/**
+ * @brief Periodic task statistics
+ * @note A job overruns when it completes after the tick of its deadline.
+ *       Release jitter is the delay between the tick of a release and the
+ *       start of the job
+ */
+typedef struct TaskPeriodicStats {
+    uint32_t Jobs;          /*!< Number of completed jobs */
+    uint32_t Overruns;      /*!< Jobs completed after their deadline */
+    Tick_t LastRelease;     /*!< Release tick of the last job */
+    Tick_t LastCompletion;  /*!< Completion tick of the last job */
+    Tick_t LastDeadline;    /*!< Absolute deadline of the last job */
+    uint32_t MaxResponse;   /*!< Longest release to completion in ticks */
+    uint32_t MaxJitterNs;   /*!< Largest release jitter in nanoseconds */
+    uint64_t TotalJitterNs; /*!< Sum of the release jitters in nanoseconds */
+} TaskPeriodicStats_t;
+
+/**
+ * @brief Periodic task structure definition
+ * @note Owned by the caller and must stay valid while the task exists
+ */
+typedef struct TaskPeriodic {
+    TaskFunc_t Func;           /*!< Job function, run once per period */
+    void *Args;                /*!< Arguments passed to the job function */
+    uint32_t Period;           /*!< Period in ticks */
+    uint32_t Deadline;         /*!< Deadline relative to release in ticks */
+    TaskPeriodicStats_t Stats; /*!< Release and deadline statistics */
+} TaskPeriodic_t;
+
+/**
+ * @brief Statically defined task, created by the kernel at launch
+ * @note Emitted by OCTOS_TASK_DEFINE into the octos_tasks section, the kernel
+ *       walks the section as an array so entries are pointer aligned
+ */
+typedef struct TaskDefine {
+    TaskFunc_t Func;      /*!< Pointer to the task function */
+    void *Args;           /*!< Arguments passed to the task function */
+    const char *Name;     /*!< Name of the task */
+    uint32_t *Page;       /*!< Statically allocated page of the task */
+    size_t PageSize;      /*!< Size of the page in words */
+    TaskHandle_t *Handle; /*!< Handle of the task, set at launch */
+    uint8_t Priority;     /*!< Priority of the task */
+} TaskDefine_t;
+
+/**
+ * @brief Define a task created at kernel launch, in a given page section
+ * @note The page and the descriptor are emitted at compile time, no heap is
+ *       used and the page is accounted for by the linker. The macro also
+ *       defines the task handle, a global named after the task
+ */
+#define OCTOS_TASK_DEFINE_IN(section, handle, func, args, name, priority,      \
+                             page_size_in_words)                               \
+    _Static_assert((priority) < OCTOS_MAX_PRIORITIES, "Invalid priority");     \
+    static uint32_t handle##_page[(page_size_in_words)] OCTOS_ALIGNED(8)       \
+            section;                                                           \
+    TaskHandle_t handle;                                                       \
+    static const TaskDefine_t handle##_define OCTOS_USED                       \
+            OCTOS_ALIGNED(sizeof(void *)) OCTOS_SECTION("octos_tasks") = {     \
+                    .Func = (TaskFunc_t) (func),                               \
+                    .Args = (args),                                            \
+                    .Name = (name),                                            \
+                    .Page = handle##_page,                                     \
+                    .PageSize = (page_size_in_words),                          \
+                    .Handle = &(handle),                                       \
+                    .Priority = (priority)}
+
+/**
+ * @brief Define a task created at kernel launch, its page is in .bss
+ */
+#define OCTOS_TASK_DEFINE(handle, func, args, name, priority,                  \
+                          page_size_in_words)                                  \
+    OCTOS_TASK_DEFINE_IN(, handle, func, args, name, priority,                 \
+                         page_size_in_words)
+
+/**
+ * @brief Define a task created at kernel launch, its page is in CCM RAM
+ * @note CCM RAM is not reachable by DMA, do not pass stack buffers to DMA
+ * @note Not available with OCTOS_COMPACT_LIST, CCM RAM is out of reach of
+ *       compact links from lists in SRAM
+ */
+#define OCTOS_TASK_DEFINE_CCMRAM(handle, func, args, name, priority,           \
+                                 page_size_in_words)                           \
+    _Static_assert(!OCTOS_COMPACT_LIST,                                        \
+                   "CCM RAM task pages are out of reach of compact lists");    \
+    OCTOS_TASK_DEFINE_IN(OCTOS_CCMRAM, handle, func, args, name, priority,     \
+                         page_size_in_words)
+
+/**
+ * @brief Priority-bucketed event list structure definition
+ * @note One FIFO bucket per priority and a bit per non-empty bucket, so that
+ *       adding a waiter and taking the highest priority waiter are O(1).
+ *       A zeroed event list is empty, buckets are set up on first use
+ */
+typedef struct EventList {
+    uint32_t Waiting[(OCTOS_MAX_PRIORITIES + 31) / 32]; /*!< Non-empty bits */
+    List_t Buckets[OCTOS_MAX_PRIORITIES]; /*!< Waiters of each priority */
+} EventList_t;
+
+/**
+ * @brief Constant initializer of an empty event list
+ */
+#define EVENT_LIST_INITIALIZER {.Waiting = {0}}
+
 /**
  * @brief Task Info
  */
@@ -86,16 +261,27 @@ typedef struct {
 TaskState_t task_status(TaskHandle_t handle);
 void task_set_timeout(Timeout_t *timeout);
 bool task_check_timeout(Timeout_t *timeout, uint32_t ticks_to_delay);
-uint8_t task_get_number_of_tasks(void);
+uint16_t task_get_number_of_tasks(void);
+TaskHandle_t task_get_current(void);
 bool task_get_info(TaskHandle_t handle, TaskInfo_t *info);
 void task_info_list(char *buffer);
 /* Task List -----------------------------------------------------------------*/
 void task_lists_init(void);
 void task_add_to_ready_list(TaskHandle_t handle);
+void task_handoff(TaskHandle_t handle);
 void task_remove_and_add_current_to_delayed_list(uint32_t ticks_to_delay);
 bool task_remove_from_delayed_list(TaskHandle_t handle);
 void task_add_current_to_event_list(List_t *list, uint32_t ticks_to_wait);
 bool task_remove_highest_priority_from_event_list(List_t *list);
+bool task_remove_all_from_event_list(List_t *list);
+bool task_remove_from_event_list(TaskHandle_t handle);
+void task_add_current_to_bucketed_list(EventList_t *list,
+                                       uint32_t ticks_to_wait);
+bool task_remove_highest_priority_from_bucketed_list(EventList_t *list);
+void task_add_current_to_event_group_list(List_t *list, uint32_t bits,
+                                          uint8_t flags,
+                                          uint32_t ticks_to_wait);
+bool task_take_event_bits(uint32_t *bits);
 /* Task Create and Delete ----------------------------------------------------*/
 bool task_create(TaskFunc_t func, void *const args, const char *name,
                  uint8_t priority, size_t page_size_in_words,
@@ -103,29 +289,41 @@ bool task_create(TaskFunc_t func, void *const args, const char *name,
 bool task_create_static(TaskFunc_t func, void *args, const char *name,
                         uint8_t priority, uint32_t *buffer,
                         size_t page_size_in_words, TaskHandle_t *handle);
+bool task_create_periodic(TaskPeriodic_t *periodic, TaskFunc_t func,
+                          void *args, const char *name, uint8_t priority,
+                          size_t page_size_in_words, uint32_t period_ticks,
+                          uint32_t deadline_ticks, TaskHandle_t *handle);
+void task_create_defined(void);
 void task_delete(TaskHandle_t handle);
 void task_release(TaskHandle_t handle);
 /* Task Core Operation -------------------------------------------------------*/
 bool task_tick_increment(void);
 void task_context_switch(void);
-uint32_t task_get_tick(void);
-uint32_t task_get_tick_from_isr(void);
-TCB_t *task_mutex_held_increment(void);
+Tick_t task_get_tick(void);
+Tick_t task_get_tick_from_isr(void);
+Tick_t task_get_elapsed_ticks(void);
+TaskHandle_t task_mutex_held_increment(void);
 bool task_mutex_held_decrement(TaskHandle_t mutex_owner);
-bool task_inherit_priority(TaskHandle_t mutex_owner);
-bool task_deinherit_priority(TaskHandle_t mutex_owner);
-void task_deinherit_priority_after_timeout(
-        TaskHandle_t mutex_owner, uint8_t highest_priority_of_waiting_tasks);
+bool task_set_effective_priority(TaskHandle_t handle, uint8_t priority);
 /* Task Basic Operation ------------------------------------------------------*/
 void task_yield(void);
 void task_yield_from_isr(bool flag);
 void task_suspend_all(void);
 bool task_resume_all(void);
 void task_delay(uint32_t ticks_to_delay);
+bool task_delay_until(Tick_t *previous_wake_tick, uint32_t period_ticks);
 void task_abort_delay(TaskHandle_t handle);
 void task_suspend(TaskHandle_t handle);
 void task_resume(TaskHandle_t handle);
 void task_resume_from_isr(TaskHandle_t handle);
+bool task_notify_indexed(TaskHandle_t handle, size_t index, uint32_t value,
+                         TaskNotifyAction_t action);
+bool task_notify_indexed_from_isr(TaskHandle_t handle, size_t index,
+                                  uint32_t value, TaskNotifyAction_t action,
+                                  bool *const switch_required);
+bool task_notify_wait_indexed(size_t index, uint32_t bits_to_clear_on_entry,
+                              uint32_t bits_to_clear_on_exit, uint32_t *buffer,
+                              uint32_t timeout_ticks);
 bool task_notify(TaskHandle_t handle, uint32_t value,
                  TaskNotifyAction_t action);
 bool task_notify_from_isr(TaskHandle_t handle, uint32_t value,
@@ -134,5 +332,56 @@ bool task_notify_from_isr(TaskHandle_t handle, uint32_t value,
 bool task_notify_wait(uint32_t bits_to_clear_on_entry,
                       uint32_t bits_to_clear_on_exit, uint32_t *buffer,
                       uint32_t timeout_ticks);
+/* Periodic Task -------------------------------------------------------------*/
+void task_periodic_get_stats(TaskPeriodic_t *periodic,
+                             TaskPeriodicStats_t *stats);
+void task_periodic_reset_stats(TaskPeriodic_t *periodic);
+/* Continuation --------------------------------------------------------------*/
+void task_continuation_arm(TaskContinuation_t **chain,
+                           TaskContinuation_t *continuation);
+bool task_continuation_disarm(TaskContinuation_t *continuation);
+void task_continuation_run_all(TaskContinuation_t **chain,
+                               bool *const switch_required);
+
+/* Event List ----------------------------------------------------------------*/
+
+/**
+ * @brief Initialize an event list
+ * @param list: Pointer to the event list
+ * @return None
+ */
+OCTOS_INLINE static inline void event_list_init(EventList_t *list) {
+    memset(list->Waiting, 0, sizeof(list->Waiting));
+}
+
+/**
+ * @brief Check if an event list has no waiter
+ * @param list: Pointer to the event list
+ * @retval true If no task waits on the list
+ * @retval false Otherwise
+ */
+OCTOS_INLINE static inline bool event_list_is_empty(EventList_t *list) {
+    for (size_t i = 0; i < sizeof(list->Waiting) / sizeof(uint32_t); i++)
+        if (list->Waiting[i] != 0) return false;
+
+    return true;
+}
+
+/* Continuation --------------------------------------------------------------*/
+
+/**
+ * @brief Run the continuations armed on a kernel object
+ * @note Called by every signal of the object, costs a load without any
+ * @note Must call within critical section
+ * @param chain: Pointer to the continuation chain of the object
+ * @param switch_required:
+ *      Pointer to a boolean flag indicating if a context switch is required
+ * @return None
+ */
+OCTOS_INLINE static inline void
+task_continuation_fire(TaskContinuation_t **chain,
+                       bool *const switch_required) {
+    if (*chain != NULL) task_continuation_run_all(chain, switch_required);
+}
 
 #endif
@@ -23,9 +23,13 @@ typedef struct Quanta {
     size_t Value;      /*!< Numerical value of the quanta */
 } Quanta_t;
 
+/**
+  * @brief System tick count, 64-bit so that it never wraps in practice
+  */
+typedef uint64_t Tick_t;
+
 typedef struct Timeout {
-    uint32_t entering_tick;
-    uint32_t overflows;
+    Tick_t entering_tick;
 } Timeout_t;
 
 extern Quanta_t *kernel_quanta;
@@ -0,0 +1,56 @@
+#ifndef __WORKQ_H__
+#define __WORKQ_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "list.h"
+#include "sync.h"
+
+/**
+ * @brief Work function type
+ */
+typedef void (*WorkFunc_t)(void *args);
+
+struct WorkQueue;
+
+/**
+ * @brief Work item structure definition
+ * @note A work item is owned by the caller and must stay valid while it is
+ *       submitted and until its function returns. An item is pending on at
+ *       most one queue at a time and never runs on two workers at once
+ */
+typedef struct Work {
+    ListItem_t Item;         /*!< List item for the pending or delayed list */
+    struct WorkQueue *Queue; /*!< Queue the item was last submitted to */
+    WorkFunc_t Func;         /*!< Function to run */
+    void *Args;              /*!< Arguments passed to the function */
+    Tick_t DueTick;   /*!< Tick at which delayed work becomes pending */
+    uint8_t Priority; /*!< Priority within the queue, higher runs first */
+    uint8_t State;    /*!< workRUNNING and workRERUN flags */
+} Work_t;
+
+/**
+ * @brief Work queue structure definition
+ */
+typedef struct WorkQueue {
+    List_t PendingList; /*!< Work ready to run, sorted by priority */
+    List_t DelayedList; /*!< Work waiting for its due tick, sorted by it */
+    Sema_t Sema;        /*!< Wakes idle workers when work is queued */
+    Tick_t NextDueTick; /*!< Earliest due tick idle workers wake for */
+} WorkQueue_t;
+
+void work_init(Work_t *work, WorkFunc_t func, void *args, uint8_t priority);
+bool work_is_pending(Work_t *work);
+bool work_is_running(Work_t *work);
+bool workq_init(WorkQueue_t *queue, const char *name, uint8_t priority,
+                size_t workers, size_t page_size_in_words);
+bool workq_submit(WorkQueue_t *queue, Work_t *work);
+bool workq_submit_delayed(WorkQueue_t *queue, Work_t *work,
+                          uint32_t delay_ticks);
+bool workq_cancel(WorkQueue_t *queue, Work_t *work);
+bool workq_submit_from_isr(WorkQueue_t *queue, Work_t *work,
+                           bool *const switch_required);
+
+#endif
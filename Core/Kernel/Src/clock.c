@@ -0,0 +1,356 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Arch/port.h"
+#include "clock.h"
+#include "config.h"
+#include "task.h"
+#include "utils.h"
+
+/* Longest delay handed to the hardware timer, later deadlines re-arm it */
+#define clockMAX_ARM_US ((uint64_t) INT32_MAX)
+
+#define clockNS_PER_US 1000U
+
+/* Last value returned, keeps the clock monotonic across the tick edge */
+static uint64_t clock_last_ns = 0;
+
+#if OCTOS_HRTIMER
+static HrTimer_t *hrtimer_head = NULL;
+#endif
+
+/* Private Helpers -----------------------------------------------------------*/
+
+/**
+ * @brief Read the clock
+ * @note Must call within critical section. A tick counted by the hardware
+ *       but not yet by the kernel is added
+ * @return Nanoseconds since the kernel launched
+ */
+static uint64_t clock_read(void) {
+    bool tick_pending = false;
+    const uint32_t elapsed_ns = OCTOS_SYSTICK_ELAPSED_NS(&tick_pending);
+    const Tick_t ticks = task_get_elapsed_ticks() + (tick_pending ? 1 : 0);
+
+    uint64_t now = clock_tick_to_ns(ticks) + elapsed_ns;
+    if (now < clock_last_ns) {
+        now = clock_last_ns;
+    } else {
+        clock_last_ns = now;
+    }
+
+    return now;
+}
+
+#if OCTOS_HRTIMER
+/**
+ * @brief Program the hardware timer for the earliest armed timer
+ * @note Must call within critical section
+ * @param now: The current time in nanoseconds
+ * @return None
+ */
+static void hrtimer_program(uint64_t now) {
+    if (hrtimer_head == NULL) {
+        OCTOS_HRTIMER_DISARM();
+        return;
+    }
+
+    const uint64_t deadline = hrtimer_head->Deadline;
+    uint64_t delay_us =
+            deadline > now ? (deadline - now + clockNS_PER_US - 1) /
+                                     clockNS_PER_US
+                           : 0;
+    if (delay_us == 0) delay_us = 1;
+    if (delay_us > clockMAX_ARM_US) delay_us = clockMAX_ARM_US;
+
+    OCTOS_HRTIMER_ARM((uint32_t) delay_us);
+}
+
+/**
+ * @brief Unlink a timer from the armed list
+ * @note Must call within critical section
+ * @param timer: Pointer to the timer
+ * @retval true If the timer was armed
+ * @retval false Otherwise
+ */
+static bool hrtimer_unlink(HrTimer_t *timer) {
+    if (!timer->Armed) return false;
+
+    for (HrTimer_t **link = &hrtimer_head; *link != NULL;
+         link = &((*link)->Next)) {
+        if (*link == timer) {
+            *link = timer->Next;
+            break;
+        }
+    }
+
+    timer->Next = NULL;
+    timer->Armed = false;
+    return true;
+}
+
+/**
+ * @brief Arm a timer at an absolute deadline
+ * @note Must call within critical section. An armed timer is re-armed,
+ *       timers of equal deadline expire in arming order
+ * @param timer: Pointer to the timer
+ * @param deadline: Expiry time in nanoseconds
+ * @return None
+ */
+static void hrtimer_arm(HrTimer_t *timer, uint64_t deadline) {
+    const bool was_head = (hrtimer_head == timer);
+    hrtimer_unlink(timer);
+
+    HrTimer_t **link = &hrtimer_head;
+    while (*link != NULL && (*link)->Deadline <= deadline)
+        link = &((*link)->Next);
+
+    timer->Deadline = deadline;
+    timer->Next = *link;
+    timer->Armed = true;
+    *link = timer;
+
+    if (was_head || hrtimer_head == timer) hrtimer_program(clock_read());
+}
+
+/**
+ * @brief Block the current task until an absolute deadline
+ * @param deadline: Wake up time in nanoseconds
+ * @return None
+ */
+static void clock_sleep_until(uint64_t deadline) {
+    HrTimer_t timer;
+    hrtimer_init(&timer, &hrtimer_notify_task, task_get_current());
+
+    OCTOS_ENTER_CRITICAL();
+    hrtimer_arm(&timer, deadline);
+    OCTOS_EXIT_CRITICAL();
+
+    /* A notification left over from an earlier wait only costs one more
+     * check */
+    while (hrtimer_is_armed(&timer))
+        task_notify_wait_indexed(taskKERNEL_NOTIFY_INDEX, 0, 0, NULL,
+                                 UINT32_MAX);
+}
+#endif
+
+/* Clock ---------------------------------------------------------------------*/
+
+/**
+ * @brief Get the monotonic high-resolution time
+ * @note Combines the tick count with the elapsed part of the current tick,
+ *       the resolution is the one of the tick timer counter
+ * @param None
+ * @return Nanoseconds since the kernel launched
+ */
+uint64_t clock_now_ns(void) {
+    OCTOS_ENTER_CRITICAL();
+    const uint64_t now = clock_read();
+    OCTOS_EXIT_CRITICAL();
+    return now;
+}
+
+/**
+ * @brief Get the monotonic high-resolution time from an ISR
+ * @param None
+ * @return Nanoseconds since the kernel launched
+ */
+uint64_t clock_now_ns_from_isr(void) {
+    uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
+    const uint64_t now = clock_read();
+    OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+    return now;
+}
+
+/**
+ * @brief Get the monotonic high-resolution time in microseconds
+ * @param None
+ * @return Microseconds since the kernel launched
+ */
+uint64_t clock_now_us(void) { return clock_now_ns() / clockNS_PER_US; }
+
+/**
+ * @brief Convert a tick count to the clock time base
+ * @param tick: Tick count
+ * @return Nanoseconds at which the tick started
+ */
+uint64_t clock_tick_to_ns(Tick_t tick) {
+    return tick * (((uint64_t) kernel_quanta->Value * 1000000000U) /
+                   kernel_quanta->Unit);
+}
+
+#if OCTOS_HRTIMER
+/* High-Resolution Timer -----------------------------------------------------*/
+
+/**
+ * @brief Initialize a high-resolution timer
+ * @param timer: Pointer to the timer to be initialized
+ * @param func: Function run from the timer interrupt on expiry
+ * @param args: Arguments passed to the function
+ * @return None
+ */
+void hrtimer_init(HrTimer_t *timer, HrTimerFunc_t func, void *args) {
+    timer->Next = NULL;
+    timer->Deadline = 0;
+    timer->Func = func;
+    timer->Args = args;
+    timer->Armed = false;
+}
+
+/**
+ * @brief Check if a timer is waiting for expiry
+ * @note A timer is disarmed before its function runs
+ * @param timer: Pointer to the timer
+ * @retval true If the timer is armed
+ * @retval false Otherwise
+ */
+bool hrtimer_is_armed(HrTimer_t *timer) { return timer->Armed; }
+
+/**
+ * @brief Arm a timer, re-arming it if already armed
+ * @param timer: Pointer to the timer
+ * @param delay_us: Delay before expiry in microseconds
+ * @return None
+ */
+void hrtimer_start(HrTimer_t *timer, uint32_t delay_us) {
+    OCTOS_ENTER_CRITICAL();
+    hrtimer_arm(timer,
+                clock_read() + (uint64_t) delay_us * clockNS_PER_US);
+    OCTOS_EXIT_CRITICAL();
+}
+
+/**
+ * @brief Arm a timer from an ISR, re-arming it if already armed
+ * @note May be called from a timer function to make the timer periodic
+ * @param timer: Pointer to the timer
+ * @param delay_us: Delay before expiry in microseconds
+ * @return None
+ */
+void hrtimer_start_from_isr(HrTimer_t *timer, uint32_t delay_us) {
+    uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
+    hrtimer_arm(timer,
+                clock_read() + (uint64_t) delay_us * clockNS_PER_US);
+    OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+}
+
+/**
+ * @brief Disarm a timer
+ * @param timer: Pointer to the timer
+ * @retval true If the timer was armed
+ * @retval false If it already expired or was never armed
+ */
+bool hrtimer_cancel(HrTimer_t *timer) {
+    OCTOS_ENTER_CRITICAL();
+
+    const bool was_head = (hrtimer_head == timer);
+    const bool was_armed = hrtimer_unlink(timer);
+    if (was_head) hrtimer_program(clock_read());
+
+    OCTOS_EXIT_CRITICAL();
+
+    return was_armed;
+}
+
+/**
+ * @brief Disarm a timer from an ISR
+ * @param timer: Pointer to the timer
+ * @retval true If the timer was armed
+ * @retval false If it already expired or was never armed
+ */
+bool hrtimer_cancel_from_isr(HrTimer_t *timer) {
+    uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
+
+    const bool was_head = (hrtimer_head == timer);
+    const bool was_armed = hrtimer_unlink(timer);
+    if (was_head) hrtimer_program(clock_read());
+
+    OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+
+    return was_armed;
+}
+
+/**
+ * @brief Timer function waking a task through the kernel notification slot
+ * @note The woken task is expected to recheck its own condition, such as
+ *       hrtimer_is_armed() on the timer
+ * @param task: Handle of the task to wake
+ * @param switch_required: Set to true if a context switch is required
+ * @return None
+ */
+void hrtimer_notify_task(void *task, bool *const switch_required) {
+    task_notify_indexed_from_isr((TaskHandle_t) task, taskKERNEL_NOTIFY_INDEX,
+                                 0, NoAction, switch_required);
+}
+
+/**
+ * @brief Run the expired timers
+ * @note Called by the port from the hardware timer interrupt. The timer
+ *       functions run outside the critical section
+ * @param None
+ * @retval true Context switch is required
+ * @retval false Context switch is not required
+ */
+bool hrtimer_process_from_isr(void) {
+    bool switch_required = false;
+
+    uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
+    uint64_t now = clock_read();
+
+    while (hrtimer_head != NULL && hrtimer_head->Deadline <= now) {
+        HrTimer_t *const timer = hrtimer_head;
+        hrtimer_head = timer->Next;
+        timer->Next = NULL;
+        timer->Armed = false;
+
+        OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+
+        bool woken = false;
+        timer->Func(timer->Args, &woken);
+        switch_required |= woken;
+
+        saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
+        now = clock_read();
+    }
+
+    hrtimer_program(now);
+
+    OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+
+    return switch_required;
+}
+
+/* Delay ---------------------------------------------------------------------*/
+
+/**
+ * @brief Block the current task for a number of microseconds
+ * @note Backed by the high-resolution timer, independent of the tick rate
+ * @param delay_us: Delay in microseconds
+ * @return None
+ */
+void clock_delay_us(uint32_t delay_us) {
+    if (delay_us == 0) return;
+    clock_sleep_until(clock_now_ns() + (uint64_t) delay_us * clockNS_PER_US);
+}
+
+/**
+ * @brief Block the current task until the next period boundary
+ * @note Wake times are derived from the previous one, so the period does
+ *       not drift with the execution time of the task
+ * @param previous_wake_us:
+ *      Pointer to the previous wake time, initialize it with clock_now_us().
+ *      Updated to the new wake time
+ * @param period_us: Period in microseconds
+ * @retval true If the task was blocked
+ * @retval false If the wake time already passed
+ */
+bool clock_delay_until_us(uint64_t *previous_wake_us, uint32_t period_us) {
+    const uint64_t wake_us = *previous_wake_us + period_us;
+    *previous_wake_us = wake_us;
+
+    if (wake_us <= clock_now_us()) return false;
+
+    clock_sleep_until(wake_us * clockNS_PER_US);
+    return true;
+}
+#endif
@@ -0,0 +1,255 @@
+#include <stdint.h>
+
+#include "Arch/port.h"
+#include "coro.h"
+#include "list.h"
+#include "task.h"
+
+/* Private Helpers -----------------------------------------------------------*/
+
+/**
+ * @brief Continuation of a coroutine, puts it back on its host
+ * @note Runs within critical section when the object awaited is signalled
+ * @param continuation: Pointer to the continuation of the coroutine
+ * @retval true To wake the host task
+ */
+static bool coro_resume(TaskContinuation_t *continuation) {
+    Coro_t *const coro = LIST_ITEM_OWNER(continuation, Coro_t, Continuation);
+
+    /* Not parked yet, the host sees the continuation disarmed and keeps it */
+    if (list_item_parent(&(coro->Item)) == NULL)
+        list_insert_end(&(coro->Host->StartList), &(coro->Item));
+
+    return true;
+}
+
+/**
+ * @brief Move the coroutines started by other tasks to the active list
+ * @param host: Pointer to the coroutine host
+ * @return None
+ */
+static void coro_host_take_started(CoroHost_t *host) {
+    OCTOS_ENTER_CRITICAL();
+
+    List_t *const start_list = &(host->StartList);
+    while (start_list->Length > 0) {
+        ListItem_t *const item = list_head(start_list);
+        list_remove(item);
+        list_insert_end(&(host->ActiveList), item);
+    }
+
+    OCTOS_EXIT_CRITICAL();
+}
+
+/**
+ * @brief Insert a delayed coroutine into the timer list by its wake tick
+ * @note Coroutines of equal wake tick resume in insertion order
+ * @param host: Pointer to the coroutine host
+ * @param coro: Pointer to the coroutine
+ * @return None
+ */
+static void coro_host_add_timer(CoroHost_t *host, Coro_t *coro) {
+    List_t *const timer_list = &(host->TimerList);
+    ListItem_t *position = &(timer_list->End);
+    ListItem_t *next = list_item_next(position);
+
+    while (next != &(timer_list->End) &&
+           LIST_ITEM_OWNER(next, Coro_t, Item)->WakeTick <= coro->WakeTick) {
+        position = next;
+        next = list_item_next(position);
+    }
+
+    list_insert_after(timer_list, position, &(coro->Item));
+}
+
+/**
+ * @brief Move due delayed coroutines to the active list
+ * @param host: Pointer to the coroutine host
+ * @param now: Tick of the current host pass
+ * @return None
+ */
+static void coro_host_expire(CoroHost_t *host, Tick_t now) {
+    List_t *const timer_list = &(host->TimerList);
+
+    while (timer_list->Length > 0) {
+        ListItem_t *const item = list_head(timer_list);
+        if (LIST_ITEM_OWNER(item, Coro_t, Item)->WakeTick > now) break;
+        list_remove(item);
+        list_insert_end(&(host->ActiveList), item);
+    }
+}
+
+/**
+ * @brief Get the number of ticks until the next delayed coroutine is due
+ * @param host: Pointer to the coroutine host
+ * @param now: The current tick
+ * @return Ticks until the next wake tick, UINT32_MAX if none
+ */
+static uint32_t coro_host_next_timer(CoroHost_t *host, Tick_t now) {
+    if (host->TimerList.Length == 0) return UINT32_MAX;
+
+    const Tick_t wake_tick =
+            LIST_ITEM_OWNER(list_head(&(host->TimerList)), Coro_t, Item)
+                    ->WakeTick;
+    if (wake_tick <= now) return 0;
+
+    /* Sleep in bounded steps, UINT32_MAX would wait forever */
+    return wake_tick - now < UINT32_MAX ? (uint32_t) (wake_tick - now)
+                                        : UINT32_MAX - 1;
+}
+
+/**
+ * @brief Host task body
+ * @note Each pass resumes every active coroutine once, then sleeps until
+ *       the next timer, the poll period or an explicit wake. Coroutines
+ *       awaiting a kernel object are parked off the active list until their
+ *       continuation runs
+ * @param args: Pointer to the coroutine host
+ * @return None
+ */
+static void coro_host_thread(void *args) {
+    CoroHost_t *const host = args;
+
+    while (true) {
+        const Tick_t now = task_get_tick();
+        bool yielded = false;
+
+        coro_host_take_started(host);
+        coro_host_expire(host, now);
+
+        List_t *const active_list = &(host->ActiveList);
+        ListItem_t *item = list_head(active_list);
+        for (size_t i = active_list->Length; i > 0; i--) {
+            ListItem_t *const next = list_item_next(item);
+            Coro_t *const coro = LIST_ITEM_OWNER(item, Coro_t, Item);
+
+            switch (coro->Func(coro, coro->Args)) {
+                case CoroWaiting:
+                    /* Park it unless the object was signalled meanwhile */
+                    OCTOS_ENTER_CRITICAL();
+                    if (coro->Continuation.Chain != NULL) list_remove(item);
+                    OCTOS_EXIT_CRITICAL();
+                    break;
+                case CoroYielded:
+                    yielded = true;
+                    break;
+                case CoroDelayed:
+                    list_remove(item);
+                    coro_host_add_timer(host, coro);
+                    break;
+                case CoroDone:
+                    list_remove(item);
+                    break;
+            }
+
+            item = next;
+        }
+
+        if (yielded) {
+            task_yield();
+            continue;
+        }
+
+        uint32_t ticks_to_sleep = coro_host_next_timer(host, task_get_tick());
+        if (active_list->Length > 0 && host->PollTicks < ticks_to_sleep)
+            ticks_to_sleep = host->PollTicks;
+
+        if (ticks_to_sleep > 0)
+            task_notify_wait_indexed(taskKERNEL_NOTIFY_INDEX, 0, 0, NULL,
+                                     ticks_to_sleep);
+    }
+}
+
+/* Coroutine Host ------------------------------------------------------------*/
+
+/**
+ * @brief Initialize a coroutine host and create its host task
+ * @param host: Pointer to the coroutine host
+ * @param name: Name of the host task
+ * @param priority: Priority of the host task
+ * @param page_size_in_words: Stack page size shared by all coroutines
+ * @param poll_ticks:
+ *      Period at which coroutines awaiting a CORO_AWAIT() condition are
+ *      polled when nothing wakes the host earlier
+ * @retval true If the host task was created
+ * @retval false Otherwise
+ */
+bool coro_host_init(CoroHost_t *host, const char *name, uint8_t priority,
+                    size_t page_size_in_words, uint32_t poll_ticks) {
+    OCTOS_ASSERT(poll_ticks > 0);
+
+    list_init(&(host->ActiveList));
+    list_init(&(host->TimerList));
+    list_init(&(host->StartList));
+    host->PollTicks = poll_ticks;
+
+    return task_create(&coro_host_thread, host, name, priority,
+                       page_size_in_words, &(host->Task));
+}
+
+/**
+ * @brief Start a coroutine on a host
+ * @note The coroutine record must stay valid until the coroutine is done
+ * @param host: Pointer to the coroutine host
+ * @param coro: Pointer to the coroutine record
+ * @param func: Coroutine function
+ * @param args: Arguments passed to the function
+ * @return None
+ */
+void coro_start(CoroHost_t *host, Coro_t *coro, CoroFunc_t func, void *args) {
+    list_item_init(&(coro->Item));
+    coro->Continuation = (TaskContinuation_t) {.Next = NULL,
+                                               .Chain = NULL,
+                                               .Func = &coro_resume,
+                                               .Task = host->Task};
+    coro->Host = host;
+    coro->Func = func;
+    coro->Args = args;
+    coro->WakeTick = 0;
+    coro->Line = 0;
+
+    OCTOS_ENTER_CRITICAL();
+    list_insert_end(&(host->StartList), &(coro->Item));
+    OCTOS_EXIT_CRITICAL();
+
+    coro_host_wake(host);
+}
+
+/**
+ * @brief Check if a coroutine has been started and is not done yet
+ * @param coro: Pointer to the coroutine record
+ * @retval true If the coroutine is running
+ * @retval false Otherwise
+ */
+bool coro_is_running(Coro_t *coro) {
+    OCTOS_ENTER_CRITICAL();
+    const bool running = list_item_parent(&(coro->Item)) != NULL ||
+                         coro->Continuation.Chain != NULL;
+    OCTOS_EXIT_CRITICAL();
+
+    return running;
+}
+
+/**
+ * @brief Wake a coroutine host so that awaiting coroutines are polled
+ * @note Producers call this after making a condition true to avoid waiting
+ *       for the poll period
+ * @param host: Pointer to the coroutine host
+ * @return None
+ */
+void coro_host_wake(CoroHost_t *host) {
+    if (host->Task == NULL) return;
+    task_notify_indexed(host->Task, taskKERNEL_NOTIFY_INDEX, 0, NoAction);
+}
+
+/**
+ * @brief Wake a coroutine host from an ISR
+ * @param host: Pointer to the coroutine host
+ * @param switch_required:
+ *      Pointer to a boolean indicating if a context switch is required
+ * @return None
+ */
+void coro_host_wake_from_isr(CoroHost_t *host, bool *const switch_required) {
+    task_notify_indexed_from_isr(host->Task, taskKERNEL_NOTIFY_INDEX, 0,
+                                 NoAction, switch_required);
+}
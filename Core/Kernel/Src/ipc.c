@@ -0,0 +1,258 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "Arch/port.h"
+#include "ipc.h"
+#include "list.h"
+#include "sync.h"
+#include "task.h"
+
+#define ipcWAIT_RECV ((uint8_t) 0)  /* Call not yet received by a server */
+#define ipcWAIT_REPLY ((uint8_t) 1) /* Call received, reply not yet sent */
+#define ipcREPLIED ((uint8_t) 2)    /* Response delivered to the caller */
+
+/**
+ * @brief Call in progress, lives on the stack of the caller
+ * @note Pointed to by the WaitContext of the caller until a server receives
+ *       it. The donation is then linked into the server until the reply, the
+ *       server finds the call from it as it is the first member
+ */
+typedef struct IpcCall {
+    TaskDonation_t Donation; /*!< Priority lent to the server handling it */
+    IpcEndpoint_t *Endpoint; /*!< Endpoint called */
+    const void *Request;     /*!< Request of the caller */
+    void *Response;          /*!< Buffer for the response */
+    uint8_t State;           /*!< ipcWAIT_RECV, ipcWAIT_REPLY or ipcREPLIED */
+} IpcCall_t;
+
+/**
+ * @brief Receive in progress, lives on the stack of the server
+ * @note Pointed to by the WaitContext of the server while it is blocked
+ */
+typedef struct IpcRecv {
+    void *Request;       /*!< Buffer for the request */
+    TaskHandle_t Caller; /*!< Caller whose request was delivered */
+} IpcRecv_t;
+
+/* Private Helpers -----------------------------------------------------------*/
+
+/**
+ * @brief Deliver a call to a server
+ * @note The request is copied into the buffer of the server and the server
+ *       runs at the priority of the caller if it is higher, until it replies
+ * @note Must call within scheduler suspension
+ * @param call: Pointer to the call
+ * @param caller: Handle of the calling task
+ * @param server: Handle of the server task
+ * @param request: Buffer of the server for the request
+ * @return None
+ */
+static void ipc_deliver(IpcCall_t *call, TaskHandle_t caller,
+                        TaskHandle_t server, void *request) {
+    if (call->Endpoint->RequestSize > 0)
+        memcpy(request, call->Request, call->Endpoint->RequestSize);
+
+    call->State = ipcWAIT_REPLY;
+    sync_donate_priority(&(call->Donation), caller, server);
+}
+
+/**
+ * @brief Take back the priority donated to the server of a call
+ * @note The server keeps the boosts of the locks it holds and of the other
+ *       calls it serves
+ * @note Must call within scheduler suspension
+ * @param call: Pointer to the call
+ * @return None
+ */
+static void ipc_restore(IpcCall_t *call) {
+    sync_revoke_priority(&(call->Donation));
+}
+
+/**
+ * @brief Find the call of a caller served by the current task
+ * @note Must call within scheduler suspension
+ * @param server: Handle of the current task
+ * @param caller: Handle of the caller
+ * @return Pointer to the call, NULL if the caller no longer waits for a
+ *         reply from the server, e.g. timed out
+ */
+static IpcCall_t *ipc_find_call(TaskHandle_t server, TaskHandle_t caller) {
+    /* Woken by its timeout, an indefinite wait shows as suspended */
+    const TaskState_t state = task_status(caller);
+    if (state != BLOCKED && state != SUSPENDED) return NULL;
+
+    for (TaskDonation_t *donation = server->Donations; donation != NULL;
+         donation = donation->Next) {
+        if (donation->Donor == caller) return (IpcCall_t *) donation;
+    }
+
+    return NULL;
+}
+
+/* Public Methods ------------------------------------------------------------*/
+
+/**
+ * @brief Initialize an IPC endpoint
+ * @param endpoint: Pointer to the endpoint
+ * @param request_size_in_bytes: Size of a request
+ * @param response_size_in_bytes: Size of a response
+ * @return None
+ */
+void ipc_init(IpcEndpoint_t *endpoint, size_t request_size_in_bytes,
+              size_t response_size_in_bytes) {
+    list_init(&(endpoint->Callers));
+    list_init(&(endpoint->Servers));
+    endpoint->RequestSize = request_size_in_bytes;
+    endpoint->ResponseSize = response_size_in_bytes;
+}
+
+/**
+ * @brief Call an IPC endpoint and wait for the reply
+ * @note If a server is waiting, the request is handed to it and the caller
+ *       switches straight to it. Otherwise the call waits for a server,
+ *       highest priority caller first
+ * @note The server runs at least at the priority of the caller until it
+ *       replies
+ * @param endpoint: Pointer to the endpoint
+ * @param request: Pointer to the request
+ * @param response: Buffer for the response (can be NULL)
+ * @param timeout_ticks:
+ *      Timeout in ticks for the whole call, UINT32_MAX waits indefinitely.
+ *      A call always blocks for its reply, so zero fails immediately
+ * @retval true If the reply was received
+ * @retval false If the timeout expired, any later reply is discarded
+ */
+bool ipc_call(IpcEndpoint_t *endpoint, const void *request, void *response,
+              uint32_t timeout_ticks) {
+    if (timeout_ticks == 0) return false;
+
+    TaskHandle_t const current = task_get_current();
+    IpcCall_t call = {.Donation = {.Next = NULL, .Donor = NULL, .Donee = NULL},
+                      .Endpoint = endpoint,
+                      .Request = request,
+                      .Response = response,
+                      .State = ipcWAIT_RECV};
+
+    /* No ISR uses an endpoint, scheduler suspension guards its lists */
+    task_suspend_all();
+
+    current->WaitContext = &call;
+
+    if (endpoint->Servers.Length > 0) {
+        TaskHandle_t server = LIST_ITEM_OWNER(list_tail(&(endpoint->Servers)),
+                                              TCB_t, EventListItem);
+        IpcRecv_t *const recv = (IpcRecv_t *) server->WaitContext;
+
+        list_remove(&(server->EventListItem));
+        ipc_deliver(&call, current, server, recv->Request);
+        recv->Caller = current;
+
+        task_handoff(server);
+        task_remove_and_add_current_to_delayed_list(timeout_ticks);
+    } else {
+        task_add_current_to_event_list(&(endpoint->Callers), timeout_ticks);
+    }
+
+    if (!task_resume_all()) OCTOS_YIELD();
+
+    /* Woken by the reply or by the timeout */
+    task_suspend_all();
+
+    const bool replied = call.State == ipcREPLIED;
+    if (call.State == ipcWAIT_REPLY) ipc_restore(&call);
+    current->WaitContext = NULL;
+
+    task_resume_all();
+
+    return replied;
+}
+
+/**
+ * @brief Receive a call on an IPC endpoint
+ * @note The caller stays blocked until ipc_reply() is called with the
+ *       returned caller handle
+ * @param endpoint: Pointer to the endpoint
+ * @param request: Buffer for the request
+ * @param caller: Pointer to store the handle of the caller
+ * @param timeout_ticks: Timeout in ticks (UINT32_MAX for indefinite wait)
+ * @retval true If a call was received
+ * @retval false If the timeout expired
+ */
+bool ipc_recv(IpcEndpoint_t *endpoint, void *request, TaskHandle_t *caller,
+              uint32_t timeout_ticks) {
+    TaskHandle_t const current = task_get_current();
+    IpcRecv_t recv = {.Request = request, .Caller = NULL};
+
+    task_suspend_all();
+
+    if (endpoint->Callers.Length > 0) {
+        TaskHandle_t client = LIST_ITEM_OWNER(list_tail(&(endpoint->Callers)),
+                                              TCB_t, EventListItem);
+
+        /* The caller stays blocked, now waiting for the reply */
+        list_remove(&(client->EventListItem));
+        ipc_deliver((IpcCall_t *) client->WaitContext, client, current,
+                    request);
+        *caller = client;
+
+        task_resume_all();
+        return true;
+    }
+
+    if (timeout_ticks == 0) {
+        task_resume_all();
+        return false;
+    }
+
+    current->WaitContext = &recv;
+    task_add_current_to_event_list(&(endpoint->Servers), timeout_ticks);
+
+    if (!task_resume_all()) OCTOS_YIELD();
+
+    /* Woken by a call or by the timeout */
+    task_suspend_all();
+    current->WaitContext = NULL;
+    task_resume_all();
+
+    if (recv.Caller == NULL) return false;
+
+    *caller = recv.Caller;
+    return true;
+}
+
+/**
+ * @brief Reply to a call received on an IPC endpoint
+ * @note The response is copied to the caller, which the server switches
+ *       straight to unless it has a lower priority. The priority donated by
+ *       the caller is given back
+ * @param endpoint: Pointer to the endpoint
+ * @param caller: Handle of the caller returned by ipc_recv()
+ * @param response: Pointer to the response
+ * @retval true If the reply was delivered
+ * @retval false If the caller no longer waits for it, e.g. timed out
+ */
+bool ipc_reply(IpcEndpoint_t *endpoint, TaskHandle_t caller,
+               const void *response) {
+    TaskHandle_t const current = task_get_current();
+
+    task_suspend_all();
+
+    IpcCall_t *const call = ipc_find_call(current, caller);
+    if (call == NULL || call->Endpoint != endpoint ||
+        call->State != ipcWAIT_REPLY) {
+        task_resume_all();
+        return false;
+    }
+
+    if (call->Response != NULL && endpoint->ResponseSize > 0)
+        memcpy(call->Response, response, endpoint->ResponseSize);
+
+    ipc_restore(call);
+    call->State = ipcREPLIED;
+
+    task_handoff(caller);
+
+    task_resume_all();
+
+    return true;
+}
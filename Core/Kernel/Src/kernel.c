@@ -1,6 +1,6 @@
 #include <stdbool.h>
 
-#include "Arch/stm32f4xx/Inc/api.h"
+#include "Arch/port.h"
 #include "Kernel/Inc/utils.h"
 #include "kernel.h"
 #include "task.h"
@@ -16,14 +16,25 @@ Quanta_t *kernel_quanta = &kernel_quanta_internal;
  */
 void kernel_launch(Quanta_t *quanta) {
     task_lists_init();
+    futex_init();
+    task_create_defined();
 
     OCTOS_SETUP_INTPRI();
+#if OCTOS_CRITICAL_PROFILING
+    OCTOS_SETUP_CYCLE_COUNTER();
+#endif
 
     kernel_quanta_internal.Value = quanta->Value;
     kernel_quanta_internal.Unit = quanta->Unit;
     OCTOS_SETUP_SYSTICK(quanta);
+#if OCTOS_HRTIMER
+    OCTOS_SETUP_HRTIMER();
+#endif
 
     OCTOS_ENABLE_SYSTICK();
 
+    /* Start from the highest priority task, not the first one created */
+    task_context_switch();
+
     OCTOS_SCHED_LAUNCH();
 }
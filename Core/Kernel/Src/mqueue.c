@@ -1,6 +1,6 @@
 #include <stdint.h>
 
-#include "Arch/stm32f4xx/Inc/api.h"
+#include "Arch/port.h"
 #include "list.h"
 #include "mqueue.h"
 #include "queue.h"
@@ -9,6 +9,64 @@
 
 /* Private Helpers -----------------------------------------------------------*/
 
+/**
+ * @brief Initialize a waiting list of a message queue
+ * @param list: Pointer to the waiting list
+ * @return None
+ */
+OCTOS_INLINE static inline void
+mqueue_wait_list_init(MsgQueueWaitList_t *list) {
+#if OCTOS_MQUEUE_BUCKETED_WAIT
+    event_list_init(list);
+#else
+    list_init(list);
+#endif
+}
+
+/**
+ * @brief Check if a waiting list of a message queue has no waiter
+ * @param list: Pointer to the waiting list
+ * @retval true If no task waits on the list
+ * @retval false Otherwise
+ */
+OCTOS_INLINE static inline bool
+mqueue_wait_list_is_empty(MsgQueueWaitList_t *list) {
+#if OCTOS_MQUEUE_BUCKETED_WAIT
+    return event_list_is_empty(list);
+#else
+    return list->Length == 0;
+#endif
+}
+
+/**
+ * @brief Block the current task on a waiting list of a message queue
+ * @param list: Pointer to the waiting list
+ * @param ticks_to_wait: The number of ticks to wait
+ * @return None
+ */
+OCTOS_INLINE static inline void mqueue_wait(MsgQueueWaitList_t *list,
+                                            uint32_t ticks_to_wait) {
+#if OCTOS_MQUEUE_BUCKETED_WAIT
+    task_add_current_to_bucketed_list(list, ticks_to_wait);
+#else
+    task_add_current_to_event_list(list, ticks_to_wait);
+#endif
+}
+
+/**
+ * @brief Wake the highest priority task of a waiting list of a message queue
+ * @param list: Pointer to the waiting list
+ * @retval true Woken task has a higher priority than the current task
+ * @retval false Otherwise
+ */
+OCTOS_INLINE static inline bool mqueue_wake(MsgQueueWaitList_t *list) {
+#if OCTOS_MQUEUE_BUCKETED_WAIT
+    return task_remove_highest_priority_from_bucketed_list(list);
+#else
+    return task_remove_highest_priority_from_event_list(list);
+#endif
+}
+
 /**
  * @brief Increment the receive lock counter of a message queue
  * @note The lock counter is capped at the current number of tasks to
@@ -18,8 +76,8 @@
  * @return None
  */
 OCTOS_INLINE static inline void mqueue_rxlock_increment(MsgQueue_t *mqueue,
-                                                        int8_t rxlock) {
-    const uint8_t current_number_of_tasks = task_get_number_of_tasks();
+                                                        int16_t rxlock) {
+    const uint16_t current_number_of_tasks = task_get_number_of_tasks();
     /* Cap lock counter at current_number_of_tasks
      *
      * But why?
@@ -28,8 +86,8 @@ OCTOS_INLINE static inline void mqueue_rxlock_increment(MsgQueue_t *mqueue,
      * numof(blocked task) < numof(current number of tasks), it is not 
      * necessary to let lock counter goes beyond current_number_of_tasks
      * */
-    if ((uint8_t) rxlock < current_number_of_tasks) {
-        OCTOS_ASSERT(rxlock < INT8_MAX);
+    if ((uint16_t) rxlock < current_number_of_tasks) {
+        OCTOS_ASSERT(rxlock < INT16_MAX);
         mqueue->RxLock = rxlock + 1;
     }
 }
@@ -43,8 +101,8 @@ OCTOS_INLINE static inline void mqueue_rxlock_increment(MsgQueue_t *mqueue,
  * @return None
  */
 OCTOS_INLINE static inline void mqueue_txlock_increment(MsgQueue_t *mqueue,
-                                                        int8_t txlock) {
-    const uint8_t current_number_of_tasks = task_get_number_of_tasks();
+                                                        int16_t txlock) {
+    const uint16_t current_number_of_tasks = task_get_number_of_tasks();
     /* Cap lock counter at current_number_of_tasks
      *
      * But why?
@@ -53,8 +111,8 @@ OCTOS_INLINE static inline void mqueue_txlock_increment(MsgQueue_t *mqueue,
      * numof(blocked task) < numof(current number of tasks), it is not 
      * necessary to let lock counter goes beyond current_number_of_tasks
      * */
-    if ((uint8_t) txlock < current_number_of_tasks) {
-        OCTOS_ASSERT(txlock < INT8_MAX);
+    if ((uint16_t) txlock < current_number_of_tasks) {
+        OCTOS_ASSERT(txlock < INT16_MAX);
         mqueue->TxLock = txlock + 1;
     }
 }
@@ -85,12 +143,12 @@ OCTOS_INLINE static inline void mqueue_lock(MsgQueue_t *mqueue) {
 static void mqueue_unlock(MsgQueue_t *mqueue) {
     OCTOS_ENTER_CRITICAL();
 
-    int8_t rxlock = mqueue->RxLock;
-    List_t *const sender_list = &(mqueue->SenderList);
+    int16_t rxlock = mqueue->RxLock;
+    MsgQueueWaitList_t *const sender_list = &(mqueue->SenderList);
     while (rxlock > queueLOCKED_UNMODIFIED) {
-        if (sender_list->Length > 0) {
+        if (!mqueue_wait_list_is_empty(sender_list)) {
             /* The function will automatically set yield_pending for us */
-            task_remove_highest_priority_from_event_list(sender_list);
+            mqueue_wake(sender_list);
         } else {
             break;
         }
@@ -102,12 +160,12 @@ static void mqueue_unlock(MsgQueue_t *mqueue) {
 
     OCTOS_ENTER_CRITICAL();
 
-    int8_t txlock = mqueue->TxLock;
-    List_t *const reciever_list = &(mqueue->ReceiverList);
+    int16_t txlock = mqueue->TxLock;
+    MsgQueueWaitList_t *const reciever_list = &(mqueue->ReceiverList);
     while (txlock > queueLOCKED_UNMODIFIED) {
-        if (reciever_list->Length > 0) {
+        if (!mqueue_wait_list_is_empty(reciever_list)) {
             /* The function will automatically set yield_pending for us */
-            task_remove_highest_priority_from_event_list(reciever_list);
+            mqueue_wake(reciever_list);
         } else {
             break;
         }
@@ -131,8 +189,9 @@ static void mqueue_unlock(MsgQueue_t *mqueue) {
 void mqueue_init(MsgQueue_t *mqueue, void *buffer, size_t item_size_in_bytes,
                  size_t max_size) {
     queue_init(&mqueue->Queue, buffer, item_size_in_bytes, max_size);
-    list_init(&mqueue->SenderList);
-    list_init(&mqueue->ReceiverList);
+    mqueue_wait_list_init(&mqueue->SenderList);
+    mqueue_wait_list_init(&mqueue->ReceiverList);
+    mqueue->Continuations = NULL;
     mqueue->RxLock = queueUNLOCKED;
     mqueue->TxLock = queueUNLOCKED;
 }
@@ -156,9 +215,8 @@ bool mqueue_send(MsgQueue_t *mqueue, const void *item, uint32_t timeout_ticks) {
         OCTOS_ENTER_CRITICAL();
 
         if (queue_send(&mqueue->Queue, item)) {
-            const bool switch_required =
-                    task_remove_highest_priority_from_event_list(
-                            &(mqueue->ReceiverList));
+            bool switch_required = mqueue_wake(&(mqueue->ReceiverList));
+            task_continuation_fire(&(mqueue->Continuations), &switch_required);
             OCTOS_EXIT_CRITICAL();
             if (switch_required) OCTOS_YIELD();
             return true;
@@ -189,8 +247,7 @@ bool mqueue_send(MsgQueue_t *mqueue, const void *item, uint32_t timeout_ticks) {
 
         /* Timeout has not expired */
         if (queue_is_full(&(mqueue->Queue))) {
-            task_add_current_to_event_list(&(mqueue->SenderList),
-                                           timeout_ticks);
+            mqueue_wait(&(mqueue->SenderList), timeout_ticks);
             mqueue_unlock(mqueue);
             if (!task_resume_all()) OCTOS_YIELD();
         } else {
@@ -219,9 +276,8 @@ bool mqueue_recv(MsgQueue_t *mqueue, void *buffer, uint32_t timeout_ticks) {
         OCTOS_ENTER_CRITICAL();
 
         if (queue_recv(&mqueue->Queue, buffer)) {
-            const bool switch_required =
-                    task_remove_highest_priority_from_event_list(
-                            &mqueue->SenderList);
+            bool switch_required = mqueue_wake(&mqueue->SenderList);
+            task_continuation_fire(&(mqueue->Continuations), &switch_required);
             OCTOS_EXIT_CRITICAL();
             if (switch_required) OCTOS_YIELD();
             return true;
@@ -252,8 +308,7 @@ bool mqueue_recv(MsgQueue_t *mqueue, void *buffer, uint32_t timeout_ticks) {
 
         /* Timeout has not expired */
         if (queue_is_empty(&(mqueue->Queue))) {
-            task_add_current_to_event_list(&(mqueue->ReceiverList),
-                                           timeout_ticks);
+            mqueue_wait(&(mqueue->ReceiverList), timeout_ticks);
             mqueue_unlock(mqueue);
             if (!task_resume_all()) OCTOS_YIELD();
         } else {
@@ -281,16 +336,16 @@ bool mqueue_send_from_isr(MsgQueue_t *mqueue, const void *item,
 
     const bool success = queue_send(&mqueue->Queue, item);
     if (success) {
-        const int8_t txlock = mqueue->TxLock;
+        const int16_t txlock = mqueue->TxLock;
         if (txlock == queueUNLOCKED) {
             const bool higher_priority_woken =
-                    task_remove_highest_priority_from_event_list(
-                            &(mqueue->ReceiverList));
+                    mqueue_wake(&(mqueue->ReceiverList));
             if (switch_required != NULL)
                 *switch_required = higher_priority_woken;
         } else {
             mqueue_txlock_increment(mqueue, txlock);
         }
+        task_continuation_fire(&(mqueue->Continuations), switch_required);
     }
 
     OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
@@ -317,17 +372,17 @@ bool mqueue_recv_from_isr(MsgQueue_t *mqueue, void *buffer,
 
     const bool success = queue_recv(&mqueue->Queue, buffer);
     if (success) {
-        const int8_t rxlock = mqueue->RxLock;
+        const int16_t rxlock = mqueue->RxLock;
         if (rxlock == queueUNLOCKED) {
             const bool higher_priority_woken =
-                    task_remove_highest_priority_from_event_list(
-                            &(mqueue->SenderList));
+                    mqueue_wake(&(mqueue->SenderList));
             if (switch_required != NULL) {
                 *switch_required = higher_priority_woken;
             }
         } else {
             mqueue_rxlock_increment(mqueue, rxlock);
         }
+        task_continuation_fire(&(mqueue->Continuations), switch_required);
     }
 
     OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
@@ -0,0 +1,201 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "Arch/port.h"
+#include "profile.h"
+
+#if OCTOS_CRITICAL_PROFILING
+
+#define profileBUCKET_SHIFT 6
+#define profileBUCKET_FACTOR_SHIFT 2
+
+/* Entries are claimed unmasked, their counters are only written with
+ * interrupts masked, the outermost section is unique */
+static CriticalSite_t critical_sites[OCTOS_CRITICAL_PROFILING_SITES];
+static uint32_t critical_dropped = 0;
+static CriticalSite_t *critical_enter_site = NULL;
+static bool critical_entered = false;
+static uint32_t critical_enter_cycles = 0;
+
+/* Private Helpers -----------------------------------------------------------*/
+
+/**
+ * @brief Get the histogram bucket of a duration
+ * @param cycles: Masked duration in cycles
+ * @return Index of the bucket
+ */
+static size_t profile_critical_bucket(uint32_t cycles) {
+    cycles >>= profileBUCKET_SHIFT;
+    if (cycles == 0) return 0;
+
+    const size_t bucket =
+            (31 - __builtin_clz(cycles)) / profileBUCKET_FACTOR_SHIFT + 1;
+    return bucket < OCTOS_CRITICAL_PROFILING_BUCKETS
+                   ? bucket
+                   : OCTOS_CRITICAL_PROFILING_BUCKETS - 1;
+}
+
+/**
+ * @brief Strip the directories of a source file path
+ * @param file: Source file path
+ * @return Pointer to the file name within the path
+ */
+static const char *profile_basename(const char *file) {
+    const char *const slash = strrchr(file, '/');
+    return slash != NULL ? slash + 1 : file;
+}
+
+/* Critical Section Profiling ------------------------------------------------*/
+
+/**
+ * @brief Find or claim the profile entry of a call site
+ * @note Called by the port before interrupts are masked, so the lookup is
+ *       not part of the masked duration. Probing starts at the entry hashed
+ *       from the line, an entry is claimed by an exclusive store of its line
+ *       as ISRs may look up meanwhile
+ * @param file: Source file of the call site
+ * @param line: Source line of the call site
+ * @return Pointer to the entry, NULL if the table is full or the entry is
+ *         still being claimed by a preempted lookup
+ */
+CriticalSite_t *profile_critical_site(const char *file, uint32_t line) {
+    size_t index = line % OCTOS_CRITICAL_PROFILING_SITES;
+
+    for (size_t i = 0; i < OCTOS_CRITICAL_PROFILING_SITES; i++) {
+        CriticalSite_t *const site = &critical_sites[index];
+        if (++index == OCTOS_CRITICAL_PROFILING_SITES) index = 0;
+
+        uint32_t site_line;
+        do {
+            site_line = OCTOS_LDREX(&(site->Line));
+            if (site_line != 0) {
+                OCTOS_CLREX();
+                break;
+            }
+        } while (!OCTOS_STREX(&(site->Line), line));
+
+        if (site_line == 0) {
+            *(const char *volatile *) &(site->File) = file;
+            return site;
+        }
+        if (site_line != line) continue;
+
+        /* Sites in headers get one __FILE__ literal per translation unit */
+        const char *const site_file = *(const char *volatile *) &(site->File);
+        if (site_file == NULL) return NULL;
+        if (site_file == file || strcmp(site_file, file) == 0) return site;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Record the start of an outermost critical section
+ * @note Called by the port with interrupts already masked
+ * @param site: Entry of the call site from profile_critical_site()
+ * @return None
+ */
+void profile_critical_enter(CriticalSite_t *site) {
+    critical_enter_site = site;
+    critical_entered = true;
+    critical_enter_cycles = OCTOS_CYCLE_COUNTER();
+}
+
+/**
+ * @brief Record the end of an outermost critical section
+ * @note Called by the port before interrupts are unmasked, only the cycle
+ *       delta is added to the entry resolved on entry
+ * @return None
+ */
+void profile_critical_exit(void) {
+    const uint32_t cycles = OCTOS_CYCLE_COUNTER() - critical_enter_cycles;
+
+    if (!critical_entered) return;
+    critical_entered = false;
+
+    CriticalSite_t *const site = critical_enter_site;
+    if (site == NULL) {
+        critical_dropped++;
+        return;
+    }
+
+    site->Count++;
+    site->TotalCycles += cycles;
+    if (cycles > site->MaxCycles) site->MaxCycles = cycles;
+    site->Histogram[profile_critical_bucket(cycles)]++;
+}
+
+/**
+ * @brief Clear every recorded critical section profile
+ * @return None
+ */
+void profile_critical_reset(void) {
+    OCTOS_ENTER_CRITICAL();
+
+    memset(critical_sites, 0, sizeof(critical_sites));
+    critical_dropped = 0;
+
+    OCTOS_EXIT_CRITICAL();
+}
+
+/**
+ * @brief Print the critical section profiles into a buffer
+ * @note Each site is copied out under a short critical section, formatting
+ *       happens with interrupts enabled
+ * @param buffer: Buffer to print into
+ * @param size: Size of the buffer in bytes
+ * @return Number of characters written, excluding the terminator
+ */
+size_t profile_critical_report(char *buffer, size_t size) {
+    if (buffer == NULL || size == 0) return 0;
+
+    size_t offset = 0;
+    int written =
+            snprintf(buffer, size, "Site\t\t\tCount\tMax\tMean\tHist\n\r");
+    if (written > 0) offset += (size_t) written;
+
+    for (size_t i = 0; i < OCTOS_CRITICAL_PROFILING_SITES && offset < size;
+         i++) {
+        CriticalSite_t site;
+
+        OCTOS_ENTER_CRITICAL();
+        site = critical_sites[i];
+        OCTOS_EXIT_CRITICAL();
+
+        if (site.File == NULL || site.Count == 0) continue;
+
+        written = snprintf(buffer + offset, size - offset,
+                           "%-16s:%-4lu\t%lu\t%lu\t%lu\t",
+                           profile_basename(site.File),
+                           (unsigned long) site.Line,
+                           (unsigned long) site.Count,
+                           (unsigned long) site.MaxCycles,
+                           (unsigned long) (site.TotalCycles / site.Count));
+        if (written < 0) break;
+        offset += (size_t) written;
+
+        for (size_t b = 0; b < OCTOS_CRITICAL_PROFILING_BUCKETS; b++) {
+            const bool last = (b + 1 == OCTOS_CRITICAL_PROFILING_BUCKETS);
+
+            if (offset >= size) break;
+            written = snprintf(buffer + offset, size - offset, "%lu%s",
+                               (unsigned long) site.Histogram[b],
+                               last ? "\n\r" : "/");
+            if (written < 0) break;
+            offset += (size_t) written;
+        }
+    }
+
+    if (offset < size && critical_dropped > 0) {
+        written = snprintf(buffer + offset, size - offset,
+                           "Dropped (table full)\t%lu\n\r",
+                           (unsigned long) critical_dropped);
+        if (written > 0) offset += (size_t) written;
+    }
+
+    return offset < size ? offset : size - 1;
+}
+
+#endif
@@ -1,6 +1,7 @@
 #include <stdint.h>
 
-#include "Arch/stm32f4xx/Inc/api.h"
+#include "Arch/port.h"
+#include "clock.h"
 #include "list.h"
 #include "sync.h"
 #include "task.h"
@@ -12,6 +13,7 @@
  */
 OCTOS_INLINE static inline void sync_core_init(SyncCore_t *core) {
     list_init(&(core->BlockedList));
+    core->Continuations = NULL;
     core->Lock = syncUNLOCKED;
 }
 
@@ -36,8 +38,8 @@ OCTOS_INLINE static inline void sync_lock(SyncCore_t *core) {
  * @return None
  */
 OCTOS_INLINE static inline void sync_lock_increment(SyncCore_t *core,
-                                                    int8_t lock) {
-    const uint8_t current_number_of_tasks = task_get_number_of_tasks();
+                                                    int16_t lock) {
+    const uint16_t current_number_of_tasks = task_get_number_of_tasks();
     /* Cap lock counter at current_number_of_tasks
      *
      * But why?
@@ -46,8 +48,8 @@ OCTOS_INLINE static inline void sync_lock_increment(SyncCore_t *core,
      * numof(blocked task) < numof(current number of tasks), it is not 
      * necessary to let lock counter goes beyond current_number_of_tasks
      * */
-    if ((uint8_t) lock < current_number_of_tasks) {
-        OCTOS_ASSERT(lock < INT8_MAX);
+    if ((uint16_t) lock < current_number_of_tasks) {
+        OCTOS_ASSERT(lock < INT16_MAX);
         core->Lock = lock + 1;
     }
 }
@@ -61,7 +63,7 @@ OCTOS_INLINE static inline void sync_lock_increment(SyncCore_t *core,
 OCTOS_INLINE static inline void sync_unlock(SyncCore_t *core) {
     OCTOS_ENTER_CRITICAL();
 
-    int8_t lock = core->Lock;
+    int16_t lock = core->Lock;
     List_t *const blocked_list = &(core->BlockedList);
     while (lock > syncLOCKED_UNMODIFIED) {
         if (blocked_list->Length > 0) {
@@ -119,6 +121,23 @@ OCTOS_INLINE static inline void sync_notify_all(SyncCore_t *core,
     if (switch_required != NULL) *switch_required |= higher_priority_woken;
 }
 
+/**
+ * @brief Wake all tasks waiting on a synchronization core
+ * @note The core is locked while waiters are moved out one per critical
+ *       section, which bounds each masked interval but not the whole wake.
+ *       Notifications from ISRs meanwhile are delivered by sync_unlock. The
+ *       context switch is left to task_resume_all()
+ * @note Must call within scheduler suspension
+ * @param core: Pointer to the synchronization core
+ * @return None
+ */
+OCTOS_INLINE static inline void sync_wake_all(SyncCore_t *core) {
+    sync_lock(core);
+    /* The function will automatically set yield_pending for us */
+    task_remove_all_from_event_list(&(core->BlockedList));
+    sync_unlock(core);
+}
+
 /** 
  * @brief Notify a single task waiting on a synchronization core from an ISR
  * @note If the core is unlocked, a task will be notified. If locked, the
@@ -130,7 +149,7 @@ OCTOS_INLINE static inline void sync_notify_all(SyncCore_t *core,
  */
 OCTOS_INLINE static inline void
 sync_notify_from_isr(SyncCore_t *core, bool *const switch_required) {
-    const int8_t lock = core->Lock;
+    const int16_t lock = core->Lock;
 
     if (core->Lock == syncUNLOCKED) {
         const bool higher_priority_woken =
@@ -153,7 +172,7 @@ sync_notify_from_isr(SyncCore_t *core, bool *const switch_required) {
  */
 OCTOS_INLINE static inline void
 sync_notify_all_from_isr(SyncCore_t *core, bool *const switch_required) {
-    const int8_t lock = core->Lock;
+    const int16_t lock = core->Lock;
     List_t *const blocked_list = &(core->BlockedList);
 
     if (core->Lock == syncUNLOCKED) {
@@ -185,8 +204,55 @@ void sema_init(Sema_t *sema, int32_t initial_count) {
     sync_core_init(&(sema->Core));
 }
 
+/**
+ * @brief Try to take a semaphore count without masking interrupts
+ * @param sema: Pointer to the semaphore
+ * @retval true If a count was taken
+ * @retval false If no count is available
+ */
+OCTOS_INLINE static inline bool sema_try_acquire_fast(Sema_t *sema) {
+    volatile uint32_t *const count = (volatile uint32_t *) &(sema->Count);
+    int32_t value;
+
+    do {
+        value = (int32_t) OCTOS_LDREX(count);
+        if (value <= 0) {
+            OCTOS_CLREX();
+            return false;
+        }
+    } while (!OCTOS_STREX(count, (uint32_t) (value - 1)));
+
+    return true;
+}
+
+/**
+ * @brief Try to give back a semaphore count without masking interrupts
+ * @note Only succeeds if no task is waiting on the semaphore
+ * @param sema: Pointer to the semaphore
+ * @retval true If the count was given back
+ * @retval false If a waiter has to be notified
+ */
+OCTOS_INLINE static inline bool sema_try_release_fast(Sema_t *sema) {
+    volatile uint32_t *const count = (volatile uint32_t *) &(sema->Count);
+    int32_t value;
+
+    do {
+        value = (int32_t) OCTOS_LDREX(count);
+        if (sema->Core.BlockedList.Length > 0 ||
+            sema->Core.Continuations != NULL ||
+            sema->Core.Lock != syncUNLOCKED) {
+            OCTOS_CLREX();
+            return false;
+        }
+    } while (!OCTOS_STREX(count, (uint32_t) (value + 1)));
+
+    return true;
+}
+
 /**
  * @brief Acquires a semaphore
+ * @note An available count is taken with exclusive load/store, only an
+ *       empty semaphore falls into the blocking path
  * @param sema: Pointer to the semaphore to be acquired
  * @param timeout_ticks: Maximum time to wait for the semaphore
  * @retval true If the semaphore is acquired
@@ -196,12 +262,13 @@ bool sema_acquire(Sema_t *sema, uint32_t timeout_ticks) {
     Timeout_t timeout;
     bool timeout_set = false;
 
+    if (sema_try_acquire_fast(sema)) return true;
+
     while (true) {
         OCTOS_ENTER_CRITICAL();
 
-        if (!timeout_set) sema->Count--;
-
-        if (sema->Count >= 0) {
+        if (sema->Count > 0) {
+            sema->Count--;
             OCTOS_EXIT_CRITICAL();
             return true;
         }
@@ -230,7 +297,7 @@ bool sema_acquire(Sema_t *sema, uint32_t timeout_ticks) {
         }
 
         /* Timeout has not expired */
-        if (sema->Count < 0) {
+        if (sema->Count <= 0) {
             task_add_current_to_event_list(&(core->BlockedList), timeout_ticks);
             sync_unlock(core);
             if (!task_resume_all()) OCTOS_YIELD();
@@ -243,20 +310,20 @@ bool sema_acquire(Sema_t *sema, uint32_t timeout_ticks) {
 
 /**
  * @brief Releases a semaphore
+ * @note Without waiters the count is given back with exclusive load/store
  * @param sema: Pointer to the semaphore to be released
  * @return None
  */
 void sema_release(Sema_t *sema) {
     bool switch_required = false;
 
+    if (sema_try_release_fast(sema)) return;
+
     OCTOS_ENTER_CRITICAL();
 
     sema->Count++;
-    if (sema->Count > 0) {
-        OCTOS_EXIT_CRITICAL();
-        return;
-    }
     sync_notify(&(sema->Core), &switch_required);
+    task_continuation_fire(&(sema->Core.Continuations), &switch_required);
 
     OCTOS_EXIT_CRITICAL();
 
@@ -299,13 +366,8 @@ void sema_release_from_isr(Sema_t *sema, bool *const switch_required) {
     uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
 
     sema->Count++;
-
-    if (sema->Count > 0) {
-        OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
-        return;
-    }
-
     sync_notify_from_isr(&(sema->Core), switch_required);
+    task_continuation_fire(&(sema->Core.Continuations), switch_required);
 
     OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
 }
@@ -319,14 +381,308 @@ void sema_release_from_isr(Sema_t *sema, bool *const switch_required) {
   */
 void mutex_init(Mutex_t *mutex) {
     mutex->Owner = NULL;
+    mutex->NextHeld = NULL;
+    mutex->Protocol = MutexInherit;
+    mutex->Ceiling = 0;
     sync_core_init(&(mutex->Core));
 }
 
+/**
+  * @brief Initialize a mutex using the immediate priority ceiling protocol
+  * @note The owner is raised to the ceiling as soon as it acquires the
+  *       mutex, so the ceiling must be at least the root priority of every
+  *       task that uses the mutex
+  * @param mutex Pointer to mutex structure
+  * @param ceiling Ceiling priority of the mutex
+  * @return None
+  */
+void mutex_init_ceiling(Mutex_t *mutex, uint8_t ceiling) {
+    OCTOS_ASSERT(ceiling < OCTOS_MAX_PRIORITIES);
+    mutex_init(mutex);
+    mutex->Protocol = MutexCeiling;
+    mutex->Ceiling = ceiling;
+}
+
+/**
+ * @brief Get the highest priority of the tasks waiting on a mutex
+ * @note Must call within critical section
+ * @param mutex: Pointer to the mutex
+ * @return The highest waiter priority, or 0 if there is no waiter
+ */
+OCTOS_INLINE static inline uint8_t mutex_waiter_priority(Mutex_t *mutex) {
+    List_t *const blocked_list = &(mutex->Core.BlockedList);
+    if (blocked_list->Length == 0) return 0;
+
+    /* Event list is sorted by priority, tail is the highest */
+    return list_item_get_value(list_tail(blocked_list));
+}
+
+/**
+ * @brief Get the highest priority of the tasks waiting on a reader-writer lock
+ * @note Must call within critical section
+ * @param rwlock: Pointer to the reader-writer lock
+ * @return The highest waiter priority, or 0 if there is no waiter
+ */
+OCTOS_INLINE static inline uint8_t rwlock_waiter_priority(RwLock_t *rwlock) {
+    List_t *const reader_list = &(rwlock->ReaderCore.BlockedList);
+    List_t *const writer_list = &(rwlock->WriterCore.BlockedList);
+    uint8_t priority = 0;
+
+    /* Event lists are sorted by priority, tail is the highest */
+    if (reader_list->Length > 0)
+        priority = list_item_get_value(list_tail(reader_list));
+    if (writer_list->Length > 0 &&
+        list_item_get_value(list_tail(writer_list)) > priority)
+        priority = list_item_get_value(list_tail(writer_list));
+
+    return priority;
+}
+
+/**
+ * @brief Link a mutex into the held chain of its owner
+ * @note The link is published with a single store, so the chain can be
+ *       walked by a preempting task at any point
+ * @param owner: Pointer to the TCB of the mutex owner
+ * @param mutex: Pointer to the mutex
+ * @return None
+ */
+OCTOS_INLINE static inline void mutex_link(TaskHandle_t owner,
+                                           Mutex_t *mutex) {
+    mutex->NextHeld = owner->HeldMutexes;
+    OCTOS_DSB();
+    owner->HeldMutexes = mutex;
+}
+
+/**
+ * @brief Unlink a mutex from the held chain of its owner
+ * @note Mutexes need not be released in order of acquisition
+ * @param owner: Pointer to the TCB of the mutex owner
+ * @param mutex: Pointer to the mutex
+ * @return None
+ */
+OCTOS_INLINE static inline void mutex_unlink(TaskHandle_t owner,
+                                             Mutex_t *mutex) {
+    Mutex_t **link = &(owner->HeldMutexes);
+    while (*link != mutex) link = &((*link)->NextHeld);
+    *link = mutex->NextHeld;
+    OCTOS_DSB();
+}
+
+/**
+ * @brief Compute the priority a lock owner should run at
+ * @note The result is the highest of the owner's root priority, the
+ *       ceilings of the mutexes it holds, the priorities of the tasks
+ *       waiting on the mutexes and reader-writer locks it holds and the
+ *       priorities donated to it. Every priority change of a lock owner is
+ *       derived from it, so that one protocol never drops a boost lent by
+ *       another
+ * @note Must call within critical section
+ * @param owner: Pointer to the TCB of the lock owner
+ * @return The priority the owner should run at
+ */
+static uint8_t sync_owner_priority(TaskHandle_t owner) {
+    uint8_t priority = owner->RootPriority;
+
+    for (Mutex_t *held = owner->HeldMutexes; held != NULL;
+         held = held->NextHeld) {
+        if (held->Protocol == MutexCeiling && held->Ceiling > priority)
+            priority = held->Ceiling;
+
+        const uint8_t waiter_priority = mutex_waiter_priority(held);
+        if (waiter_priority > priority) priority = waiter_priority;
+    }
+
+    for (RwLockHold_t *hold = owner->HeldRwLocks; hold != NULL;
+         hold = hold->NextHeld) {
+        const uint8_t waiter_priority = rwlock_waiter_priority(hold->Lock);
+        if (waiter_priority > priority) priority = waiter_priority;
+    }
+
+    for (TaskDonation_t *donation = owner->Donations; donation != NULL;
+         donation = donation->Next) {
+        if (donation->Donor->Priority > priority)
+            priority = donation->Donor->Priority;
+    }
+
+    return priority;
+}
+
+static void sync_propagate_priority(TaskBlockedOn_t type, void *lock,
+                                    size_t depth);
+
+/**
+ * @brief Set a lock owner to the priority it should run at
+ * @note If the owner is itself blocked on a lock, the change is propagated
+ *       to the owners of that lock, see sync_propagate_priority
+ * @note Must call within critical section
+ * @param owner: Pointer to the TCB of the lock owner, can be NULL
+ * @param floor: Priority the owner must at least run at
+ * @param depth: Number of locks already walked along the chain
+ * @retval true Context switch is required
+ * @retval false Context switch is not required
+ */
+static bool sync_update_owner(TaskHandle_t owner, uint8_t floor,
+                              size_t depth) {
+    if (owner == NULL || depth >= OCTOS_MUTEX_CHAIN_DEPTH) return false;
+
+    uint8_t priority = sync_owner_priority(owner);
+    if (floor > priority) priority = floor;
+    if (priority == owner->Priority) return false;
+
+    const bool switch_required = task_set_effective_priority(owner, priority);
+    sync_propagate_priority(owner->BlockedOnType, owner->BlockedOn, depth + 1);
+
+    return switch_required;
+}
+
+/**
+ * @brief Propagate priority changes along a chain of blocked lock owners
+ * @note The owners of the given lock are set to the priority computed by
+ *       sync_owner_priority. If an owner is itself blocked on a lock, the
+ *       owners of that lock are updated next, up to OCTOS_MUTEX_CHAIN_DEPTH
+ *       locks deep. Every reader of a reader-writer lock is followed, a
+ *       donation leads to its donee
+ * @note Must call within critical section
+ * @param type: Kind of the lock
+ * @param lock: Pointer to the lock
+ * @param depth: Number of locks already walked along the chain
+ * @return None
+ */
+static void sync_propagate_priority(TaskBlockedOn_t type, void *lock,
+                                    size_t depth) {
+    if (type == BlockedOnMutex) {
+        Mutex_t *const mutex = lock;
+        /* The mutex may not be linked into the owner's chain yet (or any
+         * more) while the owner is inside a fast path */
+        sync_update_owner(mutex->Owner, mutex_waiter_priority(mutex), depth);
+    } else if (type == BlockedOnRwLock) {
+        RwLock_t *const rwlock = lock;
+        sync_update_owner(rwlock->Write.Owner, 0, depth);
+        for (RwLockHold_t *hold = rwlock->Readers; hold != NULL;
+             hold = hold->NextReader) {
+            sync_update_owner(hold->Owner, 0, depth);
+        }
+    } else if (type == BlockedOnDonation) {
+        sync_update_owner(((TaskDonation_t *) lock)->Donee, 0, depth);
+    }
+}
+
+/**
+ * @brief Set a lock owner to the priority it should run at
+ * @note Must call within critical section
+ * @param owner: Pointer to the TCB of the lock owner
+ * @retval true Context switch is required
+ * @retval false Context switch is not required
+ */
+OCTOS_INLINE static inline bool sync_update_priority(TaskHandle_t owner) {
+    return sync_update_owner(owner, 0, 0);
+}
+
+/**
+ * @brief Record the lock a task is blocked on
+ * @note A priority change of the task is propagated to the lock owners
+ * @note Must call within critical section
+ * @param task: Pointer to the TCB of the task
+ * @param type: Kind of the lock, BlockedOnNone if not blocked
+ * @param lock: Pointer to the lock, NULL if not blocked
+ * @return None
+ */
+OCTOS_INLINE static inline void sync_set_blocked_on(TaskHandle_t task,
+                                                    TaskBlockedOn_t type,
+                                                    void *lock) {
+    task->BlockedOnType = type;
+    task->BlockedOn = lock;
+}
+
+/**
+ * @brief Take ownership of a free mutex for the current task
+ * @note The owner is raised to the ceiling of a ceiling mutex, or to the
+ *       highest priority still waiting on the mutex
+ * @note Must call within critical section
+ * @param mutex: Pointer to the mutex
+ * @return None
+ */
+OCTOS_INLINE static inline void mutex_take(Mutex_t *mutex) {
+    TaskHandle_t const owner = task_mutex_held_increment();
+
+    OCTOS_ASSERT(mutex->Protocol != MutexCeiling ||
+                 owner->RootPriority <= mutex->Ceiling);
+
+    mutex->Owner = owner;
+    mutex_link(owner, mutex);
+    sync_set_blocked_on(owner, BlockedOnNone, NULL);
+
+    sync_update_priority(owner);
+}
+
+/**
+ * @brief Try to take a free mutex without masking interrupts
+ * @note Only priority inheritance mutexes have a fast path, a ceiling mutex
+ *       always changes the owner priority
+ * @param mutex: Pointer to the mutex
+ * @retval true If the mutex was taken
+ * @retval false If the slow path is required
+ */
+OCTOS_INLINE static inline bool mutex_try_acquire_fast(Mutex_t *mutex) {
+    if (mutex->Protocol != MutexInherit) return false;
+
+    void *volatile *const owner_word = (void *volatile *) &(mutex->Owner);
+    TaskHandle_t const current = task_get_current();
+
+    do {
+        if (OCTOS_LDREX_PTR(owner_word) != NULL) {
+            OCTOS_CLREX();
+            return false;
+        }
+    } while (!OCTOS_STREX_PTR(owner_word, current));
+
+    /* A task blocking on the mutex before it is linked still boosts us,
+     * see sync_propagate_priority */
+    task_mutex_held_increment();
+    mutex_link(current, mutex);
+
+    return true;
+}
+
+/**
+ * @brief Try to release a mutex nobody waits on without masking interrupts
+ * @note The mutex is unlinked before the exclusive pair, a waiter showing up
+ *       in between either fails the store or is seen by the check, in which
+ *       case the mutex is linked back and the slow path is taken
+ * @param mutex: Pointer to the mutex
+ * @retval true If the mutex was released
+ * @retval false If the slow path is required
+ */
+OCTOS_INLINE static inline bool mutex_try_release_fast(Mutex_t *mutex) {
+    TaskHandle_t const current = task_get_current();
+    if (mutex->Protocol != MutexInherit || mutex->Owner != current)
+        return false;
+
+    void *volatile *const owner_word = (void *volatile *) &(mutex->Owner);
+
+    mutex_unlink(current, mutex);
+    do {
+        (void) OCTOS_LDREX_PTR(owner_word);
+        if (mutex->Core.BlockedList.Length > 0 ||
+            mutex->Core.Lock != syncUNLOCKED) {
+            OCTOS_CLREX();
+            mutex_link(current, mutex);
+            return false;
+        }
+    } while (!OCTOS_STREX_PTR(owner_word, NULL));
+
+    task_mutex_held_decrement(current);
+
+    return true;
+}
+
 /**
  * @brief Acquire a mutex with a specified timeout
+ * @note A free priority inheritance mutex is taken with exclusive
+ *       load/store, only contention falls into the blocking path
  * @note This function blocks the current task if the mutex is already 
  *       owned by another task
- * @note Will perform priority inheritance if needed
+ * @note Will perform transitive priority inheritance if needed
  * @param mutex: Pointer to the mutex to be acquired
  * @param timeout_ticks: 
  *      Timeout value in ticks, 0 for no wait, UINT32_MAX for indefinite wait
@@ -336,12 +692,13 @@ void mutex_init(Mutex_t *mutex) {
 bool mutex_acquire(Mutex_t *mutex, uint32_t timeout_ticks) {
     Timeout_t timeout;
     bool timeout_set = false;
-    bool inheritance_occured = false;
+
+    if (mutex_try_acquire_fast(mutex)) return true;
 
     while (true) {
         OCTOS_ENTER_CRITICAL();
         if (mutex->Owner == NULL) {
-            mutex->Owner = task_mutex_held_increment();
+            mutex_take(mutex);
             OCTOS_EXIT_CRITICAL();
             return true;
         }
@@ -365,37 +722,26 @@ bool mutex_acquire(Mutex_t *mutex, uint32_t timeout_ticks) {
         /* Timeout has expired */
         if (timeout_ticks != UINT32_MAX &&
             task_check_timeout(&timeout, timeout_ticks)) {
-            sync_unlock(core);
-            task_resume_all();
-            return false;
-        }
+            /* We are no longer waiting, undo what we lent to the chain */
+            OCTOS_ENTER_CRITICAL();
+            sync_set_blocked_on(task_get_current(), BlockedOnNone, NULL);
+            sync_propagate_priority(BlockedOnMutex, mutex, 0);
+            OCTOS_EXIT_CRITICAL();
 
-        /* Timeout has expired */
-        if (timeout_ticks != UINT32_MAX &&
-            task_check_timeout(&timeout, timeout_ticks)) {
             sync_unlock(core);
             task_resume_all();
-
-            if (inheritance_occured) {
-                OCTOS_ENTER_CRITICAL();
-                const uint8_t highest_priority_of_waiting_tasks =
-                        list_item_get_value(list_tail(&(core->BlockedList)));
-                task_deinherit_priority_after_timeout(
-                        mutex->Owner, highest_priority_of_waiting_tasks);
-                OCTOS_EXIT_CRITICAL();
-            }
-
             return false;
         }
 
         /* Timeout has not expired */
-        TCB_t *const owner = mutex->Owner;
-        if (owner != NULL) {
+        if (mutex->Owner != NULL) {
+            task_add_current_to_event_list(&(core->BlockedList), timeout_ticks);
+
             OCTOS_ENTER_CRITICAL();
-            inheritance_occured = task_inherit_priority(owner);
+            sync_set_blocked_on(task_get_current(), BlockedOnMutex, mutex);
+            sync_propagate_priority(BlockedOnMutex, mutex, 0);
             OCTOS_EXIT_CRITICAL();
 
-            task_add_current_to_event_list(&(core->BlockedList), timeout_ticks);
             sync_unlock(core);
             if (!task_resume_all()) OCTOS_YIELD();
         } else {
@@ -405,27 +751,51 @@ bool mutex_acquire(Mutex_t *mutex, uint32_t timeout_ticks) {
     }
 }
 
+/**
+ * @brief Give up a mutex owned by the current task
+ * @note The owner drops to the highest priority still required by the
+ *       mutexes it keeps holding, and the highest priority waiter is woken
+ * @note Must call within critical section
+ * @param mutex: Pointer to the mutex
+ * @param switch_required:
+ *      Pointer to a boolean flag indicating if a context switch is required
+ * @retval true If the mutex was given up
+ * @retval false Current task is not the mutex owner
+ */
+static bool mutex_give(Mutex_t *mutex, bool *const switch_required) {
+    TCB_t *const owner = mutex->Owner;
+    if (!task_mutex_held_decrement(owner)) return false;
+
+    mutex_unlink(owner, mutex);
+    mutex->Owner = NULL;
+
+    *switch_required |= sync_update_priority(owner);
+    sync_notify(&(mutex->Core), switch_required);
+
+    return true;
+}
+
 /**
  * @brief Release a mutex
  * @note This function should be called when a task is done with the mutex
+ * @note The owner drops to the highest priority still required by the
+ *       mutexes it keeps holding
  * @param mutex: Pointer to the mutex to be released
- * @retval true If a context switch is required
- * @retval false Otherwise
+ * @retval true If the mutex was released
+ * @retval false Current task is not the mutex owner
  */
 bool mutex_release(Mutex_t *mutex) {
     bool switch_required = false;
 
+    if (mutex_try_release_fast(mutex)) return true;
+
     OCTOS_ENTER_CRITICAL();
 
-    if (!task_mutex_held_decrement(mutex->Owner)) {
+    if (!mutex_give(mutex, &switch_required)) {
         OCTOS_EXIT_CRITICAL();
         return false;
     }
 
-    switch_required |= task_deinherit_priority(mutex->Owner);
-    mutex->Owner = NULL;
-    sync_notify(&(mutex->Core), &switch_required);
-
     OCTOS_EXIT_CRITICAL();
 
     if (switch_required) OCTOS_YIELD();
@@ -433,29 +803,131 @@ bool mutex_release(Mutex_t *mutex) {
     return true;
 }
 
-/* Condtion ------------------------------------------------------------------*/
+/* Reader-Writer Lock --------------------------------------------------------*/
 
 /**
- * @brief Initialize a condition variable
- * @param cond Pointer to the condition variable to initialize
+ * @brief Check if a read lock can be granted
+ * @note Readers are held off while any writer is waiting (writer preference)
+ * @param rwlock: Pointer to the reader-writer lock
+ * @retval true If a read lock can be granted
+ * @retval false Otherwise
+ */
+OCTOS_INLINE static inline bool rwlock_can_read(RwLock_t *rwlock) {
+    return rwlock->Write.Owner == NULL && rwlock->WritersWaiting == 0;
+}
+
+/**
+ * @brief Check if a write lock can be granted
+ * @param rwlock: Pointer to the reader-writer lock
+ * @retval true If a write lock can be granted
+ * @retval false Otherwise
+ */
+OCTOS_INLINE static inline bool rwlock_can_write(RwLock_t *rwlock) {
+    return rwlock->Write.Owner == NULL && rwlock->Readers == NULL;
+}
+
+/**
+ * @brief Take a hold of a reader-writer lock for the current task
+ * @note The hold is linked into the chain of its owner, so that tasks
+ *       waiting on the lock count towards the owner priority
+ * @note Must call within critical section
+ * @param hold: Pointer to the hold, its lock already set
  * @return None
  */
-void cond_init(Cond_t *cond) { sync_core_init(&(cond->Core)); }
+OCTOS_INLINE static inline void rwlock_take(RwLockHold_t *hold) {
+    TaskHandle_t const owner = task_mutex_held_increment();
+
+    hold->Owner = owner;
+    hold->NextHeld = owner->HeldRwLocks;
+    owner->HeldRwLocks = hold;
+    sync_set_blocked_on(owner, BlockedOnNone, NULL);
+}
 
 /**
- * @brief Wait on a condition variable
- * @note If the timeout expires, the function returns false
- * @param cond: Pointer to the condition variable
- * @param timeout_ticks: Timeout in ticks (UINT32_MAX for indefinite wait)
- * @retval true Condition was signaled
- * @retval false Timeout expired
+ * @brief Give up a hold of a reader-writer lock
+ * @note The owner drops to the highest priority still required by the locks
+ *       it keeps holding
+ * @note Must call within critical section
+ * @param hold: Pointer to the hold
+ * @retval true Context switch is required
+ * @retval false Context switch is not required
  */
-bool cond_wait(Cond_t *cond, uint32_t timeout_ticks) {
+static bool rwlock_give(RwLockHold_t *hold) {
+    TaskHandle_t const owner = hold->Owner;
+
+    RwLockHold_t **link = &(owner->HeldRwLocks);
+    while (*link != hold) link = &((*link)->NextHeld);
+    *link = hold->NextHeld;
+    hold->Owner = NULL;
+
+    return sync_update_priority(owner);
+}
+
+/**
+ * @brief Notify the tasks that may proceed after the lock state changed
+ * @note If a writer is waiting, only a writer is woken once the last reader
+ *       has left. Otherwise all blocked readers are woken
+ * @note Must call within critical section
+ * @param rwlock: Pointer to the reader-writer lock
+ * @param switch_required:
+ *      Pointer to a boolean flag indicating if a context switch is required
+ * @return None
+ */
+static void rwlock_notify(RwLock_t *rwlock, bool *const switch_required) {
+    if (rwlock->WritersWaiting > 0) {
+        if (rwlock->Readers == NULL)
+            sync_notify(&(rwlock->WriterCore), switch_required);
+    } else {
+        sync_notify_all(&(rwlock->ReaderCore), switch_required);
+    }
+}
+
+/**
+ * @brief Initialize a reader-writer lock
+ * @param rwlock: Pointer to the reader-writer lock structure
+ * @return None
+ */
+void rwlock_init(RwLock_t *rwlock) {
+    rwlock->Write.Owner = NULL;
+    rwlock->Write.Lock = rwlock;
+    rwlock->Write.NextReader = NULL;
+    rwlock->Write.NextHeld = NULL;
+    rwlock->Readers = NULL;
+    rwlock->WritersWaiting = 0;
+    sync_core_init(&(rwlock->ReaderCore));
+    sync_core_init(&(rwlock->WriterCore));
+}
+
+/**
+ * @brief Acquire a reader-writer lock for reading
+ * @note Any number of tasks may hold the read lock at the same time, each
+ *       through its own hold. The hold must stay valid until the matching
+ *       rwlock_read_release()
+ * @note The read lock is not recursive, a task holding it must not acquire
+ *       it again while a writer may be waiting
+ * @note Will perform priority inheritance if needed
+ * @param rwlock: Pointer to the reader-writer lock to be acquired
+ * @param hold: Pointer to the read hold of the caller
+ * @param timeout_ticks:
+ *      Timeout value in ticks, 0 for no wait, UINT32_MAX for indefinite wait
+ * @retval true If the read lock was acquired
+ * @retval false Otherwise
+ */
+bool rwlock_read_acquire(RwLock_t *rwlock, RwLockHold_t *hold,
+                         uint32_t timeout_ticks) {
     Timeout_t timeout;
     bool timeout_set = false;
 
     while (true) {
         OCTOS_ENTER_CRITICAL();
+        if (rwlock_can_read(rwlock)) {
+            hold->Lock = rwlock;
+            hold->NextReader = rwlock->Readers;
+            rwlock->Readers = hold;
+            rwlock_take(hold);
+            OCTOS_EXIT_CRITICAL();
+            return true;
+        }
 
         if (timeout_ticks == 0) {
             OCTOS_EXIT_CRITICAL();
@@ -464,68 +936,446 @@ bool cond_wait(Cond_t *cond, uint32_t timeout_ticks) {
             /* timeout_ticks == UINT32_MAX means to wait indefinitely */
             if (timeout_ticks != UINT32_MAX) task_set_timeout(&timeout);
             timeout_set = true;
-        } else {
-            OCTOS_EXIT_CRITICAL();
-            return true;
         }
 
         OCTOS_EXIT_CRITICAL();
 
         task_suspend_all();
-        SyncCore_t *const core = &(cond->Core);
+        SyncCore_t *const core = &(rwlock->ReaderCore);
         /* Lock the queue so ISR cannot modify EventListItem */
         sync_lock(core);
+
         /* Timeout has expired */
         if (timeout_ticks != UINT32_MAX &&
             task_check_timeout(&timeout, timeout_ticks)) {
+            /* We are no longer waiting, undo what we lent to the owners */
+            OCTOS_ENTER_CRITICAL();
+            sync_set_blocked_on(task_get_current(), BlockedOnNone, NULL);
+            sync_propagate_priority(BlockedOnRwLock, rwlock, 0);
+            OCTOS_EXIT_CRITICAL();
+
             sync_unlock(core);
             task_resume_all();
             return false;
         }
 
         /* Timeout has not expired */
-        task_add_current_to_event_list(&(core->BlockedList), timeout_ticks);
-        sync_unlock(core);
-        if (!task_resume_all()) OCTOS_YIELD();
+        if (!rwlock_can_read(rwlock)) {
+            task_add_current_to_event_list(&(core->BlockedList), timeout_ticks);
+
+            OCTOS_ENTER_CRITICAL();
+            sync_set_blocked_on(task_get_current(), BlockedOnRwLock, rwlock);
+            sync_propagate_priority(BlockedOnRwLock, rwlock, 0);
+            OCTOS_EXIT_CRITICAL();
+
+            sync_unlock(core);
+            if (!task_resume_all()) OCTOS_YIELD();
+        } else {
+            sync_unlock(core);
+            task_resume_all();
+        }
     }
 }
 
 /**
- * @brief Notify one task waiting on the condition variable
- * @param cond: Pointer to the condition variable
- * @return None
+ * @brief Release a read lock held by the current task
+ * @param rwlock: Pointer to the reader-writer lock to be released
+ * @param hold: Pointer to the read hold passed to rwlock_read_acquire()
+ * @retval true If the read lock was released
+ * @retval false Current task does not hold the read lock through the hold
  */
-void cond_notify(Cond_t *cond) {
+bool rwlock_read_release(RwLock_t *rwlock, RwLockHold_t *hold) {
     bool switch_required = false;
 
     OCTOS_ENTER_CRITICAL();
 
-    sync_notify(&(cond->Core), &switch_required);
+    if (hold->Lock != rwlock || hold->Owner != task_get_current() ||
+        !task_mutex_held_decrement(hold->Owner)) {
+        OCTOS_EXIT_CRITICAL();
+        return false;
+    }
+
+    RwLockHold_t **link = &(rwlock->Readers);
+    while (*link != hold) link = &((*link)->NextReader);
+    *link = hold->NextReader;
+
+    switch_required |= rwlock_give(hold);
+    rwlock_notify(rwlock, &switch_required);
 
     OCTOS_EXIT_CRITICAL();
 
     if (switch_required) OCTOS_YIELD();
+
+    return true;
 }
 
 /**
- * @brief Notify all tasks waiting on the condition variable
- * @param cond: Pointer to the condition variable
- * @return None
+ * @brief Acquire a reader-writer lock for writing
+ * @note A waiting writer holds off new readers, so writers are not starved
+ *       by a continuous stream of readers
+ * @note Will perform priority inheritance if needed
+ * @param rwlock: Pointer to the reader-writer lock to be acquired
+ * @param timeout_ticks:
+ *      Timeout value in ticks, 0 for no wait, UINT32_MAX for indefinite wait
+ * @retval true If the write lock was acquired
+ * @retval false Otherwise
  */
-void cond_notify_all(Cond_t *cond) {
-    bool switch_required = false;
-
-    OCTOS_ENTER_CRITICAL();
+bool rwlock_write_acquire(RwLock_t *rwlock, uint32_t timeout_ticks) {
+    Timeout_t timeout;
+    bool timeout_set = false;
 
-    sync_notify_all(&(cond->Core), &switch_required);
+    while (true) {
+        OCTOS_ENTER_CRITICAL();
+        if (rwlock_can_write(rwlock)) {
+            rwlock_take(&(rwlock->Write));
+            if (timeout_set) rwlock->WritersWaiting--;
+            OCTOS_EXIT_CRITICAL();
+            return true;
+        }
+
+        if (timeout_ticks == 0) {
+            OCTOS_EXIT_CRITICAL();
+            return false;
+        } else if (!timeout_set) {
+            /* timeout_ticks == UINT32_MAX means to wait indefinitely */
+            if (timeout_ticks != UINT32_MAX) task_set_timeout(&timeout);
+            timeout_set = true;
+            rwlock->WritersWaiting++;
+        }
+
+        OCTOS_EXIT_CRITICAL();
+
+        task_suspend_all();
+        SyncCore_t *const core = &(rwlock->WriterCore);
+        /* Lock the queue so ISR cannot modify EventListItem */
+        sync_lock(core);
+
+        /* Timeout has expired */
+        if (timeout_ticks != UINT32_MAX &&
+            task_check_timeout(&timeout, timeout_ticks)) {
+            OCTOS_ENTER_CRITICAL();
+            /* Pass the wakeup on, the lock may have been freed for us */
+            rwlock->WritersWaiting--;
+            if (rwlock->Write.Owner == NULL) rwlock_notify(rwlock, NULL);
+            /* We are no longer waiting, undo what we lent to the owners */
+            sync_set_blocked_on(task_get_current(), BlockedOnNone, NULL);
+            sync_propagate_priority(BlockedOnRwLock, rwlock, 0);
+            OCTOS_EXIT_CRITICAL();
+
+            sync_unlock(core);
+            task_resume_all();
+            return false;
+        }
+
+        /* Timeout has not expired */
+        if (!rwlock_can_write(rwlock)) {
+            task_add_current_to_event_list(&(core->BlockedList), timeout_ticks);
+
+            OCTOS_ENTER_CRITICAL();
+            sync_set_blocked_on(task_get_current(), BlockedOnRwLock, rwlock);
+            sync_propagate_priority(BlockedOnRwLock, rwlock, 0);
+            OCTOS_EXIT_CRITICAL();
+
+            sync_unlock(core);
+            if (!task_resume_all()) OCTOS_YIELD();
+        } else {
+            sync_unlock(core);
+            task_resume_all();
+        }
+    }
+}
+
+/**
+ * @brief Release a write lock held by the current task
+ * @param rwlock: Pointer to the reader-writer lock to be released
+ * @retval true If the write lock was released
+ * @retval false Current task does not hold the write lock
+ */
+bool rwlock_write_release(RwLock_t *rwlock) {
+    bool switch_required = false;
+
+    OCTOS_ENTER_CRITICAL();
+
+    if (!task_mutex_held_decrement(rwlock->Write.Owner)) {
+        OCTOS_EXIT_CRITICAL();
+        return false;
+    }
+
+    switch_required |= rwlock_give(&(rwlock->Write));
+    rwlock_notify(rwlock, &switch_required);
+
+    OCTOS_EXIT_CRITICAL();
+
+    if (switch_required) OCTOS_YIELD();
+
+    return true;
+}
+
+/* Condtion ------------------------------------------------------------------*/
+
+/**
+ * @brief Take the highest priority waiter off a condition variable
+ * @note A waiter of cond_wait_mutex is moved straight onto the mutex's
+ *       BlockedList if the mutex is owned, instead of being woken only to
+ *       block on the mutex again (wait morphing). The owner wakes it when it
+ *       releases the mutex. A free mutex has nobody to release it, so its
+ *       waiters are woken
+ * @note The waiter learns that it was notified from its cleared WaitContext
+ * @note Must call within critical section
+ * @param cond: Pointer to the condition variable
+ * @param switch_required:
+ *      Pointer to a boolean flag indicating if a context switch is required
+ * @retval true If a waiter was taken off the condition variable
+ * @retval false If there was no waiter
+ */
+static bool cond_wake_one(Cond_t *cond, bool *const switch_required) {
+    List_t *const blocked_list = &(cond->Core.BlockedList);
+    if (blocked_list->Length == 0) return false;
+
+    TCB_t *const owner =
+            LIST_ITEM_OWNER(list_tail(blocked_list), TCB_t, EventListItem);
+    Mutex_t *const mutex =
+            owner->WaitContext != cond ? (Mutex_t *) owner->WaitContext : NULL;
+    owner->WaitContext = NULL;
+
+    if (mutex != NULL && mutex->Owner != NULL) {
+        ListItem_t *const item = &(owner->EventListItem);
+        list_remove(item);
+        list_insert(&(mutex->Core.BlockedList), item);
+        sync_set_blocked_on(owner, BlockedOnMutex, mutex);
+        sync_propagate_priority(BlockedOnMutex, mutex, 0);
+    } else {
+        const bool higher_priority_woken = task_remove_from_event_list(owner);
+        if (switch_required != NULL) *switch_required |= higher_priority_woken;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Wake the highest priority waiter of a condition variable from an ISR
+ * @note Mutex waiters are woken rather than requeued, because the mutex's
+ *       BlockedList may be in the middle of an update by the interrupted task
+ * @note Must call within critical section
+ * @param cond: Pointer to the condition variable
+ * @param switch_required:
+ *      Pointer to a boolean flag indicating if a context switch is required
+ * @retval true If a waiter was woken
+ * @retval false If there was no waiter
+ */
+static bool cond_wake_one_from_isr(Cond_t *cond, bool *const switch_required) {
+    List_t *const blocked_list = &(cond->Core.BlockedList);
+    if (blocked_list->Length == 0) return false;
+
+    TCB_t *const owner =
+            LIST_ITEM_OWNER(list_tail(blocked_list), TCB_t, EventListItem);
+    owner->WaitContext = NULL;
+
+    const bool higher_priority_woken = task_remove_from_event_list(owner);
+    if (switch_required != NULL) *switch_required |= higher_priority_woken;
+
+    return true;
+}
+
+/**
+ * @brief Unlocks the synchronization core of a condition variable
+ * @note Notifications issued by ISRs while the core was locked are
+ *       delivered here
+ * @note Must call within scheduler suspension
+ * @param cond: Pointer to the condition variable to be unlocked
+ * @return None
+ */
+OCTOS_INLINE static inline void cond_unlock(Cond_t *cond) {
+    OCTOS_ENTER_CRITICAL();
+
+    /* The function will automatically set yield_pending for us */
+    for (int16_t lock = cond->Core.Lock; lock > syncLOCKED_UNMODIFIED;
+         lock--) {
+        if (!cond_wake_one(cond, NULL)) break;
+    }
+    cond->Core.Lock = syncUNLOCKED;
+
+    OCTOS_EXIT_CRITICAL();
+}
+
+/**
+ * @brief Initialize a condition variable
+ * @param cond Pointer to the condition variable to initialize
+ * @return None
+ */
+void cond_init(Cond_t *cond) { sync_core_init(&(cond->Core)); }
+
+/**
+ * @brief Wait on a condition variable
+ * @note If the timeout expires, the function returns false
+ * @param cond: Pointer to the condition variable
+ * @param timeout_ticks: Timeout in ticks (UINT32_MAX for indefinite wait)
+ * @retval true Condition was signaled
+ * @retval false Timeout expired
+ */
+bool cond_wait(Cond_t *cond, uint32_t timeout_ticks) {
+    Timeout_t timeout;
+    bool timeout_set = false;
+    TaskHandle_t const current = task_get_current();
+
+    while (true) {
+        OCTOS_ENTER_CRITICAL();
+
+        if (timeout_set && current->WaitContext == NULL) {
+            OCTOS_EXIT_CRITICAL();
+            return true;
+        }
+
+        if (timeout_ticks == 0) {
+            OCTOS_EXIT_CRITICAL();
+            return false;
+        } else if (!timeout_set) {
+            /* timeout_ticks == UINT32_MAX means to wait indefinitely */
+            if (timeout_ticks != UINT32_MAX) task_set_timeout(&timeout);
+            timeout_set = true;
+        }
+
+        current->WaitContext = cond;
+
+        OCTOS_EXIT_CRITICAL();
+
+        task_suspend_all();
+        SyncCore_t *const core = &(cond->Core);
+        /* Lock the queue so ISR cannot modify EventListItem */
+        sync_lock(core);
+        /* Timeout has expired */
+        if (timeout_ticks != UINT32_MAX &&
+            task_check_timeout(&timeout, timeout_ticks)) {
+            current->WaitContext = NULL;
+            cond_unlock(cond);
+            task_resume_all();
+            return false;
+        }
+
+        /* Timeout has not expired */
+        task_add_current_to_event_list(&(core->BlockedList), timeout_ticks);
+        cond_unlock(cond);
+        if (!task_resume_all()) OCTOS_YIELD();
+    }
+}
+
+/**
+ * @brief Release a mutex and wait on a condition variable atomically
+ * @note The mutex must be owned by the current task. It is released and the
+ *       task blocks on the condition variable without any notification
+ *       being able to slip in between
+ * @note The mutex is always owned again when this function returns. The
+ *       timeout only applies to the wait on the condition variable
+ * @param cond: Pointer to the condition variable
+ * @param mutex: Pointer to the mutex protecting the condition
+ * @param timeout_ticks: Timeout in ticks (UINT32_MAX for indefinite wait)
+ * @retval true Condition was signaled
+ * @retval false Timeout expired
+ */
+bool cond_wait_mutex(Cond_t *cond, Mutex_t *mutex, uint32_t timeout_ticks) {
+    Timeout_t timeout;
+    bool mutex_held = true;
+    bool notified = false;
+    TaskHandle_t const current = task_get_current();
+
+    OCTOS_ASSERT(mutex->Owner == current);
+
+    if (timeout_ticks == 0) return false;
+    /* timeout_ticks == UINT32_MAX means to wait indefinitely */
+    if (timeout_ticks != UINT32_MAX) task_set_timeout(&timeout);
+
+    while (true) {
+        task_suspend_all();
+        SyncCore_t *const core = &(cond->Core);
+        /* Lock the queue so ISR cannot modify EventListItem */
+        sync_lock(core);
+
+        OCTOS_ENTER_CRITICAL();
+        notified = !mutex_held && current->WaitContext == NULL;
+        OCTOS_EXIT_CRITICAL();
+
+        if (notified || (timeout_ticks != UINT32_MAX &&
+                         task_check_timeout(&timeout, timeout_ticks))) {
+            current->WaitContext = NULL;
+            cond_unlock(cond);
+            task_resume_all();
+            break;
+        }
+
+        OCTOS_ENTER_CRITICAL();
+        /* Tell notifiers which mutex to requeue us on */
+        current->WaitContext = mutex;
+        if (mutex_held) {
+            bool switch_required = false;
+            mutex_give(mutex, &switch_required);
+            mutex_held = false;
+        }
+        OCTOS_EXIT_CRITICAL();
+
+        task_add_current_to_event_list(&(core->BlockedList), timeout_ticks);
+        cond_unlock(cond);
+        if (!task_resume_all()) OCTOS_YIELD();
+    }
+
+    /* Possibly already queued on the mutex by the notifier */
+    if (!mutex_held) {
+        /* Running again, so no longer blocked on the mutex */
+        OCTOS_ENTER_CRITICAL();
+        sync_set_blocked_on(current, BlockedOnNone, NULL);
+        OCTOS_EXIT_CRITICAL();
+
+        mutex_acquire(mutex, UINT32_MAX);
+    }
+
+    return notified;
+}
+
+/**
+ * @brief Notify one task waiting on the condition variable
+ * @param cond: Pointer to the condition variable
+ * @return None
+ */
+void cond_notify(Cond_t *cond) {
+    bool switch_required = false;
+
+    OCTOS_ENTER_CRITICAL();
+
+    cond_wake_one(cond, &switch_required);
 
     OCTOS_EXIT_CRITICAL();
 
     if (switch_required) OCTOS_YIELD();
 }
 
+/**
+ * @brief Notify all tasks waiting on the condition variable
+ * @note Waiters of cond_wait_mutex are requeued onto the mutex while it is
+ *       owned, and woken to race for it while it is free
+ * @param cond: Pointer to the condition variable
+ * @return None
+ */
+void cond_notify_all(Cond_t *cond) {
+    task_suspend_all();
+    /* Lock the core so ISR cannot modify EventListItem */
+    sync_lock(&(cond->Core));
+
+    /* One waiter per critical section, the scheduler suspension keeps the
+     * wake atomic for tasks. The function will automatically set
+     * yield_pending for us */
+    bool woken = true;
+    while (woken) {
+        OCTOS_ENTER_CRITICAL();
+        woken = cond_wake_one(cond, NULL);
+        OCTOS_EXIT_CRITICAL();
+    }
+
+    cond_unlock(cond);
+    task_resume_all();
+}
+
 /**
  * @brief Notify one task waiting on the condition variable from an ISR
+ * @note Waiters are always woken, never requeued onto a mutex
  * @param cond: Pointer to the condition variable
  * @param switch_required:
  *      Pointer to a boolean indicating if a context switch is required
@@ -543,13 +1393,19 @@ void cond_notify_from_isr(Cond_t *cond, bool *const switch_required) {
         return;
     }
 
-    sync_notify_from_isr(&(cond->Core), switch_required);
+    const int16_t lock = core->Lock;
+    if (lock == syncUNLOCKED) {
+        cond_wake_one_from_isr(cond, switch_required);
+    } else {
+        sync_lock_increment(core, lock);
+    }
 
     OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
 }
 
 /**
  * @brief Notify all tasks waiting on the condition variable from an ISR
+ * @note Waiters are always woken, never requeued onto a mutex
  * @param cond: Pointer to the condition variable
  * @param switch_required:
  *      Pointer to a boolean indicating if a context switch is required
@@ -567,60 +1423,729 @@ void cond_notify_all_from_isr(Cond_t *cond, bool *const switch_required) {
         return;
     }
 
-    sync_notify_all_from_isr(&(cond->Core), switch_required);
+    const int16_t lock = core->Lock;
+    if (lock == syncUNLOCKED) {
+        while (cond_wake_one_from_isr(cond, switch_required));
+    } else {
+        for (size_t i = blocked_list->Length; i > 0; i--) {
+            sync_lock_increment(core, lock);
+        }
+    }
+
+    OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+}
+
+
+/* Barrier -------------------------------------------------------------------*/
+
+/**
+ * @brief Initialize a barrier
+ * @param barrier: Pointer to the barrier to initialize
+ * @param parties: Number of parties required to release the barrier
+ * @return None
+ */
+void barrier_init(Barrier_t *barrier, uint32_t parties) {
+    barrier->Parties = parties;
+    barrier->Count = 0;
+    barrier->Round = 0;
+    sync_core_init(&(barrier->Core));
+}
+
+/**
+ * @brief Wait at the barrier
+ * @note If the timeout expires, the function returns false and the task no
+ *       longer counts as arrived
+ * @param barrier: Pointer to the barrier
+ * @param timeout_ticks: Timeout in ticks (UINT32_MAX for indefinite wait)
+ * @retval true Barrier was released
+ * @retval false Timeout expired
+ */
+bool barrier_wait(Barrier_t *barrier, uint32_t timeout_ticks) {
+    OCTOS_ENTER_CRITICAL();
+
+    const uint16_t round = barrier->Round;
+    barrier->Count++;
+
+    if (barrier->Count == barrier->Parties) {
+        barrier->Count = 0;
+        barrier->Round++;
+        /* Suspended before leaving the critical section, so that no task
+         * arrives for the next round before this one is released */
+        task_suspend_all();
+        OCTOS_EXIT_CRITICAL();
+
+        sync_wake_all(&(barrier->Core));
+        task_resume_all();
+        return true;
+    }
+
+    if (timeout_ticks == 0) {
+        barrier->Count--;
+        OCTOS_EXIT_CRITICAL();
+        return false;
+    }
+
+    /* timeout_ticks == UINT32_MAX means to wait indefinitely */
+    Timeout_t timeout;
+    if (timeout_ticks != UINT32_MAX) task_set_timeout(&timeout);
+
+    OCTOS_EXIT_CRITICAL();
+
+    SyncCore_t *const core = &(barrier->Core);
+
+    while (true) {
+        task_suspend_all();
+        /* Lock the queue so ISR cannot modify EventListItem */
+        sync_lock(core);
+
+        OCTOS_ENTER_CRITICAL();
+
+        const bool released = barrier->Round != round;
+        const bool expired = !released && timeout_ticks != UINT32_MAX &&
+                             task_check_timeout(&timeout, timeout_ticks);
+        if (expired) barrier->Count--;
+
+        OCTOS_EXIT_CRITICAL();
+
+        if (released || expired) {
+            sync_unlock(core);
+            task_resume_all();
+            return released;
+        }
+
+        task_add_current_to_event_list(&(core->BlockedList), timeout_ticks);
+        sync_unlock(core);
+        if (!task_resume_all()) OCTOS_YIELD();
+    }
+}
+
+/**
+ * @brief Reset the barrier
+ * @param barrier: Pointer to the barrier
+ * @return None
+ */
+void barrier_reset(Barrier_t *barrier) {
+    task_suspend_all();
+
+    OCTOS_ENTER_CRITICAL();
+    barrier->Count = 0;
+    barrier->Round++;
+    OCTOS_EXIT_CRITICAL();
+
+    sync_wake_all(&(barrier->Core));
+    task_resume_all();
+}
+
+/** 
+ * @brief Reset a barrier from an ISR context
+ * @note This function is used to reset a barrier and unblock all tasks
+ *       waiting on it. 
+ *       If the barrier is unlocked, tasks are moved to the ready list.
+ *       If the barrier is locked, the lock count is incremented for
+ *       each blocked task.
+ * @param barrier: Pointer to the barrier to be reset
+ * @param switch_required:
+ *      Pointer to a boolean that indicates if a context switch is required
+ * @return None
+ */
+void barrier_reset_from_isr(Barrier_t *barrier, bool *const switch_required) {
+    OCTOS_ASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+    uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
+
+    sync_notify_all_from_isr(&(barrier->Core), switch_required);
+    barrier->Count = 0;
+    barrier->Round++;
+
+    OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+}
+
+/* Event ---------------------------------------------------------------------*/
+
+/**
+ * @brief Initialize an event
+ * @param event: Pointer to the Event_t structure to be initialized
+ * @return None
+ */
+void event_init(Event_t *event) {
+    event->Flag = false;
+    sync_core_init(&(event->Core));
+}
+
+/**
+ * @brief Check if an event is set
+ * @param event: Pointer to the Event_t structure to check
+ * @retval true If the event is set
+ * @retval false Otherwise
+ */
+bool event_is_set(Event_t *event) {
+    bool result;
+
+    OCTOS_ENTER_CRITICAL();
+    result = event->Flag;
+    OCTOS_EXIT_CRITICAL();
+
+    return result;
+}
+
+/**
+ * @brief Set an event
+ * @note If the event is set and tasks are blocked on it, they
+ *       will be unblocked
+ * @param event: Pointer to the Event_t structure to set
+ * @return None
+ */
+void event_set(Event_t *event) {
+    OCTOS_ENTER_CRITICAL();
+
+    /* Micro optimization */
+    if (event->Flag == true) {
+        OCTOS_EXIT_CRITICAL();
+        return;
+    }
+
+    OCTOS_EXIT_CRITICAL();
+
+    task_suspend_all();
+
+    OCTOS_ENTER_CRITICAL();
+    const bool was_set = event->Flag;
+    event->Flag = true;
+    /* A woken task sets yield_pending for task_resume_all() */
+    if (!was_set) task_continuation_fire(&(event->Core.Continuations), NULL);
+    OCTOS_EXIT_CRITICAL();
+
+    if (!was_set) sync_wake_all(&(event->Core));
+    task_resume_all();
+}
+
+/**
+ * @brief Clear an event
+ * @param event: Pointer to the Event_t structure to clear
+ * @return None
+ */
+void event_clear(Event_t *event) {
+    OCTOS_ENTER_CRITICAL();
+
+    event->Flag = false;
+
+    OCTOS_EXIT_CRITICAL();
+}
+
+/**
+ * @brief Wait for an event to be set
+ * @note If the event is not set, the calling task will be blocked until
+ *       the event is set or the timeout expires
+ * @param event: Pointer to the Event_t structure to wait on
+ * @param timeout_ticks: Timeout in ticks (UINT32_MAX for indefinite wait)
+ * @retval true If the event was set
+ * @retval false If the timeout expired
+ */
+bool event_wait(Event_t *event, uint32_t timeout_ticks) {
+    Timeout_t timeout;
+    bool timeout_set = false;
+
+    while (true) {
+        OCTOS_ENTER_CRITICAL();
+
+        if (event->Flag == true) {
+            OCTOS_EXIT_CRITICAL();
+            return true;
+        } else if (timeout_ticks == 0) {
+            OCTOS_EXIT_CRITICAL();
+            return false;
+        } else if (!timeout_set) {
+            /* timeout_ticks == UINT32_MAX means to wait indefinitely */
+            if (timeout_ticks != UINT32_MAX) task_set_timeout(&timeout);
+            timeout_set = true;
+        }
+
+        OCTOS_EXIT_CRITICAL();
+
+        task_suspend_all();
+        SyncCore_t *const core = &(event->Core);
+        /* Lock the queue so ISR cannot modify EventListItem */
+        sync_lock(core);
+        /* Timeout has expired */
+        if (timeout_ticks != UINT32_MAX &&
+            task_check_timeout(&timeout, timeout_ticks)) {
+            sync_unlock(core);
+            task_resume_all();
+            return false;
+        }
+
+        /* Timeout has not expired */
+        if (event->Flag != true) {
+            task_add_current_to_event_list(&(core->BlockedList), timeout_ticks);
+            sync_unlock(core);
+            if (!task_resume_all()) OCTOS_YIELD();
+        } else {
+            sync_unlock(core);
+            task_resume_all();
+        }
+    }
+}
+
+/**
+ * @brief Check if an event is set from an ISR
+ * @param event: Pointer to the Event_t structure to check
+ * @retval true If the event is set
+ * @retval false Otherwise
+ */
+bool event_is_set_from_isr(Event_t *event) {
+    OCTOS_ASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+    bool result;
+
+    uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
+    result = event->Flag;
+    OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+
+    return result;
+}
+
+/**
+ * @brief Set an event from an ISR
+ * @note If the event is set and tasks are blocked on it, they will
+ *       be unblocked
+ * @param event: Pointer to the Event_t structure to set
+ * @param switch_required:
+ *      Pointer to a boolean indicating if a context switch is required
+ * @return None
+ */
+void event_set_from_isr(Event_t *event, bool *const switch_required) {
+    OCTOS_ASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+    uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
+
+    if (event->Flag == true) {
+        if (switch_required != NULL) *switch_required = false;
+        OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+        return;
+    }
+
+    event->Flag = true;
+    sync_notify_all_from_isr(&(event->Core), switch_required);
+    task_continuation_fire(&(event->Core.Continuations), switch_required);
+
+    OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+}
+
+/**
+ * @brief Clear an event from an ISR
+ * @param event: Pointer to the Event_t structure to clear
+ * @return None
+ */
+void event_clear_from_isr(Event_t *event) {
+    OCTOS_ASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+    uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
+
+    event->Flag = false;
+
+    OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+}
+
+/* Event Group ---------------------------------------------------------------*/
+
+/**
+ * @brief Check if a wait condition is satisfied by an event flag word
+ * @param current: The current event flag word
+ * @param bits: The bits to wait for
+ * @param wait_all: Whether all bits are required
+ * @retval true If the wait condition is satisfied
+ * @retval false Otherwise
+ */
+OCTOS_INLINE static inline bool
+event_group_satisfied(uint32_t current, uint32_t bits, bool wait_all) {
+    return wait_all ? (current & bits) == bits : (current & bits) != 0;
+}
+
+/**
+ * @brief Wake all tasks whose wait condition is satisfied
+ * @note Every waiter is evaluated against the same flag word in a single
+ *       pass, bits requested with clear on exit are cleared afterwards
+ * @note Must call within critical section
+ * @param group: Pointer to the event group
+ * @param switch_required:
+ *      Pointer to a boolean flag indicating if a context switch is required
+ * @return None
+ */
+static void event_group_evaluate(EventGroup_t *group,
+                                 bool *const switch_required) {
+    bool higher_priority_woken = false;
+    uint32_t bits_to_clear = 0;
+    List_t *const blocked_list = &(group->Core.BlockedList);
+    ListItem_t *item = list_head(blocked_list);
+
+    for (size_t i = blocked_list->Length; i > 0; i--) {
+        ListItem_t *const next = list_item_next(item);
+        TCB_t *const owner = LIST_ITEM_OWNER(item, TCB_t, EventListItem);
+        const uint8_t flags = owner->EventFlags;
+
+        if (event_group_satisfied(group->Bits, owner->EventBits,
+                                  flags & taskEVENT_WAIT_ALL)) {
+            if (flags & taskEVENT_CLEAR_ON_EXIT)
+                bits_to_clear |= owner->EventBits;
+
+            /* Hand over the flag word seen by this pass */
+            owner->EventBits = group->Bits;
+            owner->EventFlags = flags | taskEVENT_DELIVERED;
+            higher_priority_woken |= task_remove_from_event_list(owner);
+        }
+
+        item = next;
+    }
+
+    group->Bits &= ~bits_to_clear;
+
+    if (switch_required != NULL) *switch_required |= higher_priority_woken;
+}
+
+/**
+ * @brief Unlocks the synchronization core of an event group
+ * @note If an ISR set bits while the core was locked, waiters are evaluated
+ *       here instead
+ * @note Must call within scheduler suspension
+ * @param group: Pointer to the event group to be unlocked
+ * @return None
+ */
+OCTOS_INLINE static inline void event_group_unlock(EventGroup_t *group) {
+    OCTOS_ENTER_CRITICAL();
+
+    /* The function will automatically set yield_pending for us */
+    if (group->Core.Lock > syncLOCKED_UNMODIFIED)
+        event_group_evaluate(group, NULL);
+    group->Core.Lock = syncUNLOCKED;
+
+    OCTOS_EXIT_CRITICAL();
+}
+
+/**
+ * @brief Initialize an event group
+ * @param group: Pointer to the EventGroup_t structure to be initialized
+ * @return None
+ */
+void event_group_init(EventGroup_t *group) {
+    group->Bits = 0;
+    sync_core_init(&(group->Core));
+}
+
+/**
+ * @brief Get the current bits of an event group
+ * @param group: Pointer to the EventGroup_t structure
+ * @return The current event flag word
+ */
+uint32_t event_group_get(EventGroup_t *group) {
+    uint32_t result;
+
+    OCTOS_ENTER_CRITICAL();
+    result = group->Bits;
+    OCTOS_EXIT_CRITICAL();
+
+    return result;
+}
+
+/**
+ * @brief Set bits in an event group
+ * @note All tasks whose wait condition becomes satisfied are unblocked
+ * @param group: Pointer to the EventGroup_t structure
+ * @param bits: The bits to set
+ * @return None
+ */
+void event_group_set(EventGroup_t *group, uint32_t bits) {
+    bool switch_required = false;
+
+    OCTOS_ENTER_CRITICAL();
+
+    group->Bits |= bits;
+    event_group_evaluate(group, &switch_required);
+    task_continuation_fire(&(group->Core.Continuations), &switch_required);
+
+    OCTOS_EXIT_CRITICAL();
+
+    if (switch_required) OCTOS_YIELD();
+}
+
+/**
+ * @brief Clear bits in an event group
+ * @param group: Pointer to the EventGroup_t structure
+ * @param bits: The bits to clear
+ * @return The event flag word before the bits were cleared
+ */
+uint32_t event_group_clear(EventGroup_t *group, uint32_t bits) {
+    uint32_t result;
+
+    OCTOS_ENTER_CRITICAL();
+
+    result = group->Bits;
+    group->Bits &= ~bits;
+
+    OCTOS_EXIT_CRITICAL();
+
+    return result;
+}
+
+/**
+ * @brief Wait for bits of an event group to be set
+ * @param group: Pointer to the EventGroup_t structure to wait on
+ * @param bits: The bits to wait for (must not be zero)
+ * @param mode: Wait for any or all of the bits (@ref EventGroupWaitMode_t)
+ * @param clear_on_exit: Clear the waited bits when the wait succeeds
+ * @param buffer:
+ *      Pointer to store the event flag word that satisfied the wait, or the
+ *      current flag word on timeout (can be NULL)
+ * @param timeout_ticks: Timeout in ticks (UINT32_MAX for indefinite wait)
+ * @retval true If the wait condition was satisfied
+ * @retval false If the timeout expired
+ */
+bool event_group_wait(EventGroup_t *group, uint32_t bits,
+                      EventGroupWaitMode_t mode, bool clear_on_exit,
+                      uint32_t *buffer, uint32_t timeout_ticks) {
+    OCTOS_ASSERT(bits != 0);
+
+    Timeout_t timeout;
+    bool timeout_set = false;
+    const bool wait_all = mode == WaitAll;
+    const uint8_t flags = (wait_all ? taskEVENT_WAIT_ALL : 0) |
+                          (clear_on_exit ? taskEVENT_CLEAR_ON_EXIT : 0);
+    uint32_t result;
+
+    while (true) {
+        OCTOS_ENTER_CRITICAL();
+
+        if (timeout_set && task_take_event_bits(&result)) {
+            /* Bits were delivered by the setter, which has already
+             * cleared them if requested */
+            OCTOS_EXIT_CRITICAL();
+            if (buffer != NULL) *buffer = result;
+            return true;
+        }
+
+        result = group->Bits;
+        if (event_group_satisfied(result, bits, wait_all)) {
+            if (clear_on_exit) group->Bits &= ~bits;
+            OCTOS_EXIT_CRITICAL();
+            if (buffer != NULL) *buffer = result;
+            return true;
+        } else if (timeout_ticks == 0) {
+            OCTOS_EXIT_CRITICAL();
+            if (buffer != NULL) *buffer = result;
+            return false;
+        } else if (!timeout_set) {
+            /* timeout_ticks == UINT32_MAX means to wait indefinitely */
+            if (timeout_ticks != UINT32_MAX) task_set_timeout(&timeout);
+            timeout_set = true;
+        }
+
+        OCTOS_EXIT_CRITICAL();
+
+        task_suspend_all();
+        SyncCore_t *const core = &(group->Core);
+        /* Lock the queue so ISR cannot modify EventListItem */
+        sync_lock(core);
+        /* Timeout has expired */
+        if (timeout_ticks != UINT32_MAX &&
+            task_check_timeout(&timeout, timeout_ticks)) {
+            event_group_unlock(group);
+            task_resume_all();
+            if (buffer != NULL) *buffer = event_group_get(group);
+            return false;
+        }
+
+        /* Timeout has not expired */
+        if (!event_group_satisfied(group->Bits, bits, wait_all)) {
+            task_add_current_to_event_group_list(&(core->BlockedList), bits,
+                                                 flags, timeout_ticks);
+            event_group_unlock(group);
+            if (!task_resume_all()) OCTOS_YIELD();
+        } else {
+            event_group_unlock(group);
+            task_resume_all();
+        }
+    }
+}
+
+/**
+ * @brief Get the current bits of an event group from an ISR
+ * @param group: Pointer to the EventGroup_t structure
+ * @return The current event flag word
+ */
+uint32_t event_group_get_from_isr(EventGroup_t *group) {
+    OCTOS_ASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+    uint32_t result;
+
+    uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
+    result = group->Bits;
+    OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+
+    return result;
+}
+
+/**
+ * @brief Set bits in an event group from an ISR
+ * @note If the core is locked, waiters are evaluated when the task holding
+ *       the lock unlocks it
+ * @param group: Pointer to the EventGroup_t structure
+ * @param bits: The bits to set
+ * @param switch_required:
+ *      Pointer to a boolean indicating if a context switch is required
+ * @return None
+ */
+void event_group_set_from_isr(EventGroup_t *group, uint32_t bits,
+                              bool *const switch_required) {
+    OCTOS_ASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+    uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
+
+    group->Bits |= bits;
+
+    const int16_t lock = group->Core.Lock;
+    if (lock == syncUNLOCKED) {
+        event_group_evaluate(group, switch_required);
+    } else {
+        sync_lock_increment(&(group->Core), lock);
+    }
+    task_continuation_fire(&(group->Core.Continuations), switch_required);
+
+    OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+}
+
+/**
+ * @brief Clear bits in an event group from an ISR
+ * @param group: Pointer to the EventGroup_t structure
+ * @param bits: The bits to clear
+ * @return The event flag word before the bits were cleared
+ */
+uint32_t event_group_clear_from_isr(EventGroup_t *group, uint32_t bits) {
+    OCTOS_ASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+    uint32_t result;
+
+    uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
+
+    result = group->Bits;
+    group->Bits &= ~bits;
+
+    OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+
+    return result;
+}
+
+/* Futex ---------------------------------------------------------------------*/
+
+/* Waiters are hashed by address into a small table of shared cores */
+static SyncCore_t futex_buckets[OCTOS_FUTEX_BUCKETS];
+
+/**
+ * @brief Get the synchronization core an address hashes to
+ * @param addr: The address waited on
+ * @return Pointer to the bucket's synchronization core
+ */
+OCTOS_INLINE static inline SyncCore_t *futex_bucket(volatile uint32_t *addr) {
+    return &futex_buckets[((uintptr_t) addr >> 2) % OCTOS_FUTEX_BUCKETS];
+}
+
+/**
+ * @brief Wake up to count tasks waiting on an address in a bucket
+ * @note Waiters are walked from the highest priority downwards
+ * @note Must call within critical section
+ * @param core: Pointer to the bucket's synchronization core
+ * @param addr: The address waited on, NULL to match every waiter
+ * @param count: Maximum number of tasks to wake
+ * @param switch_required:
+ *      Pointer to a boolean flag indicating if a context switch is required
+ * @return Number of tasks woken
+ */
+static size_t futex_wake_bucket(SyncCore_t *core, volatile uint32_t *addr,
+                                size_t count, bool *const switch_required) {
+    bool higher_priority_woken = false;
+    size_t woken = 0;
+    List_t *const blocked_list = &(core->BlockedList);
+    ListItem_t *item = list_item_prev(&(blocked_list->End));
+
+    while (woken < count && item != &(blocked_list->End)) {
+        ListItem_t *const prev = list_item_prev(item);
+        TCB_t *const owner = LIST_ITEM_OWNER(item, TCB_t, EventListItem);
+
+        if (addr == NULL || owner->WaitContext == addr) {
+            /* A cleared context tells the waiter it was woken */
+            owner->WaitContext = NULL;
+            higher_priority_woken |= task_remove_from_event_list(owner);
+            woken++;
+        }
+
+        item = prev;
+    }
+
+    if (switch_required != NULL) *switch_required |= higher_priority_woken;
 
-    OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+    return woken;
 }
 
+/**
+ * @brief Unlocks a futex bucket
+ * @note An ISR cannot tell which waiters it would have woken while the
+ *       bucket was locked, so every waiter of the bucket is woken and
+ *       re-checks its address
+ * @note Must call within scheduler suspension
+ * @param core: Pointer to the bucket's synchronization core
+ * @return None
+ */
+OCTOS_INLINE static inline void futex_unlock(SyncCore_t *core) {
+    OCTOS_ENTER_CRITICAL();
+
+    /* The function will automatically set yield_pending for us */
+    if (core->Lock > syncLOCKED_UNMODIFIED)
+        futex_wake_bucket(core, NULL, SIZE_MAX, NULL);
+    core->Lock = syncUNLOCKED;
 
-/* Barrier -------------------------------------------------------------------*/
+    OCTOS_EXIT_CRITICAL();
+}
 
 /**
- * @brief Initialize a barrier
- * @param barrier: Pointer to the barrier to initialize
- * @param parties: Number of parties required to release the barrier
+ * @brief Initialize the futex bucket table
+ * @note Called once by kernel_launch
+ * @param None
  * @return None
  */
-void barrier_init(Barrier_t *barrier, uint32_t parties) {
-    barrier->Parties = parties;
-    barrier->Count = 0;
-    sync_core_init(&(barrier->Core));
+void futex_init(void) {
+    for (size_t i = 0; i < OCTOS_FUTEX_BUCKETS; i++) {
+        sync_core_init(&futex_buckets[i]);
+    }
 }
 
 /**
- * @brief Wait at the barrier
- * @note If the timeout expires, the function returns false
- * @param barrier: Pointer to the barrier
+ * @brief Block while a word still holds an expected value
+ * @note The value is compared with the bucket locked, so a futex_wake that
+ *       follows a change of the value cannot be missed
+ * @note Wakeups may be spurious, the caller must re-check its condition
+ * @param addr: Address of the word to wait on
+ * @param expected: Value the word must hold for the task to block
  * @param timeout_ticks: Timeout in ticks (UINT32_MAX for indefinite wait)
- * @retval true Barrier was released
- * @retval false Timeout expired
+ * @retval true If the word did not hold the expected value or the task
+ *         was woken
+ * @retval false If the timeout expired
  */
-bool barrier_wait(Barrier_t *barrier, uint32_t timeout_ticks) {
-    OCTOS_ENTER_CRITICAL();
-
-    barrier->Count++;
-    if (barrier->Count == barrier->Parties) {
-        bool switch_required = false;
-        List_t *const blocked_list = &(barrier->Core.BlockedList);
-        while (blocked_list->Length > 0) {
-            switch_required |=
-                    task_remove_highest_priority_from_event_list(blocked_list);
-        }
-        barrier->Count = 0;
-        OCTOS_EXIT_CRITICAL();
-
-        if (switch_required) OCTOS_YIELD();
-        return true;
-    }
-
-    OCTOS_EXIT_CRITICAL();
-
+bool futex_wait(volatile uint32_t *addr, uint32_t expected,
+                uint32_t timeout_ticks) {
     Timeout_t timeout;
     bool timeout_set = false;
+    TaskHandle_t const current = task_get_current();
 
     while (true) {
         OCTOS_ENTER_CRITICAL();
 
+        /* Never on the bucket here, the context of an earlier round (e.g.
+         * timed out after the word changed) must not outlive the wait */
+        if (*addr != expected ||
+            (timeout_set && current->WaitContext == NULL)) {
+            current->WaitContext = NULL;
+            OCTOS_EXIT_CRITICAL();
+            return true;
+        }
+
         if (timeout_ticks == 0) {
             OCTOS_EXIT_CRITICAL();
             return false;
@@ -628,254 +2153,386 @@ bool barrier_wait(Barrier_t *barrier, uint32_t timeout_ticks) {
             /* timeout_ticks == UINT32_MAX means to wait indefinitely */
             if (timeout_ticks != UINT32_MAX) task_set_timeout(&timeout);
             timeout_set = true;
-        } else {
-            OCTOS_EXIT_CRITICAL();
-            return true;
         }
 
+        current->WaitContext = addr;
+
         OCTOS_EXIT_CRITICAL();
 
         task_suspend_all();
-        SyncCore_t *const core = &(barrier->Core);
+        SyncCore_t *const core = futex_bucket(addr);
         /* Lock the queue so ISR cannot modify EventListItem */
         sync_lock(core);
         /* Timeout has expired */
         if (timeout_ticks != UINT32_MAX &&
             task_check_timeout(&timeout, timeout_ticks)) {
-            sync_unlock(core);
+            current->WaitContext = NULL;
+            futex_unlock(core);
             task_resume_all();
             return false;
         }
 
         /* Timeout has not expired */
-        if (barrier->Count != barrier->Parties) {
+        if (*addr == expected) {
             task_add_current_to_event_list(&(core->BlockedList), timeout_ticks);
-            sync_unlock(core);
+            futex_unlock(core);
             if (!task_resume_all()) OCTOS_YIELD();
         } else {
-            sync_unlock(core);
+            futex_unlock(core);
             task_resume_all();
         }
     }
 }
 
 /**
- * @brief Reset the barrier
- * @param barrier: Pointer to the barrier
- * @return None
+ * @brief Wake tasks waiting on an address
+ * @param addr: Address of the word waited on
+ * @param count: Maximum number of tasks to wake (SIZE_MAX for all)
+ * @return Number of tasks woken
  */
-void barrier_reset(Barrier_t *barrier) {
+size_t futex_wake(volatile uint32_t *addr, size_t count) {
     bool switch_required = false;
+    size_t woken;
 
     OCTOS_ENTER_CRITICAL();
-
-    sync_notify_all(&(barrier->Core), &switch_required);
-    barrier->Count = 0;
-
+    woken = futex_wake_bucket(futex_bucket(addr), addr, count,
+                              &switch_required);
     OCTOS_EXIT_CRITICAL();
 
     if (switch_required) OCTOS_YIELD();
+
+    return woken;
 }
 
-/** 
- * @brief Reset a barrier from an ISR context
- * @note This function is used to reset a barrier and unblock all tasks
- *       waiting on it. 
- *       If the barrier is unlocked, tasks are moved to the ready list.
- *       If the barrier is locked, the lock count is incremented for
- *       each blocked task.
- * @param barrier: Pointer to the barrier to be reset
+/**
+ * @brief Wake tasks waiting on an address from an ISR
+ * @note If the bucket is locked, every waiter of the bucket is woken when
+ *       the task holding the lock unlocks it
+ * @param addr: Address of the word waited on
+ * @param count: Maximum number of tasks to wake (SIZE_MAX for all)
  * @param switch_required:
- *      Pointer to a boolean that indicates if a context switch is required
+ *      Pointer to a boolean indicating if a context switch is required
  * @return None
  */
-void barrier_reset_from_isr(Barrier_t *barrier, bool *const switch_required) {
+void futex_wake_from_isr(volatile uint32_t *addr, size_t count,
+                         bool *const switch_required) {
     OCTOS_ASSERT_IF_INTERRUPT_PRIORITY_INVALID();
 
     uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
 
-    sync_notify_all_from_isr(&(barrier->Core), switch_required);
-    barrier->Count = 0;
+    SyncCore_t *const core = futex_bucket(addr);
+    const int16_t lock = core->Lock;
+    if (lock == syncUNLOCKED) {
+        futex_wake_bucket(core, addr, count, switch_required);
+    } else {
+        sync_lock_increment(core, lock);
+    }
 
     OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
 }
 
-/* Event ---------------------------------------------------------------------*/
+/* Completion ----------------------------------------------------------------*/
 
 /**
- * @brief Initialize an event
- * @param event: Pointer to the Event_t structure to be initialized
- * @return None
+ * @brief Check completions and register the current task as their waiter
+ * @note Must call within critical section. Waiters are woken through the
+ *       kernel notification slot, so a task can wait on many completions
+ * @param completions: Array of pointers to the completions
+ * @param count: Number of completions in the array
+ * @param wait_all: Whether all completions must be done
+ * @param index: Pointer to store the index of the first done completion
+ * @param waiter: Task to register on the pending completions, or NULL
+ * @retval true If the wait condition is satisfied
+ * @retval false Otherwise
  */
-void event_init(Event_t *event) {
-    event->Flag = false;
-    sync_core_init(&(event->Core));
+static bool completion_check(Completion_t *const *completions, size_t count,
+                             bool wait_all, size_t *index,
+                             TaskHandle_t waiter) {
+    size_t done = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        Completion_t *const completion = completions[i];
+
+        if (completion->State == CompletionDone) {
+            if (done == 0 && index != NULL) *index = i;
+            done++;
+        } else if (completion->Waiter == NULL ||
+                   completion->Waiter == task_get_current()) {
+            completion->Waiter = waiter;
+        }
+    }
+
+    return wait_all ? (done == count) : (done > 0);
 }
 
 /**
- * @brief Check if an event is set
- * @param event: Pointer to the Event_t structure to check
- * @retval true If the event is set
- * @retval false Otherwise
+ * @brief Wait on a set of completions
+ * @param completions: Array of pointers to the completions
+ * @param count: Number of completions in the array
+ * @param wait_all: Whether all completions must be done
+ * @param index: Pointer to store the index of the first done completion
+ * @param timeout_ticks: Maximum time to wait in ticks
+ * @retval true If the wait condition is satisfied
+ * @retval false If timed out
  */
-bool event_is_set(Event_t *event) {
-    bool result;
+static bool completion_wait_set(Completion_t *const *completions,
+                                size_t count, bool wait_all, size_t *index,
+                                uint32_t timeout_ticks) {
+    const Tick_t entering_tick = task_get_tick();
+    bool success = false;
+
+    while (true) {
+        OCTOS_ENTER_CRITICAL();
+        success = completion_check(completions, count, wait_all, index,
+                                   task_get_current());
+        OCTOS_EXIT_CRITICAL();
+
+        if (success) break;
+
+        uint32_t ticks_to_wait = UINT32_MAX;
+        if (timeout_ticks != UINT32_MAX) {
+            const Tick_t elapsed = task_get_tick() - entering_tick;
+            if (elapsed >= timeout_ticks) break;
+            ticks_to_wait = timeout_ticks - (uint32_t) elapsed;
+        }
+
+        /* A notification left over from an earlier completion only costs
+         * one more check */
+        task_notify_wait_indexed(taskKERNEL_NOTIFY_INDEX, 0, 0, NULL,
+                                 ticks_to_wait);
+    }
 
+    /* Deregister from the completions still pending */
     OCTOS_ENTER_CRITICAL();
-    result = event->Flag;
+    completion_check(completions, count, wait_all, NULL, NULL);
     OCTOS_EXIT_CRITICAL();
 
-    return result;
+    return success;
 }
 
 /**
- * @brief Set an event
- * @note If the event is set and tasks are blocked on it, they
- *       will be unblocked
- * @param event: Pointer to the Event_t structure to set
+ * @brief Initialize a completion
+ * @param completion: Pointer to the completion to be initialized
  * @return None
  */
-void event_set(Event_t *event) {
-    bool switch_required = false;
+void completion_init(Completion_t *completion) {
+    completion->Waiter = NULL;
+    completion->Status = 0;
+    completion->State = CompletionIdle;
+}
 
+/**
+ * @brief Reset a completion before starting the operation it tracks
+ * @note Must not be called while a task waits on the completion
+ * @param completion: Pointer to the completion
+ * @return None
+ */
+void completion_reset(Completion_t *completion) {
     OCTOS_ENTER_CRITICAL();
 
-    /* Micro optimization */
-    if (event->Flag == true) {
-        OCTOS_EXIT_CRITICAL();
-        return;
-    }
-
-    event->Flag = true;
-    sync_notify_all(&(event->Core), &switch_required);
+    completion->Waiter = NULL;
+    completion->Status = 0;
+    completion->State = CompletionPending;
 
     OCTOS_EXIT_CRITICAL();
+}
 
-    if (switch_required) OCTOS_YIELD();
+/**
+ * @brief Check if a completion is done
+ * @param completion: Pointer to the completion
+ * @retval true If the completion is done
+ * @retval false Otherwise
+ */
+bool completion_is_done(Completion_t *completion) {
+    return completion->State == CompletionDone;
 }
 
 /**
- * @brief Clear an event
- * @param event: Pointer to the Event_t structure to clear
+ * @brief Get the status a completion was completed with
+ * @note Only valid once the completion is done
+ * @param completion: Pointer to the completion
+ * @return The status of the operation
+ */
+int32_t completion_get_status(Completion_t *completion) {
+    return completion->Status;
+}
+
+/**
+ * @brief Complete a completion and wake its waiter
+ * @param completion: Pointer to the completion
+ * @param status: Status of the operation
  * @return None
  */
-void event_clear(Event_t *event) {
+void completion_complete(Completion_t *completion, int32_t status) {
     OCTOS_ENTER_CRITICAL();
 
-    event->Flag = false;
+    const TaskHandle_t waiter = completion->Waiter;
+    completion->Waiter = NULL;
+    completion->Status = status;
+    completion->State = CompletionDone;
 
     OCTOS_EXIT_CRITICAL();
+
+    if (waiter != NULL)
+        task_notify_indexed(waiter, taskKERNEL_NOTIFY_INDEX, 0, NoAction);
 }
 
 /**
- * @brief Wait for an event to be set
- * @note If the event is not set, the calling task will be blocked until
- *       the event is set or the timeout expires
- * @param event: Pointer to the Event_t structure to wait on
- * @param timeout_ticks: Timeout in ticks (UINT32_MAX for indefinite wait)
- * @retval true If the event was set
- * @retval false If the timeout expired
+ * @brief Complete a completion and wake its waiter from an ISR
+ * @param completion: Pointer to the completion
+ * @param status: Status of the operation
+ * @param switch_required:
+ *      Pointer to a boolean indicating if a context switch is required
+ * @return None
  */
-bool event_wait(Event_t *event, uint32_t timeout_ticks) {
-    Timeout_t timeout;
-    bool timeout_set = false;
+void completion_complete_from_isr(Completion_t *completion, int32_t status,
+                                  bool *const switch_required) {
+    OCTOS_ASSERT_IF_INTERRUPT_PRIORITY_INVALID();
 
-    while (true) {
-        OCTOS_ENTER_CRITICAL();
+    uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
 
-        if (event->Flag == true) {
-            OCTOS_EXIT_CRITICAL();
-            return true;
-        } else if (timeout_ticks == 0) {
-            OCTOS_EXIT_CRITICAL();
-            return false;
-        } else if (!timeout_set) {
-            /* timeout_ticks == UINT32_MAX means to wait indefinitely */
-            if (timeout_ticks != UINT32_MAX) task_set_timeout(&timeout);
-            timeout_set = true;
-        }
+    const TaskHandle_t waiter = completion->Waiter;
+    completion->Waiter = NULL;
+    completion->Status = status;
+    completion->State = CompletionDone;
 
-        OCTOS_EXIT_CRITICAL();
+    OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
 
-        task_suspend_all();
-        SyncCore_t *const core = &(event->Core);
-        /* Lock the queue so ISR cannot modify EventListItem */
-        sync_lock(core);
-        /* Timeout has expired */
-        if (timeout_ticks != UINT32_MAX &&
-            task_check_timeout(&timeout, timeout_ticks)) {
-            sync_unlock(core);
-            task_resume_all();
-            return false;
-        }
+    if (waiter != NULL)
+        task_notify_indexed_from_isr(waiter, taskKERNEL_NOTIFY_INDEX, 0,
+                                     NoAction, switch_required);
+}
 
-        /* Timeout has not expired */
-        if (event->Flag != true) {
-            task_add_current_to_event_list(&(core->BlockedList), timeout_ticks);
-            sync_unlock(core);
-            if (!task_resume_all()) OCTOS_YIELD();
-        } else {
-            sync_unlock(core);
-            task_resume_all();
-        }
-    }
+/**
+ * @brief Wait for a completion to be done
+ * @param completion: Pointer to the completion
+ * @param timeout_ticks: Maximum time to wait in ticks
+ * @retval true If the completion is done
+ * @retval false If timed out
+ */
+bool completion_wait(Completion_t *completion, uint32_t timeout_ticks) {
+    return completion_wait_set(&completion, 1, true, NULL, timeout_ticks);
 }
 
 /**
- * @brief Check if an event is set from an ISR
- * @param event: Pointer to the Event_t structure to check
- * @retval true If the event is set
- * @retval false Otherwise
+ * @brief Wait for any of a set of completions to be done
+ * @param completions: Array of pointers to the completions
+ * @param count: Number of completions in the array
+ * @param index: Pointer to store the index of the first done completion
+ * @param timeout_ticks: Maximum time to wait in ticks
+ * @retval true If a completion is done
+ * @retval false If timed out
  */
-bool event_is_set_from_isr(Event_t *event) {
-    OCTOS_ASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+bool completion_wait_any(Completion_t *const *completions, size_t count,
+                         size_t *index, uint32_t timeout_ticks) {
+    return completion_wait_set(completions, count, false, index,
+                               timeout_ticks);
+}
 
-    bool result;
+/**
+ * @brief Wait for all of a set of completions to be done
+ * @param completions: Array of pointers to the completions
+ * @param count: Number of completions in the array
+ * @param timeout_ticks: Maximum time to wait in ticks
+ * @retval true If all completions are done
+ * @retval false If timed out
+ */
+bool completion_wait_all(Completion_t *const *completions, size_t count,
+                         uint32_t timeout_ticks) {
+    return completion_wait_set(completions, count, true, NULL, timeout_ticks);
+}
 
-    uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
-    result = event->Flag;
-    OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+#if OCTOS_HRTIMER
+/**
+ * @brief Wait for a completion with a microsecond timeout
+ * @note The timeout is backed by the high-resolution timer, independent of
+ *       the tick rate
+ * @param completion: Pointer to the completion
+ * @param timeout_us: Maximum time to wait in microseconds
+ * @retval true If the completion is done
+ * @retval false If timed out
+ */
+bool completion_wait_us(Completion_t *completion, uint32_t timeout_us) {
+    HrTimer_t timer;
+    bool success = false;
 
-    return result;
+    hrtimer_init(&timer, &hrtimer_notify_task, task_get_current());
+    hrtimer_start(&timer, timeout_us);
+
+    while (true) {
+        OCTOS_ENTER_CRITICAL();
+        success = completion_check(&completion, 1, true, NULL,
+                                   task_get_current());
+        OCTOS_EXIT_CRITICAL();
+
+        if (success || !hrtimer_is_armed(&timer)) break;
+
+        task_notify_wait_indexed(taskKERNEL_NOTIFY_INDEX, 0, 0, NULL,
+                                 UINT32_MAX);
+    }
+
+    hrtimer_cancel(&timer);
+
+    /* Deregister if still pending */
+    OCTOS_ENTER_CRITICAL();
+    completion_check(&completion, 1, true, NULL, NULL);
+    OCTOS_EXIT_CRITICAL();
+
+    return success;
 }
+#endif
+
+/* Priority Donation ---------------------------------------------------------*/
 
 /**
- * @brief Set an event from an ISR
- * @note If the event is set and tasks are blocked on it, they will
- *       be unblocked
- * @param event: Pointer to the Event_t structure to set
- * @param switch_required:
- *      Pointer to a boolean indicating if a context switch is required
- * @return None
+ * @brief Lend the priority of a task to the task it waits on
+ * @note The donee runs at least at the priority of the donor until the
+ *       donation is revoked, including later boosts of the donor. The donor
+ *       must stay blocked until then
+ * @param donation: Pointer to the donation, owned by the donor
+ * @param donor: Handle of the task lending its priority
+ * @param donee: Handle of the task running at the lent priority
+ * @retval true Context switch is required
+ * @retval false Context switch is not required
  */
-void event_set_from_isr(Event_t *event, bool *const switch_required) {
-    OCTOS_ASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+bool sync_donate_priority(TaskDonation_t *donation, TaskHandle_t donor,
+                          TaskHandle_t donee) {
+    OCTOS_ENTER_CRITICAL();
 
-    uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
+    donation->Donor = donor;
+    donation->Donee = donee;
+    donation->Next = donee->Donations;
+    donee->Donations = donation;
+    sync_set_blocked_on(donor, BlockedOnDonation, donation);
 
-    if (event->Flag == true) {
-        if (switch_required != NULL) *switch_required = false;
-        OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
-        return;
-    }
+    const bool switch_required = sync_update_priority(donee);
 
-    event->Flag = true;
-    sync_notify_all_from_isr(&(event->Core), switch_required);
+    OCTOS_EXIT_CRITICAL();
 
-    OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+    return switch_required;
 }
 
 /**
- * @brief Clear an event from an ISR
- * @param event: Pointer to the Event_t structure to clear
- * @return None
+ * @brief Take back a priority lent with sync_donate_priority()
+ * @note The donee drops to the priority it would run at without the
+ *       donation, boosts from its locks and other donations are kept
+ * @param donation: Pointer to the donation
+ * @retval true Context switch is required
+ * @retval false Context switch is not required
  */
-void event_clear_from_isr(Event_t *event) {
-    OCTOS_ASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+bool sync_revoke_priority(TaskDonation_t *donation) {
+    TaskHandle_t const donee = donation->Donee;
 
-    uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
+    OCTOS_ENTER_CRITICAL();
 
-    event->Flag = false;
+    TaskDonation_t **link = &(donee->Donations);
+    while (*link != donation) link = &((*link)->Next);
+    *link = donation->Next;
+    sync_set_blocked_on(donation->Donor, BlockedOnNone, NULL);
 
-    OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+    const bool switch_required = sync_update_priority(donee);
+
+    OCTOS_EXIT_CRITICAL();
+
+    return switch_required;
 }
@@ -2,9 +2,11 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
-#include "Arch/stm32f4xx/Inc/api.h"
+#include "Arch/port.h"
 #include "bitmap.h"
+#include "clock.h"
 #include "config.h"
 #include "list.h"
 #include "page.h"
@@ -13,27 +15,39 @@
 
 TCB_t *volatile current_tcb = NULL;
 
-static volatile uint32_t current_tick = 0;
+static volatile uint32_t current_tick_low = 0;
+static volatile uint32_t current_tick_high = 0;
 static volatile uint32_t pended_ticks = 0;
-static volatile uint32_t tick_overflows = 0;
-static volatile uint32_t next_task_unblock_tick = UINT32_MAX;
+static volatile Tick_t next_task_unblock_tick = UINT64_MAX;
 static volatile uint32_t scheduler_suspended = 0;
 static volatile bool yield_pending = false;
 static volatile uint32_t
         top_ready_priority_data[(OCTOS_MAX_PRIORITIES + 31) / 32];
 static volatile Bitmap_t top_ready_priority;
-static volatile uint8_t current_number_of_tasks = 0;
+static volatile uint16_t current_number_of_tasks = 0;
 static uint32_t tcb_id = 1; /* zero is reserved for idle task */
 
 static List_t ready_list[OCTOS_MAX_PRIORITIES];
 static List_t pending_ready_list;
-static List_t delayed_list_1;
-static List_t delayed_list_2;
-static List_t *volatile delayed_list;
-static List_t *volatile delayed_list_overflow;
+static List_t delayed_list;
 static List_t suspended_list;
 static List_t terminated_list;
 
+/* Tasks woken from ISRs, pushed lock-free and readied by the scheduler */
+static TCB_t *volatile isr_wake_stack = NULL;
+
+/* Link of the bottom task of the ISR wake stack, a queued task is never NULL */
+#define taskISR_WAKE_END ((TCB_t *) 1)
+
+/* Bounds of the octos_tasks section, weak for images without defined tasks */
+extern const TaskDefine_t __start_octos_tasks[] OCTOS_WEAK;
+extern const TaskDefine_t __stop_octos_tasks[] OCTOS_WEAK;
+
+#if OCTOS_COMPACT_LIST
+/* Asks the linker script to check that RAM is within reach of the links */
+const uint8_t octos_compact_list OCTOS_USED = 1;
+#endif
+
 /* Private Helper ------------------------------------------------------------*/
 
 /**
@@ -50,9 +64,7 @@ static TCB_t *tcb_build(Page_t *page, TaskFunc_t func, void *args,
                         const char *name, uint8_t priority) {
     TCB_t *tcb = (TCB_t *) page->raw;
 
-    tcb->Page.raw = page->raw;
-    tcb->Page.size = page->size;
-    tcb->Page.policy = page->policy;
+    tcb->PagePolicy = (uint8_t) page->policy;
 
     if (name != NULL) {
         for (size_t i = 0; i < TCB_NAME_MAX_LENGTH; i++) {
@@ -62,27 +74,26 @@ static TCB_t *tcb_build(Page_t *page, TaskFunc_t func, void *args,
         tcb->Name[TCB_NAME_MAX_LENGTH - 1] = '\0';
     }
 
-    uint32_t *stack_top = &(page->raw[page->size - 16]);
-    stack_top[15] = (uint32_t) (1U << 24);// PSR
-    stack_top[14] = (uint32_t) func;      // PC
-    stack_top[13] = 0;                    // LR
-    stack_top[12] = 0;                    // R12
-    stack_top[11] = 0;                    // R3
-    stack_top[10] = 0;                    // R2
-    stack_top[9] = 0;                     // R1
-    stack_top[8] = (uint32_t) args;       // R0
-    tcb->StackTop = stack_top;
+    /* The stack grows down from the end of the page towards the TCB */
+    tcb->StackTop = OCTOS_INIT_STACK((uint32_t *) (tcb + 1),
+                                     &(page->raw[page->size]), func, args);
 
     tcb->TCBNumber = tcb_id++;
     tcb->MutexHeld = 0;
+    tcb->BlockedOn = NULL;
+    tcb->BlockedOnType = BlockedOnNone;
+    tcb->HeldMutexes = NULL;
+    tcb->HeldRwLocks = NULL;
+    tcb->Donations = NULL;
+    tcb->EventFlags = 0;
+    tcb->WaitContext = NULL;
+    tcb->IsrWakeNext = NULL;
     tcb->RootPriority = priority;
     tcb->Priority = priority;
     list_item_init(&(tcb->StateListItem));
     list_item_init(&(tcb->EventListItem));
     list_item_set_value(&(tcb->StateListItem), priority);
-    list_item_set_value(&(tcb->StateListItem), priority);
-    tcb->StateListItem.Owner = tcb;
-    tcb->EventListItem.Owner = tcb;
+    list_item_set_value(&(tcb->EventListItem), priority);
 
     return tcb;
 }
@@ -140,7 +151,67 @@ static void task_select_highest_priority(void) {
             bitmap_first_one((Bitmap_t *) &top_ready_priority) - 1;
     OCTOS_ASSERT(highest_priority >= 0);
     OCTOS_ASSERT(ready_list[highest_priority].Length > 0);
-    current_tcb = list_get_owner_of_next_entry(&ready_list[highest_priority]);
+    current_tcb = LIST_ITEM_OWNER(
+            list_get_next_entry(&ready_list[highest_priority]), TCB_t,
+            StateListItem);
+}
+
+/**
+ * @brief Read the 64-bit tick count without a critical section
+ * @note The halves are only written by task_tick_count_increment() with
+ *       interrupts masked, so the read is retried if the low half changed
+ *       in between
+ * @param None
+ * @return Current tick count
+ */
+static Tick_t task_read_tick(void) {
+    uint32_t low;
+    uint32_t high;
+
+    do {
+        low = current_tick_low;
+        high = current_tick_high;
+    } while (low != current_tick_low);
+
+    return ((Tick_t) high << 32) | low;
+}
+
+/**
+ * @brief Advance the 64-bit tick count
+ * @param ticks: Number of ticks to advance by
+ * @return The new tick count
+ */
+static Tick_t task_tick_count_advance(uint32_t ticks) {
+    uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
+
+    const uint32_t low = current_tick_low + ticks;
+    const uint32_t high = current_tick_high + (low < ticks ? 1 : 0);
+    current_tick_low = low;
+    current_tick_high = high;
+
+    OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+
+    return ((Tick_t) high << 32) | low;
+}
+
+/**
+ * @brief Insert a task into the delayed list by its wake tick
+ * @note Tasks of equal wake tick wake in insertion order
+ * @param tcb: Pointer to the TCB of the task
+ * @return None
+ */
+static void task_insert_delayed(TCB_t *tcb) {
+    ListItem_t *position = &(delayed_list.End);
+    ListItem_t *next = list_item_next(position);
+
+    while (next != &(delayed_list.End) &&
+           LIST_ITEM_OWNER(next, TCB_t, StateListItem)->WakeTick <=
+                   tcb->WakeTick) {
+        position = next;
+        next = list_item_next(position);
+    }
+
+    list_insert_after(&delayed_list, position, &(tcb->StateListItem));
 }
 
 /**
@@ -151,10 +222,253 @@ static void task_select_highest_priority(void) {
  * @return None
  */
 static void task_reset_next_unblock_tick(void) {
-    if (delayed_list->Length > 0)
-        next_task_unblock_tick = list_head(delayed_list)->Value;
+    if (delayed_list.Length > 0)
+        next_task_unblock_tick =
+                LIST_ITEM_OWNER(list_head(&delayed_list), TCB_t, StateListItem)
+                        ->WakeTick;
     else
-        next_task_unblock_tick = UINT32_MAX;
+        next_task_unblock_tick = UINT64_MAX;
+}
+
+/**
+ * @brief Append an event list item to the bucket of its priority
+ * @note The bucket is initialized on first use, its end marker value tells
+ *       bucket lists apart from plain sorted event lists
+ * @param list: Pointer to the bucketed event list
+ * @param item: Pointer to the event list item, valued with its priority
+ * @return None
+ */
+static void task_insert_bucketed(EventList_t *list, ListItem_t *item) {
+    const uint32_t priority = list_item_get_value(item);
+    List_t *const bucket = &(list->Buckets[priority]);
+    const uint32_t mask = 1UL << (priority % 32);
+
+    if ((list->Waiting[priority / 32] & mask) == 0) {
+        list_init(bucket);
+        bucket->End.Value = taskEVENT_BUCKET_END;
+        list->Waiting[priority / 32] |= mask;
+    }
+
+    list_insert_end(bucket, item);
+}
+
+/**
+ * @brief Get the bucketed event list owning a bucket
+ * @param bucket: Pointer to a bucket of a bucketed event list
+ * @param priority: Priority served by the bucket
+ * @return Pointer to the owning bucketed event list
+ */
+static EventList_t *task_bucket_owner(List_t *bucket, uint32_t priority) {
+    return (EventList_t *) ((uint8_t *) (bucket - priority) -
+                            offsetof(EventList_t, Buckets));
+}
+
+/**
+ * @brief Remove an event list item from the list it is in
+ * @note Must be called before the item value changes, as the value locates
+ *       the bucket bit to clear when the item was in a bucketed event list
+ * @param item: Pointer to the event list item
+ * @return None
+ */
+static void task_remove_event_item(ListItem_t *item) {
+    List_t *const parent = list_item_parent(item);
+    if (parent == NULL) return;
+
+    list_remove(item);
+
+    if (parent->End.Value == taskEVENT_BUCKET_END && parent->Length == 0) {
+        const uint32_t priority = list_item_get_value(item);
+        task_bucket_owner(parent, priority)->Waiting[priority / 32] &=
+                ~(1UL << (priority % 32));
+    }
+}
+
+/**
+ * @brief Push a task onto the ISR wake stack
+ * @note Lock-free, the task is claimed first so that it is queued once
+ *       however many ISRs wake it before the stack is drained
+ * @param tcb: Pointer to the TCB of the task to wake
+ * @return None
+ */
+static void task_isr_wake_push(TCB_t *tcb) {
+    void *volatile *const link = (void *volatile *) &(tcb->IsrWakeNext);
+    void *volatile *const top = (void *volatile *) &isr_wake_stack;
+
+    do {
+        if (OCTOS_LDREX_PTR(link) != NULL) {
+            OCTOS_CLREX();
+            return;
+        }
+    } while (!OCTOS_STREX_PTR(link, taskISR_WAKE_END));
+
+    TCB_t *head;
+    do {
+        head = OCTOS_LDREX_PTR(top);
+        tcb->IsrWakeNext = head != NULL ? head : taskISR_WAKE_END;
+    } while (!OCTOS_STREX_PTR(top, tcb));
+}
+
+/**
+ * @brief Ready the tasks pushed onto the ISR wake stack
+ * @note Tasks are readied in the order they were pushed, one per critical
+ *       section. A task that is no longer blocked outside of any event list,
+ *       e.g. woken meanwhile by its timeout, is left as is
+ * @note Must call from task context, PendSV or the tick with the scheduler
+ *       running, never while the scheduler suspension is in use by an
+ *       interrupted task
+ * @param None
+ * @return None
+ */
+static void task_isr_wake_drain(void) {
+    if (isr_wake_stack == NULL) return;
+
+    void *volatile *const top = (void *volatile *) &isr_wake_stack;
+    TCB_t *tcb;
+    do {
+        tcb = OCTOS_LDREX_PTR(top);
+    } while (!OCTOS_STREX_PTR(top, NULL));
+
+    /* Popped links are only read by ISRs, reverse them to the push order */
+    TCB_t *pushed = NULL;
+    while (tcb != NULL) {
+        TCB_t *const next =
+                tcb->IsrWakeNext != taskISR_WAKE_END ? tcb->IsrWakeNext : NULL;
+        tcb->IsrWakeNext = pushed != NULL ? pushed : taskISR_WAKE_END;
+        pushed = tcb;
+        tcb = next;
+    }
+
+    while (pushed != NULL) {
+        uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
+
+        tcb = pushed;
+        pushed = tcb->IsrWakeNext != taskISR_WAKE_END ? tcb->IsrWakeNext
+                                                       : NULL;
+        tcb->IsrWakeNext = NULL;
+
+        List_t *const parent = list_item_parent(&(tcb->StateListItem));
+        if (list_item_parent(&(tcb->EventListItem)) == NULL &&
+            (parent == &delayed_list || parent == &suspended_list)) {
+            yield_pending |= task_remove_from_delayed_list(tcb);
+            task_add_to_ready_list(tcb);
+        }
+
+        OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+    }
+}
+
+/**
+ * @brief Wake a task pending on a notification through the ISR wake stack
+ * @note Usable from tasks and ISRs, the scheduler lists are left to the next
+ *       context switch or tick, which readies the task before anything else
+ *       may run
+ * @note Must call within critical section
+ * @param tcb: Pointer to the TCB of the notified task
+ * @retval true Context switch is required
+ * @retval false Context switch is not required
+ */
+static bool task_notify_wake(TCB_t *tcb) {
+    OCTOS_ASSERT(list_item_parent(&(tcb->EventListItem)) == NULL);
+    task_isr_wake_push(tcb);
+
+    const bool switch_required = tcb->Priority > current_tcb->Priority;
+    yield_pending |= switch_required;
+
+    return switch_required;
+}
+
+/**
+ * @brief Advance the tick count and wake the tasks whose delay expired
+ * @note A single pass over the head of the delayed list wakes every sleeper
+ *       due within the advanced interval, whatever its length
+ * @note Must call with the scheduler running, within critical section or
+ *       from the tick interrupt
+ * @param ticks: Number of ticks to advance by
+ * @retval true Context switch is required
+ * @retval false Context switch is not required
+ */
+static bool task_tick_advance(uint32_t ticks) {
+    bool switch_required = false;
+
+    const Tick_t const_tick = task_tick_count_advance(ticks);
+
+    /* Wake delayed task if needed */
+    if (const_tick >= next_task_unblock_tick) {
+        while (true) {
+            if (delayed_list.Length == 0) {
+                next_task_unblock_tick = UINT64_MAX;
+                break;
+            }
+
+            TCB_t *head_owner = LIST_ITEM_OWNER(list_head(&delayed_list),
+                                                TCB_t, StateListItem);
+
+            if (const_tick < head_owner->WakeTick) {
+                next_task_unblock_tick = head_owner->WakeTick;
+                break;
+            }
+
+            switch_required |= task_remove_from_delayed_list(head_owner);
+            task_remove_event_item(&(head_owner->EventListItem));
+            task_add_to_ready_list(head_owner);
+        }
+    }
+
+    /* A task woken from an ISR at the current priority did not pend a
+     * switch, it must be on the ready list to get its turn */
+    task_isr_wake_drain();
+
+    /* Round robin within same priority */
+    switch_required |=
+            list_item_parent(&(current_tcb->StateListItem))->Length > 1;
+
+    /* Yield pending */
+    switch_required |= yield_pending;
+
+    return switch_required;
+}
+
+/**
+ * @brief Entry of periodic tasks, runs the job once per period
+ * @note Releases sit on a fixed grid of the period from the creation tick,
+ *       a late job does not shift the following releases
+ * @param args: Pointer to the periodic task structure
+ * @return None
+ */
+static void task_periodic_thread(void *args) {
+    TaskPeriodic_t *const periodic = args;
+    Tick_t release = task_get_tick();
+
+    while (true) {
+        task_delay_until(&release, periodic->Period);
+
+        const uint64_t start_ns = clock_now_ns();
+        const uint64_t release_ns = clock_tick_to_ns(release);
+        const uint64_t jitter_ns =
+                start_ns > release_ns ? start_ns - release_ns : 0;
+
+        periodic->Func(periodic->Args);
+
+        const Tick_t completion = task_get_tick();
+        const Tick_t deadline = release + periodic->Deadline;
+        const uint32_t response = (uint32_t) (completion - release);
+
+        OCTOS_ENTER_CRITICAL();
+
+        TaskPeriodicStats_t *const stats = &(periodic->Stats);
+        stats->Jobs++;
+        if (completion > deadline) stats->Overruns++;
+        stats->LastRelease = release;
+        stats->LastCompletion = completion;
+        stats->LastDeadline = deadline;
+        if (response > stats->MaxResponse) stats->MaxResponse = response;
+        if (jitter_ns > stats->MaxJitterNs)
+            stats->MaxJitterNs =
+                    jitter_ns > UINT32_MAX ? UINT32_MAX : (uint32_t) jitter_ns;
+        stats->TotalJitterNs += jitter_ns;
+
+        OCTOS_EXIT_CRITICAL();
+    }
 }
 
 /* Misc ----------------------------------------------------------------------*/
@@ -165,16 +479,16 @@ static void task_reset_next_unblock_tick(void) {
  * @return Current state of the thread
  */
 TaskState_t task_status(TaskHandle_t handle) {
-    List_t *const parent = handle->StateListItem.Parent;
+    List_t *const parent = list_item_parent(&(handle->StateListItem));
     if (handle == current_tcb) return RUNNING;
     else if (parent == &ready_list[handle->Priority])
         return READY;
     else if (parent == &terminated_list)
         return TERMINATED;
-    else if (parent == delayed_list || parent == delayed_list_overflow)
+    else if (parent == &delayed_list)
         return BLOCKED;
     else if (parent == &suspended_list) {
-        if (handle->EventListItem.Parent) return BLOCKED;
+        if (list_item_parent(&(handle->EventListItem))) return BLOCKED;
         else
             return SUSPENDED;
     } else
@@ -187,12 +501,7 @@ TaskState_t task_status(TaskHandle_t handle) {
  * @return None
  */
 void task_set_timeout(Timeout_t *timeout) {
-    OCTOS_ENTER_CRITICAL();
-
-    timeout->entering_tick = current_tick;
-    timeout->overflows = tick_overflows;
-
-    OCTOS_EXIT_CRITICAL();
+    timeout->entering_tick = task_read_tick();
 }
 
 /** 
@@ -203,21 +512,7 @@ void task_set_timeout(Timeout_t *timeout) {
  * @retval false Timeout has not expired
  */
 bool task_check_timeout(Timeout_t *timeout, uint32_t ticks_to_delay) {
-    bool is_timeout = false;
-
-    OCTOS_ENTER_CRITICAL();
-
-    const uint32_t expected_tick = timeout->entering_tick + ticks_to_delay;
-    const uint32_t expected_overflow = timeout->entering_tick > expected_tick
-                                               ? (timeout->overflows + 1)
-                                               : timeout->overflows;
-
-    is_timeout = !((tick_overflows == expected_overflow) &&
-                   (current_tick < expected_tick));
-
-    OCTOS_EXIT_CRITICAL();
-
-    return is_timeout;
+    return task_read_tick() - timeout->entering_tick >= ticks_to_delay;
 }
 
 /**
@@ -226,7 +521,16 @@ bool task_check_timeout(Timeout_t *timeout, uint32_t ticks_to_delay) {
  * @param None
  * @return The number of tasks
  */
-uint8_t task_get_number_of_tasks(void) { return current_number_of_tasks; }
+uint16_t task_get_number_of_tasks(void) {
+    return current_number_of_tasks;
+}
+
+/**
+ * @brief Get the handle of the currently running task
+ * @param None
+ * @return Pointer to the TCB of the current task
+ */
+TaskHandle_t task_get_current(void) { return current_tcb; }
 
 /**
  * @brief Get information about a task
@@ -280,7 +584,7 @@ void task_info_list(char *buffer) {
         ListItem_t *item = list_head(list);
 
         for (size_t i = list->Length; i > 0; i--) {
-            TCB_t *tcb = item->Owner;
+            TCB_t *tcb = LIST_ITEM_OWNER(item, TCB_t, StateListItem);
             TaskInfo_t info;
 
             if (task_get_info(tcb, &info)) {
@@ -289,19 +593,19 @@ void task_info_list(char *buffer) {
                                 status_char[info.status], info.priority);
             }
 
-            item = item->Next;
+            item = list_item_next(item);
         }
     }
 
-    List_t *special_lists[] = {delayed_list, delayed_list_overflow,
-                               &suspended_list, &terminated_list};
+    List_t *special_lists[] = {&delayed_list, &suspended_list,
+                               &terminated_list};
     for (size_t i = sizeof(special_lists) / sizeof(special_lists[0]); i > 0;
          i--) {
         List_t *const list = special_lists[i - 1];
         ListItem_t *item = list_head(list);
 
         for (size_t i = list->Length; i > 0; i--) {
-            TCB_t *const tcb = item->Owner;
+            TCB_t *const tcb = LIST_ITEM_OWNER(item, TCB_t, StateListItem);
             TaskInfo_t info;
 
             if (task_get_info(tcb, &info)) {
@@ -310,7 +614,7 @@ void task_info_list(char *buffer) {
                                 status_char[info.status], info.priority);
             }
 
-            item = item->Next;
+            item = list_item_next(item);
         }
     }
 
@@ -327,10 +631,7 @@ void task_lists_init(void) {
     list_init(&suspended_list);
     list_init(&terminated_list);
 
-    list_init(&delayed_list_1);
-    list_init(&delayed_list_2);
-    delayed_list = &delayed_list_1;
-    delayed_list_overflow = &delayed_list_2;
+    list_init(&delayed_list);
 }
 
 /** 
@@ -348,6 +649,43 @@ void task_add_to_ready_list(TaskHandle_t handle) {
     list_insert_end(&ready_list[priority], &(handle->StateListItem));
 }
 
+/**
+ * @brief Ready a blocked task ahead of the other tasks of its priority
+ * @note The task is placed right after the running entry of its ready list,
+ *       so that a switch at that priority goes straight to it instead of
+ *       waiting for its round robin turn. A yield is pended if the task does
+ *       not have a lower priority than the current task
+ * @note The task must not wait on an event list, a task that is no longer
+ *       delayed or suspended is left as is
+ * @note Must call within scheduler suspension
+ * @param handle: Pointer to the TCB of the task
+ * @return None
+ */
+void task_handoff(TaskHandle_t handle) {
+    OCTOS_ASSERT(scheduler_suspended > 0);
+    OCTOS_ASSERT(list_item_parent(&(handle->EventListItem)) == NULL);
+
+    OCTOS_ENTER_CRITICAL();
+
+    /* Already woken, e.g. by its timeout */
+    List_t *const parent = list_item_parent(&(handle->StateListItem));
+    if (parent != &delayed_list && parent != &suspended_list) {
+        OCTOS_EXIT_CRITICAL();
+        return;
+    }
+
+    task_remove_from_delayed_list(handle);
+
+    const uint8_t priority = handle->Priority;
+    List_t *const list = &ready_list[priority];
+    task_set_ready_priority(priority);
+    list_insert_after(list, list_current(list), &(handle->StateListItem));
+
+    yield_pending |= priority >= current_tcb->Priority;
+
+    OCTOS_EXIT_CRITICAL();
+}
+
 /**
  * @brief Remove the current task from its current state and add it to the
  *        delayed list
@@ -365,16 +703,9 @@ void task_remove_and_add_current_to_delayed_list(uint32_t ticks_to_delay) {
     if (ticks_to_delay == UINT32_MAX) {
         list_insert_end(&suspended_list, item);
     } else {
-        const uint32_t tick_to_wake = current_tick + ticks_to_delay;
-        list_item_set_value(item, tick_to_wake);
-        if (tick_to_wake < current_tick) {
-            // Overflow will occur, add to overflow list
-            list_insert(delayed_list_overflow, item);
-        } else {
-            // Add to normal delayed list
-            list_insert(delayed_list, item);
-            task_reset_next_unblock_tick();
-        }
+        current_tcb->WakeTick = task_read_tick() + ticks_to_delay;
+        task_insert_delayed(current_tcb);
+        task_reset_next_unblock_tick();
     }
 }
 
@@ -386,12 +717,10 @@ void task_remove_and_add_current_to_delayed_list(uint32_t ticks_to_delay) {
  */
 bool task_remove_from_delayed_list(TaskHandle_t handle) {
     ListItem_t *const item = &(handle->StateListItem);
-    List_t *const parent = item->Parent;
-    bool is_from_delayed_list = parent == delayed_list;
+    List_t *const parent = list_item_parent(item);
+    bool is_from_delayed_list = parent == &delayed_list;
 
-    if (!is_from_delayed_list && parent != delayed_list_overflow &&
-        parent != &suspended_list)
-        return false;
+    if (!is_from_delayed_list && parent != &suspended_list) return false;
 
     if (list_remove(item) && is_from_delayed_list)
         task_reset_next_unblock_tick();
@@ -409,7 +738,7 @@ bool task_remove_from_delayed_list(TaskHandle_t handle) {
  */
 void task_add_current_to_event_list(List_t *list, uint32_t ticks_to_wait) {
     OCTOS_ASSERT(ticks_to_wait > 0 && ticks_to_wait <= UINT32_MAX);
-    OCTOS_ASSERT(current_tcb->EventListItem.Parent == NULL);
+    OCTOS_ASSERT(list_item_parent(&(current_tcb->EventListItem)) == NULL);
 
     list_insert(list, &(current_tcb->EventListItem));
     task_remove_and_add_current_to_delayed_list(ticks_to_wait);
@@ -425,26 +754,156 @@ void task_add_current_to_event_list(List_t *list, uint32_t ticks_to_wait) {
 bool task_remove_highest_priority_from_event_list(List_t *list) {
     if (list->Length == 0) return false;
 
+    return task_remove_from_event_list(
+            LIST_ITEM_OWNER(list_tail(list), TCB_t, EventListItem));
+}
+
+/**
+ * @brief Remove all tasks from an event list
+ * @note Not a splice, every list item records its parent list so the cost
+ *       grows with the number of waiters. Waiters are moved to the pending
+ *       ready list one per critical section, highest priority first, so only
+ *       the length of each masked interval is bounded. Their delayed list
+ *       removal is left to task_resume_all(), which readies them
+ * @note Must call within scheduler suspension, with the owner of the list
+ *       locked against ISRs
+ * @param list: The event list to remove the tasks from
+ * @retval true A removed task has a higher priority than the current task
+ * @retval false Otherwise
+ */
+bool task_remove_all_from_event_list(List_t *list) {
     bool switch_required = false;
 
-    ListItem_t *item = list_tail(list);
-    list_remove(item);
-    TCB_t *const owner = item->Owner;
-    if (list_item_get_value(item) != owner->Priority)
+    OCTOS_ASSERT(scheduler_suspended > 0);
+
+    while (true) {
+        OCTOS_ENTER_CRITICAL();
+
+        if (list->Length == 0) {
+            OCTOS_EXIT_CRITICAL();
+            break;
+        }
+
+        ListItem_t *const item = list_tail(list);
+        TCB_t *const owner = LIST_ITEM_OWNER(item, TCB_t, EventListItem);
+
+        task_remove_event_item(item);
         list_item_set_value(item, owner->Priority);
+        list_insert_end(&pending_ready_list, item);
+        switch_required |= owner->Priority > current_tcb->Priority;
+
+        OCTOS_EXIT_CRITICAL();
+    }
 
-    switch_required = task_remove_from_delayed_list(owner);
+    yield_pending |= switch_required;
+
+    return switch_required;
+}
+
+/**
+ * @brief Add the current task to a bucketed event list and delay it for a
+ *        specified number of ticks
+ * @param list: The bucketed event list to add the task to
+ * @param ticks_to_wait:
+ *      The number of ticks to wait before the task is ready to run again
+ * @return None
+ */
+void task_add_current_to_bucketed_list(EventList_t *list,
+                                       uint32_t ticks_to_wait) {
+    OCTOS_ASSERT(ticks_to_wait > 0 && ticks_to_wait <= UINT32_MAX);
+    OCTOS_ASSERT(list_item_parent(&(current_tcb->EventListItem)) == NULL);
+
+    list_item_set_value(&(current_tcb->EventListItem), current_tcb->Priority);
+    task_insert_bucketed(list, &(current_tcb->EventListItem));
+    task_remove_and_add_current_to_delayed_list(ticks_to_wait);
+    yield_pending |= true;
+}
+
+/**
+ * @brief Remove the highest priority task from a bucketed event list
+ * @note Tasks of the same priority are released in FIFO order
+ * @param list: The bucketed event list to remove the task from
+ * @retval true Removed task has a higher priority than the current task
+ * @retval false Otherwise
+ */
+bool task_remove_highest_priority_from_bucketed_list(EventList_t *list) {
+    for (int32_t i = sizeof(list->Waiting) / sizeof(uint32_t) - 1; i >= 0;
+         i--) {
+        const uint32_t word = list->Waiting[i];
+        if (word == 0) continue;
+
+        const uint32_t priority = i * 32 + 31 - __builtin_clz(word);
+        return task_remove_from_event_list(
+                LIST_ITEM_OWNER(list_head(&(list->Buckets[priority])), TCB_t,
+                                EventListItem));
+    }
+
+    return false;
+}
+
+/**
+ * @brief Remove a specific task from the event list it is waiting on
+ * @note This function is not protected by any critical section or scheduler
+ *       suspension
+ * @param handle: Pointer to the TCB of the task to remove
+ * @retval true Removed task has a higher priority than the current task
+ * @retval false Otherwise
+ */
+bool task_remove_from_event_list(TaskHandle_t handle) {
+    bool switch_required = false;
+
+    ListItem_t *const item = &(handle->EventListItem);
+    task_remove_event_item(item);
+    if (list_item_get_value(item) != handle->Priority)
+        list_item_set_value(item, handle->Priority);
+
+    switch_required = task_remove_from_delayed_list(handle);
     yield_pending |= switch_required;
 
     if (scheduler_suspended > 0) {
-        list_insert_end(&pending_ready_list, &(owner->EventListItem));
+        list_insert_end(&pending_ready_list, item);
     } else {
-        task_add_to_ready_list(owner);
+        task_add_to_ready_list(handle);
     }
 
     return switch_required;
 }
 
+/**
+ * @brief Add the current task to an event group waiting list
+ * @note The wait condition is stored in the TCB, so that the task setting
+ *       the bits can evaluate every waiter in a single pass
+ * @param list: The event list to add the task to
+ * @param bits: The event group bits to wait for
+ * @param flags: Wait flags (taskEVENT_WAIT_ALL, taskEVENT_CLEAR_ON_EXIT)
+ * @param ticks_to_wait:
+ *      The number of ticks to wait before the task is ready to run again
+ * @return None
+ */
+void task_add_current_to_event_group_list(List_t *list, uint32_t bits,
+                                          uint8_t flags,
+                                          uint32_t ticks_to_wait) {
+    current_tcb->EventBits = bits;
+    current_tcb->EventFlags = flags & ~taskEVENT_DELIVERED;
+    task_add_current_to_event_list(list, ticks_to_wait);
+}
+
+/**
+ * @brief Take the event group bits delivered to the current task
+ * @note Must call within critical section
+ * @param bits: Pointer to store the delivered event group bits
+ * @retval true Bits were delivered by an event group setter
+ * @retval false Otherwise
+ */
+bool task_take_event_bits(uint32_t *bits) {
+    if ((current_tcb->EventFlags & taskEVENT_DELIVERED) == 0) return false;
+
+    *bits = current_tcb->EventBits;
+    current_tcb->EventFlags = 0;
+
+    return true;
+}
+
 
 /* Task Create and Delete ----------------------------------------------------*/
 
@@ -519,6 +978,66 @@ bool task_create_static(TaskFunc_t func, void *args, const char *name,
     return true;
 }
 
+/**
+ * @brief Create the tasks defined with OCTOS_TASK_DEFINE
+ * @note Called by kernel_launch. Only the TCB is cleared, the pages already
+ *       live in .bss or in uninitialized CCM RAM and are not memset
+ * @return None
+ */
+void task_create_defined(void) {
+    for (const TaskDefine_t *define = __start_octos_tasks;
+         define < __stop_octos_tasks; define++) {
+        OCTOS_ASSERT(define->Priority < OCTOS_MAX_PRIORITIES);
+
+        Page_t page = {0};
+        page.policy = PAGE_POLICY_STATIC;
+        page.size = define->PageSize;
+        page.raw = define->Page;
+        memset(page.raw, 0, sizeof(TCB_t));
+
+        TCB_t *tcb = tcb_build(&page, define->Func, define->Args,
+                               define->Name, define->Priority);
+
+        task_suspend_all();
+        task_create_postprocess(tcb);
+        task_resume_all();
+
+        *(define->Handle) = tcb;
+    }
+}
+
+/**
+ * @brief Create a periodic task
+ * @note The job function is called once per period and must return. The
+ *       first job is released one period after creation
+ * @param periodic: Pointer to the periodic task structure, owned by caller
+ * @param func: Pointer to the job function
+ * @param args: Pointer to the arguments passed to the job function
+ * @param name: Name of the task (for debugging purposes)
+ * @param priority: Priority of the task (must be less than OCTOS_MAX_PRIORITIES)
+ * @param page_size_in_words: Size of the task stack in words
+ * @param period_ticks: Period in ticks
+ * @param deadline_ticks: Deadline relative to release, 0 for the period
+ * @param handle: Pointer to store the task handle (can be NULL if not needed)
+ * @retval true Task was created successfully
+ * @retval false Task creation failed
+ */
+bool task_create_periodic(TaskPeriodic_t *periodic, TaskFunc_t func,
+                          void *args, const char *name, uint8_t priority,
+                          size_t page_size_in_words, uint32_t period_ticks,
+                          uint32_t deadline_ticks, TaskHandle_t *handle) {
+    OCTOS_ASSERT(period_ticks > 0 && period_ticks < UINT32_MAX);
+
+    periodic->Func = func;
+    periodic->Args = args;
+    periodic->Period = period_ticks;
+    periodic->Deadline = deadline_ticks > 0 ? deadline_ticks : period_ticks;
+    memset(&(periodic->Stats), 0, sizeof(periodic->Stats));
+
+    return task_create(&task_periodic_thread, periodic, name, priority,
+                       page_size_in_words, handle);
+}
+
 /**
  * @brief Deletes task and moves it to terminated state
  * @param handle: Pointer to task control block to delete
@@ -529,6 +1048,9 @@ void task_delete(TaskHandle_t handle) {
 
     OCTOS_ENTER_CRITICAL();
 
+    /* A task may not leave the kernel while still on the ISR wake stack */
+    task_isr_wake_drain();
+
     if (!handle || task_status(handle) == TERMINATED) {
         OCTOS_EXIT_CRITICAL();
         return;
@@ -559,70 +1081,29 @@ void task_delete(TaskHandle_t handle) {
  * @return None
  */
 void task_release(TaskHandle_t handle) {
-    OCTOS_ASSERT(handle->StateListItem.Parent == &terminated_list);
+    OCTOS_ASSERT(list_item_parent(&(handle->StateListItem)) ==
+                 &terminated_list);
     list_remove(&(handle->StateListItem));
-    if (handle->Page.policy == PAGE_POLICY_DYNAMIC)
-        OCTOS_FREE(handle->Page.raw);
+    if (handle->PagePolicy == PAGE_POLICY_DYNAMIC) OCTOS_FREE(handle);
 }
 
 /* Task Core Operation -------------------------------------------------------*/
 
 /** 
  * @brief Increment the task tick and handle delayed tasks
+ * @note While the scheduler is suspended the tick is pended, and caught up
+ *       by task_resume_all()
  * @param None
  * @retval true Context switch is required
  * @retval false Context switch is not required
  */
 bool task_tick_increment(void) {
-    bool switch_required = false;
-
     if (scheduler_suspended > 0) {
         pended_ticks++;
-    } else {
-        current_tick++;
-        const uint32_t const_tick = current_tick;
-
-        /* Tick overflow, switch delayed list */
-        if (const_tick == 0) {
-            tick_overflows++;
-            List_t *temp;
-            temp = delayed_list;
-            delayed_list = delayed_list_overflow;
-            delayed_list_overflow = temp;
-            task_reset_next_unblock_tick();
-        }
-
-        /* Wake delayed task if needed */
-        if (const_tick >= next_task_unblock_tick) {
-            while (true) {
-                if (delayed_list->Length == 0) {
-                    next_task_unblock_tick = UINT32_MAX;
-                    break;
-                }
-
-                ListItem_t *head = list_head(delayed_list);
-                uint32_t head_item_value = head->Value;
-
-                if (const_tick < head_item_value) {
-                    next_task_unblock_tick = head_item_value;
-                    break;
-                }
-
-                TCB_t *head_owner = head->Owner;
-                switch_required |= task_remove_from_delayed_list(head_owner);
-                list_remove(&(head_owner->EventListItem));
-                task_add_to_ready_list(head_owner);
-            }
-        }
-
-        /* Round robin within same priority */
-        switch_required |= current_tcb->StateListItem.Parent->Length > 1;
-
-        /* Yield pending */
-        switch_required |= yield_pending;
+        return false;
     }
 
-    return switch_required;
+    return task_tick_advance(1);
 }
 
 /** 
@@ -634,6 +1115,7 @@ void task_context_switch(void) {
     if (scheduler_suspended > 0) {
         yield_pending = true;
     } else {
+        task_isr_wake_drain();
         yield_pending = false;
         task_select_highest_priority();
     }
@@ -641,30 +1123,29 @@ void task_context_switch(void) {
 
 /**
  * @brief Safely retrieves the current system tick value
- * @note Uses critical section to prevent race conditions
+ * @note Lock-free, the 64-bit tick does not wrap in practice
  * @param None
  * @return Current system tick value
  */
-uint32_t task_get_tick(void) {
-    OCTOS_ENTER_CRITICAL();
-    const uint32_t return_tick = current_tick;
-    OCTOS_EXIT_CRITICAL();
-    return return_tick;
-}
+Tick_t task_get_tick(void) { return task_read_tick(); }
 
 /**
  * @brief Safely retrieves the current system tick value from an
  *        Interrupt Service Routine (ISR)
- * @note Uses ISR-specific critical section handling
+ * @note Lock-free, see task_get_tick()
  * @param None
  * @return Current system tick value
  */
-uint32_t task_get_tick_from_isr(void) {
-    uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
-    uint32_t return_tick = current_tick;
-    OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
-    return return_tick;
-}
+Tick_t task_get_tick_from_isr(void) { return task_read_tick(); }
+
+/**
+ * @brief Get the number of ticks since the kernel launched
+ * @note Must call within critical section. Ticks pended while the scheduler
+ *       is suspended are counted
+ * @param None
+ * @return 64-bit tick count
+ */
+Tick_t task_get_elapsed_ticks(void) { return task_read_tick() + pended_ticks; }
 
 /**
  * @brief Increment the mutex held count for the current task
@@ -692,111 +1173,58 @@ bool task_mutex_held_decrement(TaskHandle_t mutex_owner) {
 }
 
 /**
- * @brief Inherit the priority of the current task to the mutex owner
- * @note This function is used to prevent priority inversion
- * @param mutex_owner: Pointer to the TCB of the task that owns the mutex
- * @retval true Priority inheritance occurred
- * @retval false Priority inheritance has not occurred
- */
-bool task_inherit_priority(TaskHandle_t mutex_owner) {
-    bool inheritance_occured = false;
-
-    if (!mutex_owner) return inheritance_occured;
-
-    if (mutex_owner->Priority < current_tcb->Priority) {
-        if (task_status(mutex_owner) == READY) {
-            /* If a task status is ready, it means 
-             *
-             * 1. It is not in any event list, so we can safely modify 
-             *    the EventListItem value
-             * 2. It is okay to remove StateListItem from its parent,
-             *    because the parent is not delayed or suspended
-             *    list 
-             */
-            if (list_remove(&(mutex_owner->StateListItem)))
-                task_reset_ready_priority(mutex_owner->Priority);
-
-            mutex_owner->Priority = current_tcb->Priority;
-
-            list_item_set_value(&(mutex_owner->EventListItem),
-                                mutex_owner->Priority);
-
-            task_add_to_ready_list(mutex_owner);
-        } else {
-            mutex_owner->Priority = current_tcb->Priority;
-        }
-    } else if (mutex_owner->RootPriority < current_tcb->Priority) {
-        inheritance_occured = true;
-    }
-
-    return inheritance_occured;
-}
-
-/**
- * @brief De-inherit the priority of the current task from the mutex owner
- * @note This function is used to restore the original priority of the task
- * @param mutex_owner: Pointer to the TCB of the task that owns the mutex
+ * @brief Change the effective priority of a task
+ * @note The root priority is left untouched. A ready task is moved to the
+ *       ready list of its new priority, and a task waiting on an event list
+ *       is repositioned so that the list stays sorted by priority
+ * @note This function is not protected by any critical section or scheduler
+ *       suspension
+ * @param handle: Pointer to the TCB of the task
+ * @param priority: The new effective priority
  * @retval true Context switch is required
  * @retval false Context switch is not required
  */
-bool task_deinherit_priority(TaskHandle_t mutex_owner) {
-    bool switch_required = false;
-
-    if (!mutex_owner) return switch_required;
-
-    OCTOS_ASSERT(mutex_owner == current_tcb);
+bool task_set_effective_priority(TaskHandle_t handle, uint8_t priority) {
+    OCTOS_ASSERT(priority < OCTOS_MAX_PRIORITIES);
 
-    if (mutex_owner->Priority != mutex_owner->RootPriority &&
-        mutex_owner->MutexHeld == 0) {
-        if (list_remove(&(mutex_owner->StateListItem)))
-            task_reset_ready_priority(mutex_owner->Priority);
+    const uint8_t old_priority = handle->Priority;
+    if (old_priority == priority) return false;
 
-        mutex_owner->Priority = mutex_owner->RootPriority;
+    ListItem_t *const state_item = &(handle->StateListItem);
+    ListItem_t *const event_item = &(handle->EventListItem);
+    List_t *const event_list = list_item_parent(event_item);
+    bool switch_required = false;
 
-        list_item_set_value(&(mutex_owner->EventListItem),
-                            mutex_owner->Priority);
+    if (list_item_parent(state_item) == &ready_list[old_priority]) {
+        list_remove(state_item);
+        task_reset_ready_priority(old_priority);
+        handle->Priority = priority;
+        task_add_to_ready_list(handle);
 
-        task_add_to_ready_list(mutex_owner);
-        switch_required = true;
-        yield_pending = true;
+        switch_required = handle == current_tcb
+                                  ? priority < old_priority
+                                  : priority > current_tcb->Priority;
+    } else {
+        handle->Priority = priority;
     }
 
-    return switch_required;
-}
-
-/**
- * @brief De-inherit the priority of the current task from the mutex owner
- *        after a timeout
- * @note This function is used to restore the original priority of the
- *       task after a timeout
- * @param mutex_owner: Pointer to the TCB of the task that owns the mutex
- * @param highest_priority_of_waiting_tasks:
- *      The highest priority of tasks waiting for the mutex
- * @return None
- */
-void task_deinherit_priority_after_timeout(
-        TaskHandle_t mutex_owner, uint8_t highest_priority_of_waiting_tasks) {
-    if (!mutex_owner) return;
-
-    OCTOS_ASSERT(mutex_owner == current_tcb);
-
-    uint8_t priority_deinherit_to =
-            highest_priority_of_waiting_tasks > mutex_owner->RootPriority
-                    ? highest_priority_of_waiting_tasks
-                    : mutex_owner->RootPriority;
-
-    if (mutex_owner->Priority != priority_deinherit_to &&
-        mutex_owner->MutexHeld == 0) {
-        if (list_remove(&(mutex_owner->StateListItem)))
-            task_reset_ready_priority(mutex_owner->Priority);
-
-        mutex_owner->Priority = priority_deinherit_to;
+    if (event_list != NULL && event_list->End.Value == taskEVENT_BUCKET_END) {
+        EventList_t *const owner = task_bucket_owner(
+                event_list, list_item_get_value(event_item));
+        task_remove_event_item(event_item);
+        list_item_set_value(event_item, priority);
+        task_insert_bucketed(owner, event_item);
+    } else if (event_list != NULL && event_list != &pending_ready_list) {
+        list_remove(event_item);
+        list_item_set_value(event_item, priority);
+        list_insert(event_list, event_item);
+    } else {
+        list_item_set_value(event_item, priority);
+    }
 
-        list_item_set_value(&(mutex_owner->EventListItem),
-                            mutex_owner->Priority);
+    yield_pending |= switch_required;
 
-        task_add_to_ready_list(mutex_owner);
-    }
+    return switch_required;
 }
 
 /* Task Basic Operation ------------------------------------------------------*/
@@ -856,33 +1284,50 @@ void task_suspend_all(void) {
  */
 bool task_resume_all(void) {
     bool already_yielded = false;
+    bool readied = false;
+
+    OCTOS_ASSERT(scheduler_suspended > 0);
+
+    /* Ready the tasks woken from ISRs during the suspension */
+    if (scheduler_suspended == 1) task_isr_wake_drain();
 
     OCTOS_ENTER_CRITICAL();
 
-    OCTOS_ASSERT(scheduler_suspended > 0);
-    scheduler_suspended--;
-    if (scheduler_suspended > 0) {
+    if (scheduler_suspended > 1) {
+        scheduler_suspended--;
         OCTOS_EXIT_CRITICAL();
         return false;
     }
 
+    /* The scheduler stays suspended while pending tasks are readied, so the
+     * critical section can be left after each one to bound interrupt masking */
     while (pending_ready_list.Length > 0) {
         /* EventListItem related operations */
         ListItem_t *const item = list_head(&pending_ready_list);
         list_remove(item);
 
-        TCB_t *const owner = item->Owner;
+        TCB_t *const owner = LIST_ITEM_OWNER(item, TCB_t, EventListItem);
 
         /* StateListItem related operations */
         list_remove(&(owner->StateListItem));
         task_add_to_ready_list(owner);
 
         yield_pending |= owner->Priority > current_tcb->Priority;
+        readied = true;
+
+        OCTOS_EXIT_CRITICAL();
+        OCTOS_ENTER_CRITICAL();
     }
 
-    while (pended_ticks > 0) {
-        yield_pending |= task_tick_increment();
-        pended_ticks--;
+    /* Delayed list removals above may have taken the head */
+    if (readied) task_reset_next_unblock_tick();
+
+    scheduler_suspended--;
+
+    /* Ticks elapsed during the suspension are caught up in one advance */
+    if (pended_ticks > 0) {
+        yield_pending |= task_tick_advance(pended_ticks);
+        pended_ticks = 0;
     }
 
     OCTOS_EXIT_CRITICAL();
@@ -918,6 +1363,44 @@ void task_delay(uint32_t ticks_to_delay) {
     if (!already_yielded) OCTOS_YIELD();
 }
 
+/**
+ * @brief Delay the current task until the next period boundary
+ * @note Wake ticks are derived from the previous one, so the period does
+ *       not drift with the execution time of the task
+ * @param previous_wake_tick:
+ *      Pointer to the previous wake tick, initialize it with task_get_tick().
+ *      Updated to the new wake tick
+ * @param period_ticks: Period in ticks
+ * @retval true If the task was delayed
+ * @retval false If the wake tick already passed, the task is late
+ */
+bool task_delay_until(Tick_t *previous_wake_tick, uint32_t period_ticks) {
+    OCTOS_ASSERT(period_ticks > 0 && period_ticks < UINT32_MAX);
+
+    bool should_delay = false;
+    bool already_yielded = false;
+
+    /* ISR cannot modify delayed_list, so we use scheduler suspension here */
+    task_suspend_all();
+
+    const Tick_t now = task_read_tick();
+    const Tick_t wake_tick = *previous_wake_tick + period_ticks;
+    *previous_wake_tick = wake_tick;
+
+    if (wake_tick > now) {
+        OCTOS_ASSERT(wake_tick - now < UINT32_MAX);
+        should_delay = true;
+        task_remove_and_add_current_to_delayed_list(
+                (uint32_t) (wake_tick - now));
+    }
+
+    already_yielded = task_resume_all();
+
+    if (should_delay && !already_yielded) OCTOS_YIELD();
+
+    return should_delay;
+}
+
 /**
  * @brief Abort the delay of a task
  * @param handle: Pointer to the TCB of the task to abort the delay
@@ -927,8 +1410,8 @@ void task_abort_delay(TaskHandle_t handle) {
     /* ISR cannot modify delayed_list, so we use scheduler suspension here */
     task_suspend_all();
 
-    List_t *const parent = handle->StateListItem.Parent;
-    if (parent == delayed_list || parent == delayed_list_overflow) {
+    List_t *const parent = list_item_parent(&(handle->StateListItem));
+    if (parent == &delayed_list) {
         /* When scheduler is suspended, ISR cannot modify StateListItem, so
          * it is safe to proceed without critical section */
         yield_pending |= task_remove_from_delayed_list(handle);
@@ -936,7 +1419,7 @@ void task_abort_delay(TaskHandle_t handle) {
         /* If possible, remove task from its event list, critical section
          * is needed beacause ISR might modify EventListItem */
         OCTOS_ENTER_CRITICAL();
-        list_remove(&(handle->EventListItem));
+        task_remove_event_item(&(handle->EventListItem));
         OCTOS_EXIT_CRITICAL();
 
         task_add_to_ready_list(handle);
@@ -961,6 +1444,9 @@ void task_suspend(TaskHandle_t handle) {
      * instead of scheduler suspension */
     OCTOS_ENTER_CRITICAL();
 
+    /* Wakes from ISRs happened before the suspension */
+    task_isr_wake_drain();
+
     if (handle == NULL) {
         task_to_suspend = current_tcb;
     } else {
@@ -982,12 +1468,14 @@ void task_suspend(TaskHandle_t handle) {
     list_insert_end(&suspended_list, item);
 
     /* Remove task from event list (if possible) */
-    list_remove(&(task_to_suspend->EventListItem));
+    task_remove_event_item(&(task_to_suspend->EventListItem));
 
     /* The task was blocked to wait for a notification, but is
      * now suspended, so no notification was received. */
-    if (task_to_suspend->NotifyState == PENDING)
-        task_to_suspend->NotifyState = IDLE;
+    for (size_t i = 0; i < OCTOS_TASK_NOTIFY_SLOTS; i++) {
+        if (task_to_suspend->NotifyState[i] == PENDING)
+            task_to_suspend->NotifyState[i] = IDLE;
+    }
 
     switch_required = task_to_suspend == current_tcb;
     if (switch_required && scheduler_suspended > 0) {
@@ -1044,10 +1532,6 @@ void task_resume(TaskHandle_t handle) {
 void task_resume_from_isr(TaskHandle_t handle) {
     OCTOS_ASSERT_IF_INTERRUPT_PRIORITY_INVALID();
 
-    bool switch_required = false;
-
-    /* ISR can modify suspended_list, so we use critical section 
-     * instead of scheduler suspension */
     uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
 
     if (task_status(handle) != SUSPENDED) {
@@ -1055,14 +1539,10 @@ void task_resume_from_isr(TaskHandle_t handle) {
         return;
     }
 
-    if (scheduler_suspended == 0) {
-        switch_required = task_remove_from_delayed_list(handle);
-        task_add_to_ready_list(handle);
-    } else {
-        /* No need to set yield_pending here, task_resume_all will do it
-         * for us while resuming the scheduler */
-        list_insert_end(&pending_ready_list, &(handle->EventListItem));
-    }
+    /* The scheduler lists are left to the next context switch or tick, which
+     * readies the task before anything else may run */
+    task_isr_wake_push(handle);
+    const bool switch_required = handle->Priority > current_tcb->Priority;
 
     OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
 
@@ -1070,16 +1550,20 @@ void task_resume_from_isr(TaskHandle_t handle) {
 }
 
 /**
- * @brief Notify a task with a value and a specific action
- * @note If the task is pending, it will be moved to the ready list
+ * @brief Notify a task through a notification slot with a value and a
+ *        specific action
+ * @note If the task is pending on that slot, it will be moved to the ready
+ *       list
  * @param handle: Pointer to the TCB of the task to notify
+ * @param index: Index of the notification slot
  * @param value: The value to notify the task with
  * @param action: The action to perform on the notification value
  * @retval true Notification was successful
  * @retval false Notification failed (e.g., TrySet on a received state)
  */
-bool task_notify(TaskHandle_t handle, uint32_t value,
-                 TaskNotifyAction_t action) {
+bool task_notify_indexed(TaskHandle_t handle, size_t index, uint32_t value,
+                         TaskNotifyAction_t action) {
+    OCTOS_ASSERT(index < OCTOS_TASK_NOTIFY_SLOTS);
     bool success = true;
     bool switch_required = false;
 
@@ -1087,21 +1571,22 @@ bool task_notify(TaskHandle_t handle, uint32_t value,
      * section */
     OCTOS_ENTER_CRITICAL();
 
-    TaskNotifyState_t original_state = handle->NotifyState;
-    handle->NotifyState = RECEIVED;
+    TaskNotifyState_t original_state = handle->NotifyState[index];
+    handle->NotifyState[index] = RECEIVED;
 
     switch (action) {
         case BitwiseOr:
-            handle->NotifiedValue |= value;
+            handle->NotifiedValue[index] |= value;
             break;
         case Increment:
-            handle->NotifiedValue++;
+            handle->NotifiedValue[index]++;
             break;
         case OverwriteSet:
-            handle->NotifiedValue = value;
+            handle->NotifiedValue[index] = value;
             break;
         case TrySet:
-            if (original_state != RECEIVED) handle->NotifiedValue = value;
+            if (original_state != RECEIVED)
+                handle->NotifiedValue[index] = value;
             else
                 success = false;
             break;
@@ -1114,7 +1599,7 @@ bool task_notify(TaskHandle_t handle, uint32_t value,
      * Because ready_list modification is even okay in scheduler suspension
      * with critical section */
     if (original_state == PENDING) {
-        OCTOS_ASSERT(handle->EventListItem.Parent == NULL);
+        OCTOS_ASSERT(list_item_parent(&(handle->EventListItem)) == NULL);
         switch_required = task_remove_from_delayed_list(handle);
         task_add_to_ready_list(handle);
     }
@@ -1127,9 +1612,12 @@ bool task_notify(TaskHandle_t handle, uint32_t value,
 }
 
 /**
- * @brief Notify a task with a value and a specific action from an ISR
- * @note If the task is pending, it will be moved to the ready list
+ * @brief Notify a task through a notification slot with a value and a
+ *        specific action from an ISR
+ * @note If the task is pending on that slot, it will be moved to the ready
+ *       list
  * @param handle: Pointer to the TCB of the task to notify
+ * @param index: Index of the notification slot
  * @param value: The value to notify the task with
  * @param action: The action to perform on the notification value
  * @param switch_required: 
@@ -1137,29 +1625,31 @@ bool task_notify(TaskHandle_t handle, uint32_t value,
  * @retval true Notification was successful
  * @retval false Notification failed (e.g., TrySet on a received state)
  */
-bool task_notify_from_isr(TaskHandle_t handle, uint32_t value,
-                          TaskNotifyAction_t action,
-                          bool *const switch_required) {
+bool task_notify_indexed_from_isr(TaskHandle_t handle, size_t index,
+                                  uint32_t value, TaskNotifyAction_t action,
+                                  bool *const switch_required) {
     OCTOS_ASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+    OCTOS_ASSERT(index < OCTOS_TASK_NOTIFY_SLOTS);
     bool success = true;
 
     uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
 
-    TaskNotifyState_t original_state = handle->NotifyState;
-    handle->NotifyState = RECEIVED;
+    TaskNotifyState_t original_state = handle->NotifyState[index];
+    handle->NotifyState[index] = RECEIVED;
 
     switch (action) {
         case BitwiseOr:
-            handle->NotifiedValue |= value;
+            handle->NotifiedValue[index] |= value;
             break;
         case Increment:
-            handle->NotifiedValue++;
+            handle->NotifiedValue[index]++;
             break;
         case OverwriteSet:
-            handle->NotifiedValue = value;
+            handle->NotifiedValue[index] = value;
             break;
         case TrySet:
-            if (original_state != RECEIVED) handle->NotifiedValue = value;
+            if (original_state != RECEIVED)
+                handle->NotifiedValue[index] = value;
             else
                 success = false;
             break;
@@ -1167,17 +1657,7 @@ bool task_notify_from_isr(TaskHandle_t handle, uint32_t value,
             break;
     }
 
-    if (original_state == PENDING) {
-        OCTOS_ASSERT(handle->EventListItem.Parent == NULL);
-        if (scheduler_suspended == 0) {
-            *switch_required = task_remove_from_delayed_list(handle);
-            task_add_to_ready_list(handle);
-        } else {
-            *switch_required = handle->Priority > current_tcb->Priority;
-            list_insert_end(&pending_ready_list, &(handle->EventListItem));
-        }
-        yield_pending |= *switch_required;
-    }
+    if (original_state == PENDING) *switch_required = task_notify_wake(handle);
 
     OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
 
@@ -1185,8 +1665,10 @@ bool task_notify_from_isr(TaskHandle_t handle, uint32_t value,
 }
 
 /**
- * @brief Wait for a task notification with optional timeout
+ * @brief Wait for a notification on a notification slot with optional
+ *        timeout
  * @note Clears specified bits on entry and exit
+ * @param index: Index of the notification slot
  * @param bits_to_clear_on_entry: 
  *      Bits to clear in the notification value on entry
  * @param bits_to_clear_on_exit: 
@@ -1196,9 +1678,10 @@ bool task_notify_from_isr(TaskHandle_t handle, uint32_t value,
  * @retval true Notification was received successfully
  * @retval false Notification was not received (e.g., timeout)
  */
-bool task_notify_wait(uint32_t bits_to_clear_on_entry,
-                      uint32_t bits_to_clear_on_exit, uint32_t *buffer,
-                      uint32_t timeout_ticks) {
+bool task_notify_wait_indexed(size_t index, uint32_t bits_to_clear_on_entry,
+                              uint32_t bits_to_clear_on_exit, uint32_t *buffer,
+                              uint32_t timeout_ticks) {
+    OCTOS_ASSERT(index < OCTOS_TASK_NOTIFY_SLOTS);
     bool success = false;
     bool should_block = false;
 
@@ -1208,10 +1691,10 @@ bool task_notify_wait(uint32_t bits_to_clear_on_entry,
         /* Modification on NotifyState and NotifiedValue need critical
          * section */
         OCTOS_ENTER_CRITICAL();
-        if (current_tcb->NotifyState != RECEIVED) {
-            OCTOS_ASSERT(current_tcb->NotifyState == IDLE);
-            current_tcb->NotifiedValue &= ~bits_to_clear_on_entry;
-            current_tcb->NotifyState = PENDING;
+        if (current_tcb->NotifyState[index] != RECEIVED) {
+            OCTOS_ASSERT(current_tcb->NotifyState[index] == IDLE);
+            current_tcb->NotifiedValue[index] &= ~bits_to_clear_on_entry;
+            current_tcb->NotifyState[index] = PENDING;
             should_block = true;
         }
         OCTOS_EXIT_CRITICAL();
@@ -1229,18 +1712,176 @@ bool task_notify_wait(uint32_t bits_to_clear_on_entry,
     /* Modification on NotifyState and NotifiedValue need critical
      * section */
     OCTOS_ENTER_CRITICAL();
-    if (buffer != NULL) *buffer = current_tcb->NotifiedValue;
+    if (buffer != NULL) *buffer = current_tcb->NotifiedValue[index];
 
-    if (current_tcb->NotifyState != RECEIVED) {
+    if (current_tcb->NotifyState[index] != RECEIVED) {
         success = false;
     } else {
-        current_tcb->NotifiedValue &= ~bits_to_clear_on_exit;
+        current_tcb->NotifiedValue[index] &= ~bits_to_clear_on_exit;
         success = true;
     }
 
-    current_tcb->NotifyState = IDLE;
+    current_tcb->NotifyState[index] = IDLE;
 
     OCTOS_EXIT_CRITICAL();
 
     return success;
 }
+
+/**
+ * @brief Notify a task with a value and a specific action
+ * @note Uses notification slot 0
+ * @param handle: Pointer to the TCB of the task to notify
+ * @param value: The value to notify the task with
+ * @param action: The action to perform on the notification value
+ * @retval true Notification was successful
+ * @retval false Notification failed (e.g., TrySet on a received state)
+ */
+bool task_notify(TaskHandle_t handle, uint32_t value,
+                 TaskNotifyAction_t action) {
+    return task_notify_indexed(handle, 0, value, action);
+}
+
+/**
+ * @brief Notify a task with a value and a specific action from an ISR
+ * @note Uses notification slot 0
+ * @param handle: Pointer to the TCB of the task to notify
+ * @param value: The value to notify the task with
+ * @param action: The action to perform on the notification value
+ * @param switch_required: 
+ *      Pointer to a boolean indicating if a context switch is required
+ * @retval true Notification was successful
+ * @retval false Notification failed (e.g., TrySet on a received state)
+ */
+bool task_notify_from_isr(TaskHandle_t handle, uint32_t value,
+                          TaskNotifyAction_t action,
+                          bool *const switch_required) {
+    return task_notify_indexed_from_isr(handle, 0, value, action,
+                                        switch_required);
+}
+
+/**
+ * @brief Wait for a task notification with optional timeout
+ * @note Uses notification slot 0
+ * @param bits_to_clear_on_entry: 
+ *      Bits to clear in the notification value on entry
+ * @param bits_to_clear_on_exit: 
+ *      Bits to clear in the notification value on exit
+ * @param buffer: Pointer to store the notification value (can be NULL)
+ * @param timeout_ticks: Timeout in ticks (0 for no timeout)
+ * @retval true Notification was received successfully
+ * @retval false Notification was not received (e.g., timeout)
+ */
+bool task_notify_wait(uint32_t bits_to_clear_on_entry,
+                      uint32_t bits_to_clear_on_exit, uint32_t *buffer,
+                      uint32_t timeout_ticks) {
+    return task_notify_wait_indexed(0, bits_to_clear_on_entry,
+                                    bits_to_clear_on_exit, buffer,
+                                    timeout_ticks);
+}
+
+/* Periodic Task -------------------------------------------------------------*/
+
+/**
+ * @brief Get a consistent copy of the statistics of a periodic task
+ * @param periodic: Pointer to the periodic task structure
+ * @param stats: Pointer to store the statistics
+ * @return None
+ */
+void task_periodic_get_stats(TaskPeriodic_t *periodic,
+                             TaskPeriodicStats_t *stats) {
+    OCTOS_ENTER_CRITICAL();
+    *stats = periodic->Stats;
+    OCTOS_EXIT_CRITICAL();
+}
+
+/**
+ * @brief Reset the statistics of a periodic task
+ * @param periodic: Pointer to the periodic task structure
+ * @return None
+ */
+void task_periodic_reset_stats(TaskPeriodic_t *periodic) {
+    OCTOS_ENTER_CRITICAL();
+    memset(&(periodic->Stats), 0, sizeof(periodic->Stats));
+    OCTOS_EXIT_CRITICAL();
+}
+
+/* Continuation --------------------------------------------------------------*/
+
+/**
+ * @brief Arm a continuation on the continuation chain of a kernel object
+ * @note Arm before checking the condition waited for, a signal in between
+ *       then runs the continuation instead of being missed
+ * @param chain: Pointer to the continuation chain of the object
+ * @param continuation: Pointer to the continuation, not armed elsewhere
+ * @return None
+ */
+void task_continuation_arm(TaskContinuation_t **chain,
+                           TaskContinuation_t *continuation) {
+    OCTOS_ENTER_CRITICAL();
+
+    OCTOS_ASSERT(continuation->Chain == NULL);
+    continuation->Next = *chain;
+    continuation->Chain = chain;
+    *chain = continuation;
+
+    OCTOS_EXIT_CRITICAL();
+}
+
+/**
+ * @brief Disarm a continuation if it was not run yet
+ * @param continuation: Pointer to the continuation
+ * @retval true If the continuation was still armed
+ * @retval false If it was run or never armed
+ */
+bool task_continuation_disarm(TaskContinuation_t *continuation) {
+    OCTOS_ENTER_CRITICAL();
+
+    TaskContinuation_t **link = continuation->Chain;
+    const bool armed = link != NULL;
+    if (armed) {
+        while (*link != continuation) link = &((*link)->Next);
+        *link = continuation->Next;
+        continuation->Chain = NULL;
+    }
+
+    OCTOS_EXIT_CRITICAL();
+
+    return armed;
+}
+
+/**
+ * @brief Disarm and run every continuation armed on a chain
+ * @note Use task_continuation_fire()
+ * @note Must call within critical section
+ * @param chain: Pointer to the continuation chain of the object
+ * @param switch_required:
+ *      Pointer to a boolean flag indicating if a context switch is required
+ * @return None
+ */
+void task_continuation_run_all(TaskContinuation_t **chain,
+                               bool *const switch_required) {
+    TaskContinuation_t *continuation = *chain;
+    *chain = NULL;
+
+    while (continuation != NULL) {
+        TaskContinuation_t *const next = continuation->Next;
+        continuation->Chain = NULL;
+
+        TCB_t *const task = continuation->Task;
+        if (continuation->Func(continuation) &&
+            task->NotifyState[taskKERNEL_NOTIFY_INDEX] != RECEIVED) {
+            const bool pending =
+                    task->NotifyState[taskKERNEL_NOTIFY_INDEX] == PENDING;
+            task->NotifyState[taskKERNEL_NOTIFY_INDEX] = RECEIVED;
+
+            /* May run in an ISR, the task is readied as from one */
+            if (pending) {
+                const bool woken = task_notify_wake(task);
+                if (switch_required != NULL) *switch_required |= woken;
+            }
+        }
+
+        continuation = next;
+    }
+}
@@ -0,0 +1,356 @@
+#include <stdint.h>
+
+#include "Arch/port.h"
+#include "list.h"
+#include "sync.h"
+#include "task.h"
+#include "workq.h"
+
+#define workRUNNING ((uint8_t) 1) /* Function running on a worker */
+#define workRERUN ((uint8_t) 2)   /* Submitted again while running */
+
+/* Private Helpers -----------------------------------------------------------*/
+
+/**
+ * @brief Check if a work item is pending, delayed or due to run again
+ * @note Must call within critical section
+ * @param work: Pointer to the work item
+ * @retval true If the work item is submitted and has not started running
+ * @retval false Otherwise
+ */
+OCTOS_INLINE static inline bool workq_is_pending(Work_t *work) {
+    return list_item_parent(&(work->Item)) != NULL ||
+           (work->State & workRERUN) != 0;
+}
+
+/**
+ * @brief Insert a work item into the pending list of a work queue
+ * @note Work of equal priority runs in submission order
+ * @note Work still running is only marked, its worker queues it again once
+ *       the function returns so that it never runs on two workers at once
+ * @note Must call within critical section
+ * @param queue: Pointer to the work queue
+ * @param work: Pointer to the work item
+ * @retval true If the work item was added to the pending list
+ * @retval false If it is deferred until it stops running
+ */
+OCTOS_INLINE static inline bool workq_enqueue(WorkQueue_t *queue,
+                                              Work_t *work) {
+    work->Queue = queue;
+
+    if (work->State & workRUNNING) {
+        work->State |= workRERUN;
+        return false;
+    }
+
+    list_item_set_value(&(work->Item), work->Priority);
+    list_insert(&(queue->PendingList), &(work->Item));
+    return true;
+}
+
+/**
+ * @brief Mark a work item done, queue it again if it was resubmitted
+ * @param work: Pointer to the work item that has run
+ * @return None
+ */
+static void workq_finish(Work_t *work) {
+    bool queued = false;
+
+    OCTOS_ENTER_CRITICAL();
+
+    const bool rerun = (work->State & workRERUN) != 0;
+    work->State = 0;
+    if (rerun) queued = workq_enqueue(work->Queue, work);
+
+    OCTOS_EXIT_CRITICAL();
+
+    if (queued) sema_release(&(work->Queue->Sema));
+}
+
+/**
+ * @brief Insert a work item into the delayed list by its due tick
+ * @note Work of equal due tick becomes pending in submission order
+ * @note Must call within critical section
+ * @param queue: Pointer to the work queue
+ * @param work: Pointer to the work item
+ * @return None
+ */
+static void workq_insert_delayed(WorkQueue_t *queue, Work_t *work) {
+    List_t *const delayed_list = &(queue->DelayedList);
+    ListItem_t *position = &(delayed_list->End);
+    ListItem_t *next = list_item_next(position);
+
+    while (next != &(delayed_list->End) &&
+           LIST_ITEM_OWNER(next, Work_t, Item)->DueTick <= work->DueTick) {
+        position = next;
+        next = list_item_next(position);
+    }
+
+    list_insert_after(delayed_list, position, &(work->Item));
+}
+
+/**
+ * @brief Move due delayed work to the pending list
+ * @note Must call within critical section
+ * @param queue: Pointer to the work queue
+ * @param now: The current tick
+ * @return Ticks until the next delayed work is due, UINT32_MAX if none
+ */
+static uint32_t workq_promote(WorkQueue_t *queue, Tick_t now) {
+    List_t *const delayed_list = &(queue->DelayedList);
+
+    while (delayed_list->Length > 0) {
+        ListItem_t *const item = list_head(delayed_list);
+        Work_t *const work = LIST_ITEM_OWNER(item, Work_t, Item);
+
+        if (work->DueTick > now) {
+            queue->NextDueTick = work->DueTick;
+            /* Sleep in bounded steps, UINT32_MAX would wait forever */
+            return work->DueTick - now < UINT32_MAX
+                           ? (uint32_t) (work->DueTick - now)
+                           : UINT32_MAX - 1;
+        }
+
+        list_remove(item);
+        workq_enqueue(queue, work);
+    }
+
+    return UINT32_MAX;
+}
+
+/**
+ * @brief Worker task body
+ * @note Runs pending work highest priority first and sleeps on the queue's
+ *       semaphore until new work is submitted or delayed work is due
+ * @param args: Pointer to the work queue
+ * @return None
+ */
+static void workq_worker(void *args) {
+    WorkQueue_t *const queue = args;
+
+    while (true) {
+        Work_t *work = NULL;
+
+        OCTOS_ENTER_CRITICAL();
+        const uint32_t next = workq_promote(queue, task_get_tick());
+        ListItem_t *const item = list_tail(&(queue->PendingList));
+        if (item != NULL) {
+            list_remove(item);
+            work = LIST_ITEM_OWNER(item, Work_t, Item);
+            work->State = workRUNNING;
+        }
+        OCTOS_EXIT_CRITICAL();
+
+        if (work != NULL) {
+            work->Func(work->Args);
+            workq_finish(work);
+        } else {
+            sema_acquire(&(queue->Sema), next);
+        }
+    }
+}
+
+/* Work ----------------------------------------------------------------------*/
+
+/**
+ * @brief Initialize a work item
+ * @param work: Pointer to the work item
+ * @param func: Function to run
+ * @param args: Arguments passed to the function
+ * @param priority: Priority within the queue, higher runs first
+ * @return None
+ */
+void work_init(Work_t *work, WorkFunc_t func, void *args, uint8_t priority) {
+    list_item_init(&(work->Item));
+    work->Queue = NULL;
+    work->Func = func;
+    work->Args = args;
+    work->DueTick = 0;
+    work->Priority = priority;
+    work->State = 0;
+}
+
+/**
+ * @brief Check if a work item is pending or delayed on a queue
+ * @param work: Pointer to the work item
+ * @retval true If the work item is submitted and has not started running
+ * @retval false Otherwise
+ */
+bool work_is_pending(Work_t *work) {
+    bool result;
+
+    OCTOS_ENTER_CRITICAL();
+    result = workq_is_pending(work);
+    OCTOS_EXIT_CRITICAL();
+
+    return result;
+}
+
+/**
+ * @brief Check if the function of a work item is running on a worker
+ * @param work: Pointer to the work item
+ * @retval true If the work item is running
+ * @retval false Otherwise
+ */
+bool work_is_running(Work_t *work) {
+    bool result;
+
+    OCTOS_ENTER_CRITICAL();
+    result = (work->State & workRUNNING) != 0;
+    OCTOS_EXIT_CRITICAL();
+
+    return result;
+}
+
+/* Work Queue ----------------------------------------------------------------*/
+
+/**
+ * @brief Initialize a work queue and create its worker tasks
+ * @param queue: Pointer to the work queue
+ * @param name: Name of the worker tasks
+ * @param priority: Priority of the worker tasks
+ * @param workers: Number of worker tasks to create
+ * @param page_size_in_words: Stack page size of each worker task
+ * @retval true If every worker task was created
+ * @retval false Otherwise
+ */
+bool workq_init(WorkQueue_t *queue, const char *name, uint8_t priority,
+                size_t workers, size_t page_size_in_words) {
+    OCTOS_ASSERT(workers > 0);
+
+    list_init(&(queue->PendingList));
+    list_init(&(queue->DelayedList));
+    sema_init(&(queue->Sema), 0);
+    queue->NextDueTick = 0;
+
+    for (size_t i = 0; i < workers; i++) {
+        if (!task_create(&workq_worker, queue, name, priority,
+                         page_size_in_words, NULL))
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Submit a work item to run as soon as a worker is available
+ * @note Work that is already pending or delayed is not submitted again.
+ *       Work that is running runs once more after it returns
+ * @param queue: Pointer to the work queue
+ * @param work: Pointer to the work item
+ * @retval true If the work item was submitted
+ * @retval false If it was already pending
+ */
+bool workq_submit(WorkQueue_t *queue, Work_t *work) {
+    OCTOS_ENTER_CRITICAL();
+
+    if (workq_is_pending(work)) {
+        OCTOS_EXIT_CRITICAL();
+        return false;
+    }
+
+    const bool queued = workq_enqueue(queue, work);
+
+    OCTOS_EXIT_CRITICAL();
+
+    /* A worker is only woken for work it can take */
+    if (queued) sema_release(&(queue->Sema));
+
+    return true;
+}
+
+/**
+ * @brief Submit a work item to run after a delay
+ * @note Work that is already pending or delayed is not submitted again
+ * @param queue: Pointer to the work queue
+ * @param work: Pointer to the work item
+ * @param delay_ticks: Delay in ticks, 0 behaves like workq_submit
+ * @retval true If the work item was submitted
+ * @retval false If it was already pending
+ */
+bool workq_submit_delayed(WorkQueue_t *queue, Work_t *work,
+                          uint32_t delay_ticks) {
+    if (delay_ticks == 0) return workq_submit(queue, work);
+
+    OCTOS_ENTER_CRITICAL();
+
+    if (workq_is_pending(work)) {
+        OCTOS_EXIT_CRITICAL();
+        return false;
+    }
+
+    work->Queue = queue;
+    work->DueTick = task_get_tick() + delay_ticks;
+
+    /* Idle workers already wake for an earlier due tick */
+    const bool earliest = queue->DelayedList.Length == 0 ||
+                          work->DueTick < queue->NextDueTick;
+    if (earliest) queue->NextDueTick = work->DueTick;
+
+    workq_insert_delayed(queue, work);
+
+    OCTOS_EXIT_CRITICAL();
+
+    /* Let an idle worker shorten its sleep to the new due tick */
+    if (earliest) sema_release(&(queue->Sema));
+
+    return true;
+}
+
+/**
+ * @brief Cancel a pending or delayed work item
+ * @note Work that is already running is not affected, only its next run
+ *       if it was submitted again meanwhile
+ * @param queue: Pointer to the work queue
+ * @param work: Pointer to the work item
+ * @retval true If the work item was cancelled
+ * @retval false If it was not pending on the queue
+ */
+bool workq_cancel(WorkQueue_t *queue, Work_t *work) {
+    bool result = false;
+
+    OCTOS_ENTER_CRITICAL();
+
+    List_t *const parent = list_item_parent(&(work->Item));
+    if (parent == &(queue->PendingList) || parent == &(queue->DelayedList)) {
+        result = list_remove(&(work->Item));
+    } else if ((work->State & workRERUN) && work->Queue == queue) {
+        work->State &= ~workRERUN;
+        result = true;
+    }
+
+    OCTOS_EXIT_CRITICAL();
+
+    return result;
+}
+
+/**
+ * @brief Submit a work item from an ISR
+ * @note Work that is already pending or delayed is not submitted again.
+ *       Work that is running runs once more after it returns
+ * @param queue: Pointer to the work queue
+ * @param work: Pointer to the work item
+ * @param switch_required:
+ *      Pointer to a boolean indicating if a context switch is required
+ * @retval true If the work item was submitted
+ * @retval false If it was already pending
+ */
+bool workq_submit_from_isr(WorkQueue_t *queue, Work_t *work,
+                           bool *const switch_required) {
+    OCTOS_ASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+    uint32_t saved_intr_status = OCTOS_ENTER_CRITICAL_FROM_ISR();
+
+    if (workq_is_pending(work)) {
+        OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+        return false;
+    }
+
+    const bool queued = workq_enqueue(queue, work);
+
+    OCTOS_EXIT_CRITICAL_FROM_ISR(saved_intr_status);
+
+    if (queued) sema_release_from_isr(&(queue->Sema), switch_required);
+
+    return true;
+}
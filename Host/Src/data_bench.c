@@ -0,0 +1,383 @@
+/**
+ * @file data_bench.c
+ * @brief Host microbenchmark of the Core/Data containers
+ * @note Every result is printed as one CSV line
+ *       "BENCH,<name>,<param>,<samples>,<min>,<mean>,<max>" in nanoseconds
+ *       per operation, the samples being repeated runs. A randomized
+ *       workload checks the container invariants first and aborts on the
+ *       first violation. With --check only the invariants are checked
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Arch/port.h"
+#include "bitmap.h"
+#include "list.h"
+#include "queue.h"
+
+#define BENCH_REPEATS 5
+#define BENCH_OPS 200000
+#define BENCH_CHECK_OPS 100000
+#define BENCH_MAX_ITEMS 512
+#define BENCH_MAX_BITS 256
+#define BENCH_QUEUE_LENGTH 16
+#define BENCH_QUEUE_MAX_ITEM 64
+
+/**
+ * @brief Per operation statistics over the repeated runs
+ */
+typedef struct BenchStats {
+    uint32_t Count;   /*!< Number of runs */
+    double MinNs;     /*!< Fastest run */
+    double MaxNs;     /*!< Slowest run */
+    double TotalNs;   /*!< Sum of the runs */
+} BenchStats_t;
+
+static ListItem_t bench_items[BENCH_MAX_ITEMS + 1];
+static uint32_t bench_bitmap_data[BENCH_MAX_BITS / 32];
+static uint8_t bench_queue_storage[BENCH_QUEUE_LENGTH * BENCH_QUEUE_MAX_ITEM];
+static volatile uintptr_t bench_sink;
+
+/* Helpers -------------------------------------------------------------------*/
+
+static uint64_t bench_now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000U + (uint64_t) now.tv_nsec;
+}
+
+static void bench_stats_init(BenchStats_t *stats) {
+    stats->Count = 0;
+    stats->MinNs = 0;
+    stats->MaxNs = 0;
+    stats->TotalNs = 0;
+}
+
+static void bench_stats_add(BenchStats_t *stats, uint64_t elapsed_ns,
+                            uint32_t ops) {
+    const double per_op = (double) elapsed_ns / ops;
+
+    if (stats->Count == 0 || per_op < stats->MinNs) stats->MinNs = per_op;
+    if (stats->Count == 0 || per_op > stats->MaxNs) stats->MaxNs = per_op;
+    stats->TotalNs += per_op;
+    stats->Count++;
+}
+
+static void bench_report(const char *name, uint32_t param,
+                         BenchStats_t *stats) {
+    printf("BENCH,%s,%u,%u,%.2f,%.2f,%.2f\n", name, param, stats->Count,
+           stats->MinNs, stats->TotalNs / stats->Count, stats->MaxNs);
+}
+
+/**
+ * @brief Fill a list with items of pseudo random values
+ * @param list: Pointer to the list
+ * @param count: Number of items to insert
+ * @param sorted: Whether to use sorted insertion
+ * @return None
+ */
+static void bench_list_fill(List_t *list, size_t count, bool sorted) {
+    list_init(list);
+    for (size_t i = 0; i < count; i++) {
+        ListItem_t *const item = &bench_items[i];
+        list_item_init(item);
+        list_item_set_value(item, (uint32_t) rand() % 1024U);
+        if (sorted) {
+            list_insert(list, item);
+        } else {
+            list_insert_end(list, item);
+        }
+    }
+}
+
+/* Invariants ----------------------------------------------------------------*/
+
+/**
+ * @brief Check the structural invariants of a list
+ * @param list: Pointer to the list
+ * @param sorted: Whether items must be in ascending value order
+ * @return None
+ */
+static void check_list(List_t *list, bool sorted) {
+    size_t length = 0;
+    ListItem_t *const end = &(list->End);
+    bool current_found = (list_current(list) == end);
+
+    OCTOS_ASSERT(list_valid(list));
+    OCTOS_ASSERT(list_item_prev(list_item_next(end)) == end);
+    OCTOS_ASSERT(list_item_next(list_item_prev(end)) == end);
+
+    for (ListItem_t *item = list_item_next(end); item != end;
+         item = list_item_next(item)) {
+        ListItem_t *const next = list_item_next(item);
+        OCTOS_ASSERT(list_item_parent(item) == list);
+        OCTOS_ASSERT(list_item_prev(next) == item);
+        OCTOS_ASSERT(list_item_next(list_item_prev(item)) == item);
+        if (sorted && next != end) OCTOS_ASSERT(item->Value <= next->Value);
+        if (item == list_current(list)) current_found = true;
+        length++;
+        OCTOS_ASSERT(length <= BENCH_MAX_ITEMS);
+    }
+
+    OCTOS_ASSERT(length == list->Length);
+    OCTOS_ASSERT(length == 0 || current_found);
+}
+
+static void check_list_random(bool sorted) {
+    static List_t list;
+    list_init(&list);
+    for (size_t i = 0; i < BENCH_MAX_ITEMS; i++)
+        list_item_init(&bench_items[i]);
+
+    for (uint32_t op = 0; op < BENCH_CHECK_OPS; op++) {
+        ListItem_t *const item = &bench_items[(size_t) rand() % 64];
+
+        switch (rand() % 3) {
+            case 0:
+                if (list_item_parent(item) != NULL) {
+                    OCTOS_ASSERT(!list_insert_end(&list, item));
+                    break;
+                }
+                list_item_set_value(item, (uint32_t) rand() % 16U);
+                if (sorted) {
+                    OCTOS_ASSERT(list_insert(&list, item));
+                } else {
+                    OCTOS_ASSERT(list_insert_end(&list, item));
+                }
+                break;
+            case 1:
+                list_remove(item);
+                OCTOS_ASSERT(list_item_parent(item) == NULL);
+                break;
+            default:
+                if (list.Length > 0) {
+                    ListItem_t *const next = list_get_next_entry(&list);
+                    OCTOS_ASSERT(list_item_parent(next) == &list);
+                }
+                break;
+        }
+
+        check_list(&list, sorted);
+    }
+}
+
+static void check_bitmap_random(void) {
+    Bitmap_t bitmap;
+    bool reference[BENCH_MAX_BITS] = {false};
+    bitmap_init(&bitmap, bench_bitmap_data, BENCH_MAX_BITS);
+
+    for (uint32_t op = 0; op < BENCH_CHECK_OPS; op++) {
+        const uint32_t pos = (uint32_t) rand() % BENCH_MAX_BITS;
+        reference[pos] = (rand() % 2) == 0;
+        if (reference[pos]) {
+            bitmap_set(&bitmap, pos);
+        } else {
+            bitmap_reset(&bitmap, pos);
+        }
+
+        int32_t first_one = -1;
+        int32_t first_zero = -1;
+        for (int32_t i = BENCH_MAX_BITS - 1; i >= 0; i--) {
+            if (reference[i]) first_one = i;
+            if (!reference[i]) first_zero = i;
+        }
+
+        OCTOS_ASSERT(bitmap_first_one(&bitmap) == first_one);
+        OCTOS_ASSERT(bitmap_first_zero(&bitmap) == first_zero);
+    }
+}
+
+static void check_queue_random(void) {
+    Queue_t queue;
+    uint32_t next_in = 0;
+    uint32_t next_out = 0;
+    queue_init(&queue, bench_queue_storage, sizeof(uint32_t),
+               BENCH_QUEUE_LENGTH);
+
+    for (uint32_t op = 0; op < BENCH_CHECK_OPS; op++) {
+        uint32_t value;
+
+        if (rand() % 2 == 0) {
+            const bool full = queue_is_full(&queue);
+            OCTOS_ASSERT(queue_send(&queue, &next_in) == !full);
+            if (!full) next_in++;
+        } else {
+            const bool empty = queue_is_empty(&queue);
+            OCTOS_ASSERT(queue_recv(&queue, &value) == !empty);
+            if (!empty) OCTOS_ASSERT(value == next_out++);
+        }
+
+        OCTOS_ASSERT(queue.Size == next_in - next_out);
+        OCTOS_ASSERT(queue.Size <= BENCH_QUEUE_LENGTH);
+    }
+}
+
+/* List ----------------------------------------------------------------------*/
+
+/**
+ * @brief Sorted insertion and removal of one item in a list of a given size
+ * @param size: Number of items already in the list
+ * @return None
+ */
+static void bench_list_insert(size_t size) {
+    BenchStats_t stats;
+    static List_t list;
+    ListItem_t *const item = &bench_items[BENCH_MAX_ITEMS];
+    bench_stats_init(&stats);
+    bench_list_fill(&list, size, true);
+    list_item_init(item);
+
+    for (uint32_t run = 0; run < BENCH_REPEATS; run++) {
+        const uint64_t start = bench_now_ns();
+        for (uint32_t i = 0; i < BENCH_OPS; i++) {
+            list_item_set_value(item, i % 1024U);
+            list_insert(&list, item);
+            list_remove(item);
+        }
+        bench_stats_add(&stats, bench_now_ns() - start, BENCH_OPS);
+    }
+
+    check_list(&list, true);
+    bench_report("list_insert_remove", size, &stats);
+}
+
+static void bench_list_insert_end(size_t size) {
+    BenchStats_t stats;
+    static List_t list;
+    ListItem_t *const item = &bench_items[BENCH_MAX_ITEMS];
+    bench_stats_init(&stats);
+    bench_list_fill(&list, size, false);
+    list_item_init(item);
+
+    for (uint32_t run = 0; run < BENCH_REPEATS; run++) {
+        const uint64_t start = bench_now_ns();
+        for (uint32_t i = 0; i < BENCH_OPS; i++) {
+            list_insert_end(&list, item);
+            list_remove(item);
+        }
+        bench_stats_add(&stats, bench_now_ns() - start, BENCH_OPS);
+    }
+
+    check_list(&list, false);
+    bench_report("list_insert_end_remove", size, &stats);
+}
+
+static void bench_list_next_entry(size_t size) {
+    BenchStats_t stats;
+    static List_t list;
+    bench_stats_init(&stats);
+    bench_list_fill(&list, size, false);
+
+    for (uint32_t run = 0; run < BENCH_REPEATS; run++) {
+        const uint64_t start = bench_now_ns();
+        for (uint32_t i = 0; i < BENCH_OPS; i++)
+            bench_sink = (uintptr_t) list_get_next_entry(&list);
+        bench_stats_add(&stats, bench_now_ns() - start, BENCH_OPS);
+    }
+
+    bench_report("list_next_entry", size, &stats);
+}
+
+/* Bitmap --------------------------------------------------------------------*/
+
+/**
+ * @brief Find the first set bit when only the last bit is set
+ * @param bits: Size of the bitmap in bits
+ * @return None
+ */
+static void bench_bitmap_first_one(size_t bits) {
+    BenchStats_t stats;
+    Bitmap_t bitmap;
+    bench_stats_init(&stats);
+    bitmap_init(&bitmap, bench_bitmap_data, bits);
+    bitmap_set(&bitmap, bits - 1);
+
+    for (uint32_t run = 0; run < BENCH_REPEATS; run++) {
+        const uint64_t start = bench_now_ns();
+        for (uint32_t i = 0; i < BENCH_OPS; i++)
+            bench_sink = (uintptr_t) bitmap_first_one(&bitmap);
+        bench_stats_add(&stats, bench_now_ns() - start, BENCH_OPS);
+    }
+
+    OCTOS_ASSERT(bitmap_first_one(&bitmap) == (int32_t) (bits - 1));
+    bench_report("bitmap_first_one", bits, &stats);
+}
+
+/* Queue ---------------------------------------------------------------------*/
+
+static void bench_queue(size_t item_size) {
+    BenchStats_t send_stats;
+    BenchStats_t recv_stats;
+    Queue_t queue;
+    uint8_t item[BENCH_QUEUE_MAX_ITEM] = {0};
+    bench_stats_init(&send_stats);
+    bench_stats_init(&recv_stats);
+    queue_init(&queue, bench_queue_storage, item_size, BENCH_QUEUE_LENGTH);
+
+    const uint32_t rounds = BENCH_OPS / BENCH_QUEUE_LENGTH;
+    for (uint32_t run = 0; run < BENCH_REPEATS; run++) {
+        uint64_t send_ns = 0;
+        uint64_t recv_ns = 0;
+
+        for (uint32_t i = 0; i < rounds; i++) {
+            const uint64_t start = bench_now_ns();
+            for (size_t k = 0; k < BENCH_QUEUE_LENGTH; k++)
+                queue_send(&queue, item);
+            const uint64_t sent = bench_now_ns();
+            for (size_t k = 0; k < BENCH_QUEUE_LENGTH; k++)
+                queue_recv(&queue, item);
+            const uint64_t received = bench_now_ns();
+
+            send_ns += sent - start;
+            recv_ns += received - sent;
+        }
+
+        bench_stats_add(&send_stats, send_ns, rounds * BENCH_QUEUE_LENGTH);
+        bench_stats_add(&recv_stats, recv_ns, rounds * BENCH_QUEUE_LENGTH);
+    }
+
+    OCTOS_ASSERT(queue_is_empty(&queue));
+    bench_report("queue_send", item_size, &send_stats);
+    bench_report("queue_recv", item_size, &recv_stats);
+}
+
+/* Main Functions ------------------------------------------------------------*/
+
+int main(int argc, char **argv) {
+    static const size_t list_sizes[] = {0, 8, 64, 512};
+    static const size_t bitmap_sizes[] = {32, 256};
+    static const size_t queue_item_sizes[] = {1, 4, 16, 64};
+
+    srand(1);
+
+    check_list_random(true);
+    check_list_random(false);
+    check_bitmap_random();
+    check_queue_random();
+
+    if (argc > 1 && strcmp(argv[1], "--check") == 0) {
+        printf("CHECK_DONE\n");
+        return EXIT_SUCCESS;
+    }
+
+    printf("BENCH,name,param,samples,min,mean,max\n");
+
+    for (size_t i = 0; i < sizeof(list_sizes) / sizeof(list_sizes[0]); i++) {
+        bench_list_insert(list_sizes[i]);
+        bench_list_insert_end(list_sizes[i]);
+        if (list_sizes[i] > 0) bench_list_next_entry(list_sizes[i]);
+    }
+    for (size_t i = 0; i < sizeof(bitmap_sizes) / sizeof(bitmap_sizes[0]);
+         i++)
+        bench_bitmap_first_one(bitmap_sizes[i]);
+    for (size_t i = 0;
+         i < sizeof(queue_item_sizes) / sizeof(queue_item_sizes[0]); i++)
+        bench_queue(queue_item_sizes[i]);
+
+    printf("BENCH_DONE\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,187 @@
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Arch/port.h"
+#include "kernel.h"
+
+#define QUEUE_SIZE 10
+#define PAGE_SIZE 8192
+#define PING_PONG_ROUNDS 100000
+#define RPC_CALLS 100000
+#define RUN_TIME_TICKS 2000
+#define SAMPLE_PERIOD_US 250
+#define SAMPLE_COUNT 2000
+#define CONTROL_PERIOD_TICKS 5
+
+void ping_thread(void);
+void pong_thread(void);
+void rpc_client_thread(void);
+void rpc_server_thread(void);
+
+static OCTOS_MQUEUE_DEFINE(producer_queue, sizeof(uint32_t), QUEUE_SIZE);
+static OCTOS_SEMA_DEFINE(ping_sema, 0);
+static OCTOS_SEMA_DEFINE(pong_sema, 0);
+OCTOS_TASK_DEFINE(ping_thread_handle, &ping_thread, NULL, "PING", 2, PAGE_SIZE);
+OCTOS_TASK_DEFINE(pong_thread_handle, &pong_thread, NULL, "PONG", 2, PAGE_SIZE);
+static OCTOS_IPC_DEFINE(rpc_endpoint, sizeof(uint32_t), sizeof(uint32_t));
+OCTOS_TASK_DEFINE(rpc_client_handle, &rpc_client_thread, NULL, "RPC CLIENT", 2,
+                  PAGE_SIZE);
+OCTOS_TASK_DEFINE(rpc_server_handle, &rpc_server_thread, NULL, "RPC SERVER", 1,
+                  PAGE_SIZE);
+static volatile uint32_t consumed_items = 0;
+static volatile uint32_t consumed_sum = 0;
+static volatile uint32_t ping_pong_rounds = 0;
+static TaskPeriodic_t control_periodic;
+
+/**
+ * @brief Print from a task
+ * @note libc is not async-signal-safe, a task preempted inside printf or
+ *       malloc must not be switched out, so the scheduler is suspended
+ */
+static void host_print(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+
+    task_suspend_all();
+    vprintf(format, args);
+    fflush(stdout);
+    task_resume_all();
+
+    va_end(args);
+}
+
+/* Simulated Task Set --------------------------------------------------------*/
+
+void idle_thread(void) {
+    while (1) OCTOS_WAIT_FOR_INTERRUPT();
+}
+
+void producer_thread(void) {
+    uint32_t value = 0;
+    while (1) {
+        mqueue_send(&producer_queue, &value, UINT32_MAX);
+        value++;
+        if (value % QUEUE_SIZE == 0) task_delay(1);
+    }
+}
+
+void consumer_thread(void) {
+    uint32_t value;
+    while (1) {
+        if (mqueue_recv(&producer_queue, &value, UINT32_MAX)) {
+            consumed_items++;
+            consumed_sum += value;
+        }
+    }
+}
+
+void ping_thread(void) {
+    for (uint32_t i = 0; i < PING_PONG_ROUNDS; i++) {
+        sema_release(&ping_sema);
+        sema_acquire(&pong_sema, UINT32_MAX);
+        ping_pong_rounds++;
+    }
+    host_print("ping-pong: %u rounds done at tick %llu\n", ping_pong_rounds,
+               (unsigned long long) task_get_tick());
+    task_delete(task_get_current());
+}
+
+void pong_thread(void) {
+    while (1) {
+        sema_acquire(&ping_sema, UINT32_MAX);
+        sema_release(&pong_sema);
+    }
+}
+
+void rpc_client_thread(void) {
+    uint32_t sum = 0;
+
+    for (uint32_t i = 0; i < RPC_CALLS; i++) {
+        uint32_t square;
+        if (ipc_call(&rpc_endpoint, &i, &square, UINT32_MAX)) sum += square;
+    }
+    host_print("rpc: %u calls done at tick %llu, sum %u\n", RPC_CALLS,
+               (unsigned long long) task_get_tick(), sum);
+    task_delete(task_get_current());
+}
+
+void rpc_server_thread(void) {
+    /* Runs at the priority of its client while serving a call */
+    while (1) {
+        uint32_t value;
+        TaskHandle_t caller;
+        if (ipc_recv(&rpc_endpoint, &value, &caller, UINT32_MAX)) {
+            const uint32_t square = value * value;
+            ipc_reply(&rpc_endpoint, caller, &square);
+        }
+    }
+}
+
+#if OCTOS_HRTIMER
+void sampler_thread(void) {
+    uint64_t wake_us = clock_now_us();
+    uint64_t max_lateness_us = 0;
+
+    /* Paced below the 1 ms tick by the high-resolution timer */
+    for (uint32_t i = 0; i < SAMPLE_COUNT; i++) {
+        clock_delay_until_us(&wake_us, SAMPLE_PERIOD_US);
+        const uint64_t lateness_us = clock_now_us() - wake_us;
+        if (lateness_us > max_lateness_us) max_lateness_us = lateness_us;
+    }
+
+    host_print("sampler: %u samples every %u us, max lateness %llu us\n",
+               SAMPLE_COUNT, SAMPLE_PERIOD_US,
+               (unsigned long long) max_lateness_us);
+    task_delete(task_get_current());
+}
+#endif
+
+void control_job(void) {
+    /* Stand-in for a control law, busy for a fraction of the period */
+    const uint64_t end_ns = clock_now_ns() + 200000U;
+    while (clock_now_ns() < end_ns);
+}
+
+void supervisor_thread(void) {
+    task_delay(RUN_TIME_TICKS);
+
+    host_print("consumer: %u items, sum %u\n", consumed_items, consumed_sum);
+    host_print("ping-pong: %u rounds\n", ping_pong_rounds);
+
+    TaskPeriodicStats_t stats;
+    task_periodic_get_stats(&control_periodic, &stats);
+    host_print("control: %u jobs, %u overruns, max response %u ticks, "
+               "jitter mean %llu ns max %u ns\n",
+               stats.Jobs, stats.Overruns, stats.MaxResponse,
+               (unsigned long long) (stats.Jobs > 0 ? stats.TotalJitterNs /
+                                                              stats.Jobs
+                                                    : 0),
+               stats.MaxJitterNs);
+
+    task_suspend_all();
+    exit(EXIT_SUCCESS);
+}
+
+/* Main Functions ------------------------------------------------------------*/
+
+int main(void) {
+    task_create((TaskFunc_t) &idle_thread, NULL, "IDLE", 0, PAGE_SIZE, NULL);
+    task_create((TaskFunc_t) &producer_thread, NULL, "PRODUCER", 1, PAGE_SIZE,
+                NULL);
+    task_create((TaskFunc_t) &consumer_thread, NULL, "CONSUMER", 1, PAGE_SIZE,
+                NULL);
+#if OCTOS_HRTIMER
+    task_create((TaskFunc_t) &sampler_thread, NULL, "SAMPLER", 3, PAGE_SIZE,
+                NULL);
+#endif
+    task_create_periodic(&control_periodic, (TaskFunc_t) &control_job, NULL,
+                         "CONTROL", 3, PAGE_SIZE, CONTROL_PERIOD_TICKS, 0,
+                         NULL);
+    task_create((TaskFunc_t) &supervisor_thread, NULL, "SUPERVISOR", 4,
+                PAGE_SIZE, NULL);
+
+    Quanta_t quanta = {.Unit = MILISECONDS, .Value = 1};
+    kernel_launch(&quanta);
+}
@@ -0,0 +1,108 @@
+/**
+ * @file test.c
+ * @brief Runner and helpers shared by the host behaviour tests
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Arch/port.h"
+#include "test.h"
+
+/**
+ * @brief Idle task, keeps a task ready at the lowest priority
+ */
+static void test_idle_thread(OCTOS_UNUSED void *args) {
+    while (1) OCTOS_WAIT_FOR_INTERRUPT();
+}
+
+/**
+ * @brief Report a failed check and end the test
+ * @note The scheduler is left suspended, libc is not async-signal-safe
+ * @param file: Source file of the check
+ * @param line: Source line of the check
+ * @param cond: Text of the condition that did not hold
+ * @return None
+ */
+void test_fail(const char *file, int line, const char *cond) {
+    task_suspend_all();
+    printf("FAIL %s:%d: %s\n", file, line, cond);
+    fflush(stdout);
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Report success and end the test
+ * @param None
+ * @return None
+ */
+void test_pass(void) {
+    task_suspend_all();
+    printf("PASS\n");
+    fflush(stdout);
+    exit(EXIT_SUCCESS);
+}
+
+/**
+ * @brief Print from a task
+ * @note A task preempted inside printf must not be switched out, so the
+ *       scheduler is suspended
+ * @param format: printf format string
+ * @return None
+ */
+void test_print(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+
+    task_suspend_all();
+    vprintf(format, args);
+    fflush(stdout);
+    task_resume_all();
+
+    va_end(args);
+}
+
+/**
+ * @brief Create a helper task, fails the test if it cannot be created
+ * @param func: Task function
+ * @param args: Arguments passed to the task function
+ * @param name: Name of the task
+ * @param priority: Priority of the task
+ * @return Handle of the task
+ */
+TaskHandle_t test_spawn(TaskFunc_t func, void *args, const char *name,
+                        uint8_t priority) {
+    TaskHandle_t handle = NULL;
+
+    TEST_CHECK(task_create(func, args, name, priority, TEST_PAGE_SIZE,
+                           &handle));
+
+    return handle;
+}
+
+/**
+ * @brief Keep the CPU busy without blocking
+ * @param ticks: Number of ticks to spin for
+ * @return None
+ */
+void test_busy_ticks(uint32_t ticks) {
+    const Tick_t end = task_get_tick() + ticks;
+    while (task_get_tick() < end);
+}
+
+/**
+ * @brief Launch the kernel with the runner of a test
+ * @note Does not return, the runner ends the process
+ * @param runner: Task function of the runner
+ * @return None
+ */
+void test_run(TaskFunc_t runner) {
+    Quanta_t quanta = {.Unit = MILISECONDS, .Value = 1};
+
+    task_create(&test_idle_thread, NULL, "IDLE", 0, TEST_PAGE_SIZE, NULL);
+    task_create(runner, NULL, "RUNNER", TEST_RUNNER_PRIORITY, TEST_PAGE_SIZE,
+                NULL);
+
+    kernel_launch(&quanta);
+}
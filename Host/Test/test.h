@@ -0,0 +1,36 @@
+/**
+ * @file test.h
+ * @brief Host behaviour tests of the kernel primitives
+ * @note Each test program launches the kernel with a runner task at the
+ *       highest priority. The runner drives the scenarios with helper tasks
+ *       and ends the process, the first failed check exits with a failure
+ */
+
+#ifndef __HOST_TEST_H__
+#define __HOST_TEST_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "kernel.h"
+
+#define TEST_PAGE_SIZE 8192
+#define TEST_RUNNER_PRIORITY (OCTOS_MAX_PRIORITIES - 1)
+
+/**
+ * @brief Fail the test if a condition does not hold
+ */
+#define TEST_CHECK(cond)                                                       \
+    do {                                                                       \
+        if (!(cond)) test_fail(__FILE__, __LINE__, #cond);                     \
+    } while (0)
+
+void test_fail(const char *file, int line, const char *cond);
+void test_pass(void);
+void test_print(const char *format, ...);
+TaskHandle_t test_spawn(TaskFunc_t func, void *args, const char *name,
+                        uint8_t priority);
+void test_busy_ticks(uint32_t ticks);
+void test_run(TaskFunc_t runner);
+
+#endif
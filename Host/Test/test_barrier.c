@@ -0,0 +1,85 @@
+/**
+ * @file test_barrier.c
+ * @brief Barrier: every party is released once per round, a timed out party
+ *        withdraws and a reset releases the waiting parties
+ */
+
+#include "test.h"
+
+#define PARTIES 4
+#define ROUNDS 50
+
+static OCTOS_BARRIER_DEFINE(barrier, PARTIES);
+static volatile uint32_t passed[PARTIES];
+static volatile uint32_t done_parties;
+
+/* Helper Tasks --------------------------------------------------------------*/
+
+static void party_thread(void *args) {
+    const uint32_t index = (uint32_t) (uintptr_t) args;
+
+    for (uint32_t i = 0; i < ROUNDS; i++) {
+        TEST_CHECK(barrier_wait(&barrier, UINT32_MAX));
+        passed[index]++;
+        /* No party runs a round ahead of the others */
+        for (uint32_t j = 0; j < PARTIES; j++)
+            TEST_CHECK(passed[j] + 1 >= passed[index]);
+        if (index % 2 == 0) task_delay(1);
+    }
+    done_parties++;
+}
+
+static void waiter_thread(OCTOS_UNUSED void *args) {
+    TEST_CHECK(barrier_wait(&barrier, UINT32_MAX));
+    done_parties++;
+}
+
+/* Scenarios -----------------------------------------------------------------*/
+
+static void test_rounds(void) {
+    for (uint32_t i = 0; i < PARTIES; i++)
+        test_spawn(&party_thread, (void *) (uintptr_t) i, "PARTY", 1 + i % 3);
+
+    task_delay(ROUNDS * 3);
+    TEST_CHECK(done_parties == PARTIES);
+    for (uint32_t i = 0; i < PARTIES; i++) TEST_CHECK(passed[i] == ROUNDS);
+}
+
+static void test_timeout_withdraws(void) {
+    done_parties = 0;
+
+    /* Timed out arrivals do not count towards the next release */
+    TEST_CHECK(!barrier_wait(&barrier, 0));
+    TEST_CHECK(!barrier_wait(&barrier, 3));
+
+    for (uint32_t i = 0; i < PARTIES - 1; i++)
+        test_spawn(&waiter_thread, NULL, "WAITER", 2);
+    task_delay(2);
+    TEST_CHECK(done_parties == 0);
+
+    TEST_CHECK(barrier_wait(&barrier, 5));
+    task_delay(2);
+    TEST_CHECK(done_parties == PARTIES - 1);
+}
+
+static void test_reset(void) {
+    done_parties = 0;
+
+    for (uint32_t i = 0; i < PARTIES - 1; i++)
+        test_spawn(&waiter_thread, NULL, "WAITER", 2);
+    task_delay(2);
+    TEST_CHECK(done_parties == 0);
+
+    barrier_reset(&barrier);
+    task_delay(2);
+    TEST_CHECK(done_parties == PARTIES - 1);
+}
+
+static void runner_thread(OCTOS_UNUSED void *args) {
+    test_rounds();
+    test_timeout_withdraws();
+    test_reset();
+    test_pass();
+}
+
+int main(void) { test_run(&runner_thread); }
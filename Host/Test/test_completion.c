@@ -0,0 +1,117 @@
+/**
+ * @file test_completion.c
+ * @brief Completions: completed from tasks and ISRs, waited on alone or in
+ *        sets, and timed out waits deregister from pending completions
+ */
+
+#include "test.h"
+
+#define STATUS 7
+
+static OCTOS_COMPLETION_DEFINE(first);
+#if OCTOS_HRTIMER
+static OCTOS_COMPLETION_DEFINE(second);
+static HrTimer_t timer;
+#endif
+static volatile bool waiter_done;
+
+/* Helper Tasks --------------------------------------------------------------*/
+
+static void waiter_thread(OCTOS_UNUSED void *args) {
+    TEST_CHECK(completion_wait(&first, UINT32_MAX));
+    TEST_CHECK(completion_get_status(&first) == STATUS);
+    waiter_done = true;
+}
+
+#if OCTOS_HRTIMER
+static void complete_from_timer(void *args, bool *const switch_required) {
+    completion_complete_from_isr(args, STATUS, switch_required);
+}
+#endif
+
+/* Scenarios -----------------------------------------------------------------*/
+
+static void test_complete_from_task(void) {
+    completion_reset(&first);
+    test_spawn(&waiter_thread, NULL, "WAITER", 2);
+    task_delay(2);
+    TEST_CHECK(!waiter_done);
+
+    completion_complete(&first, STATUS);
+    task_delay(1);
+    TEST_CHECK(waiter_done);
+
+    /* A done completion satisfies the wait at once */
+    TEST_CHECK(completion_wait(&first, 0));
+}
+
+#if OCTOS_HRTIMER
+static void test_complete_from_isr(void) {
+    completion_reset(&first);
+    hrtimer_init(&timer, &complete_from_timer, &first);
+    hrtimer_start(&timer, 300);
+
+    const Tick_t start = task_get_tick();
+    TEST_CHECK(completion_wait(&first, 10));
+    TEST_CHECK(task_get_tick() - start <= 2);
+    TEST_CHECK(completion_get_status(&first) == STATUS);
+}
+#endif
+
+static void test_timeout(void) {
+    completion_reset(&first);
+
+    const Tick_t start = task_get_tick();
+    TEST_CHECK(!completion_wait(&first, 3));
+    TEST_CHECK(task_get_tick() - start >= 3);
+    TEST_CHECK(!completion_is_done(&first));
+    TEST_CHECK(first.Waiter == NULL);
+
+#if OCTOS_HRTIMER
+    TEST_CHECK(!completion_wait_us(&first, 500));
+    TEST_CHECK(first.Waiter == NULL);
+
+    hrtimer_init(&timer, &complete_from_timer, &first);
+    hrtimer_start(&timer, 300);
+    TEST_CHECK(completion_wait_us(&first, 5000));
+#endif
+}
+
+#if OCTOS_HRTIMER
+
+static void test_sets(void) {
+    Completion_t *const set[] = {&first, &second};
+    size_t index = 0;
+
+    completion_reset(&first);
+    completion_reset(&second);
+    hrtimer_init(&timer, &complete_from_timer, &second);
+    hrtimer_start(&timer, 300);
+
+    TEST_CHECK(completion_wait_any(set, 2, &index, 10));
+    TEST_CHECK(index == 1);
+    /* The pending one is left without a waiter */
+    TEST_CHECK(first.Waiter == NULL);
+
+    TEST_CHECK(!completion_wait_all(set, 2, 3));
+    TEST_CHECK(first.Waiter == NULL);
+
+    hrtimer_init(&timer, &complete_from_timer, &first);
+    hrtimer_start(&timer, 300);
+    TEST_CHECK(completion_wait_all(set, 2, 10));
+}
+#endif
+
+static void runner_thread(OCTOS_UNUSED void *args) {
+    test_complete_from_task();
+#if OCTOS_HRTIMER
+    test_complete_from_isr();
+#endif
+    test_timeout();
+#if OCTOS_HRTIMER
+    test_sets();
+#endif
+    test_pass();
+}
+
+int main(void) { test_run(&runner_thread); }
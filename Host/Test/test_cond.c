@@ -0,0 +1,87 @@
+/**
+ * @file test_cond.c
+ * @brief Condition variable: notify_all with the mutex free or held, mixed
+ *        plain and mutex-bound waiters and timeouts of cond_wait_mutex
+ */
+
+#include "test.h"
+
+#define WAITERS 4
+
+static OCTOS_COND_DEFINE(cond);
+static OCTOS_MUTEX_DEFINE(mutex);
+static volatile uint32_t done_waiters;
+static volatile uint32_t inside;
+static volatile bool overlap;
+
+/* Helper Tasks --------------------------------------------------------------*/
+
+static void plain_waiter_thread(OCTOS_UNUSED void *args) {
+    TEST_CHECK(cond_wait(&cond, UINT32_MAX));
+    done_waiters++;
+}
+
+/* Checks that the mutex is held alone once the wait returns */
+static void mutex_waiter_thread(OCTOS_UNUSED void *args) {
+    TEST_CHECK(mutex_acquire(&mutex, UINT32_MAX));
+    TEST_CHECK(cond_wait_mutex(&cond, &mutex, UINT32_MAX));
+    TEST_CHECK(mutex.Owner == task_get_current());
+
+    if (++inside > 1) overlap = true;
+    task_delay(1);
+    inside--;
+
+    TEST_CHECK(mutex_release(&mutex));
+    done_waiters++;
+}
+
+/* Scenarios -----------------------------------------------------------------*/
+
+static void test_notify_all_free_mutex(void) {
+    done_waiters = 0;
+    /* The plain waiter is woken first, nobody takes the mutex before the
+     * mutex waiters are taken off the condition variable */
+    test_spawn(&plain_waiter_thread, NULL, "PLAIN", 3);
+    for (size_t i = 0; i < WAITERS; i++)
+        test_spawn(&mutex_waiter_thread, NULL, "WAITER", 2);
+    task_delay(2);
+
+    cond_notify_all(&cond);
+    task_delay(WAITERS * 2 + 2);
+    TEST_CHECK(done_waiters == WAITERS + 1);
+    TEST_CHECK(!overlap);
+}
+
+static void test_notify_all_held_mutex(void) {
+    done_waiters = 0;
+    for (size_t i = 0; i < WAITERS; i++)
+        test_spawn(&mutex_waiter_thread, NULL, "WAITER", 2);
+    task_delay(2);
+
+    /* Requeued onto the held mutex, one runs per release */
+    TEST_CHECK(mutex_acquire(&mutex, UINT32_MAX));
+    cond_notify_all(&cond);
+    task_delay(2);
+    TEST_CHECK(done_waiters == 0);
+    TEST_CHECK(mutex_release(&mutex));
+
+    task_delay(WAITERS * 2 + 2);
+    TEST_CHECK(done_waiters == WAITERS);
+    TEST_CHECK(!overlap);
+}
+
+static void test_wait_mutex_timeout(void) {
+    TEST_CHECK(mutex_acquire(&mutex, UINT32_MAX));
+    TEST_CHECK(!cond_wait_mutex(&cond, &mutex, 3));
+    TEST_CHECK(mutex.Owner == task_get_current());
+    TEST_CHECK(mutex_release(&mutex));
+}
+
+static void runner_thread(OCTOS_UNUSED void *args) {
+    test_notify_all_free_mutex();
+    test_notify_all_held_mutex();
+    test_wait_mutex_timeout();
+    test_pass();
+}
+
+int main(void) { test_run(&runner_thread); }
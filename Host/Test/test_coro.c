@@ -0,0 +1,141 @@
+/**
+ * @file test_coro.c
+ * @brief Stackless coroutines: coroutines awaiting kernel objects are parked
+ *        and resumed by the signal of the object long before the poll period
+ */
+
+#include "test.h"
+
+#define POLL_TICKS 10000
+#define ROUNDS 20
+
+static CoroHost_t host;
+static Coro_t sema_coro_record;
+static Coro_t mqueue_coro_record;
+static Coro_t event_coro_record;
+static Coro_t delay_coro_record;
+static OCTOS_SEMA_DEFINE(sema, 0);
+static OCTOS_MQUEUE_DEFINE(mqueue, sizeof(uint32_t), 4);
+static OCTOS_EVENT_DEFINE(event);
+#if OCTOS_HRTIMER
+static HrTimer_t timer;
+#endif
+static volatile uint32_t acquired;
+static volatile uint32_t received_sum;
+static volatile bool event_seen;
+static volatile uint32_t delay_tick;
+
+/* Coroutines ----------------------------------------------------------------*/
+
+static CoroStatus_t sema_coro(Coro_t *coro, OCTOS_UNUSED void *args) {
+    CORO_BEGIN(coro);
+    while (1) {
+        CORO_AWAIT_SEMA(coro, &sema);
+        acquired++;
+    }
+    CORO_END(coro);
+}
+
+static CoroStatus_t mqueue_coro(Coro_t *coro, void *args) {
+    CORO_BEGIN(coro);
+    while (1) {
+        CORO_AWAIT_MQUEUE_RECV(coro, &mqueue, args);
+        received_sum += *(uint32_t *) args;
+    }
+    CORO_END(coro);
+}
+
+static CoroStatus_t event_coro(Coro_t *coro, OCTOS_UNUSED void *args) {
+    CORO_BEGIN(coro);
+    CORO_AWAIT_EVENT(coro, &event);
+    event_seen = true;
+    CORO_END(coro);
+}
+
+static CoroStatus_t delay_coro(Coro_t *coro, OCTOS_UNUSED void *args) {
+    CORO_BEGIN(coro);
+    CORO_DELAY(coro, 5);
+    delay_tick = (uint32_t) task_get_tick();
+    CORO_END(coro);
+}
+
+#if OCTOS_HRTIMER
+static void release_from_timer(OCTOS_UNUSED void *args,
+                               bool *const switch_required) {
+    sema_release_from_isr(&sema, switch_required);
+}
+#endif
+
+/* Scenarios -----------------------------------------------------------------*/
+
+static void test_sema(void) {
+    coro_start(&host, &sema_coro_record, &sema_coro, NULL);
+    task_delay(2);
+    TEST_CHECK(coro_is_running(&sema_coro_record));
+    TEST_CHECK(acquired == 0);
+
+    /* Every release resumes the parked coroutine, from a task or an ISR */
+    for (uint32_t i = 0; i < ROUNDS; i++) {
+        sema_release(&sema);
+        task_delay(2);
+        TEST_CHECK(acquired == 2 * i + 1);
+
+#if OCTOS_HRTIMER
+        hrtimer_start(&timer, 300);
+#else
+        sema_release(&sema);
+#endif
+        task_delay(2);
+        TEST_CHECK(acquired == 2 * i + 2);
+    }
+}
+
+static void test_mqueue(void) {
+    static uint32_t buffer;
+
+    coro_start(&host, &mqueue_coro_record, &mqueue_coro, &buffer);
+    task_delay(2);
+
+    uint32_t sum = 0;
+    for (uint32_t i = 1; i <= ROUNDS; i++) {
+        TEST_CHECK(mqueue_send(&mqueue, &i, 0));
+        sum += i;
+        task_delay(2);
+        TEST_CHECK(received_sum == sum);
+    }
+}
+
+static void test_event(void) {
+    coro_start(&host, &event_coro_record, &event_coro, NULL);
+    task_delay(2);
+    TEST_CHECK(!event_seen);
+
+    event_set(&event);
+    task_delay(2);
+    TEST_CHECK(event_seen);
+    TEST_CHECK(!coro_is_running(&event_coro_record));
+}
+
+static void test_delay(void) {
+    const uint32_t start = (uint32_t) task_get_tick();
+
+    coro_start(&host, &delay_coro_record, &delay_coro, NULL);
+    task_delay(10);
+    TEST_CHECK(delay_tick >= start + 5 && delay_tick <= start + 6);
+    TEST_CHECK(!coro_is_running(&delay_coro_record));
+}
+
+static void runner_thread(OCTOS_UNUSED void *args) {
+#if OCTOS_HRTIMER
+    hrtimer_init(&timer, &release_from_timer, NULL);
+#endif
+    TEST_CHECK(coro_host_init(&host, "CORO", 2, TEST_PAGE_SIZE, POLL_TICKS));
+
+    test_sema();
+    test_mqueue();
+    test_event();
+    test_delay();
+    test_pass();
+}
+
+int main(void) { test_run(&runner_thread); }
@@ -0,0 +1,77 @@
+/**
+ * @file test_futex.c
+ * @brief Futex: value check, wake counts, timeouts and the wait context
+ *        left behind by every way out of a wait
+ */
+
+#include "test.h"
+
+#define WAITERS 4
+
+static volatile uint32_t word;
+static volatile uint32_t done_waiters;
+static volatile bool waited;
+
+/* Helper Tasks --------------------------------------------------------------*/
+
+static void waiter_thread(OCTOS_UNUSED void *args) {
+    TEST_CHECK(futex_wait(&word, 0, UINT32_MAX));
+    done_waiters++;
+}
+
+/* Waits with a timeout, then stays around for its TCB to be checked */
+static void timed_waiter_thread(OCTOS_UNUSED void *args) {
+    waited = futex_wait(&word, 0, 3);
+    task_notify_wait(0, 0, NULL, UINT32_MAX);
+}
+
+/* Scenarios -----------------------------------------------------------------*/
+
+static void test_value_check(void) {
+    word = 1;
+    TEST_CHECK(futex_wait(&word, 0, UINT32_MAX));
+    TEST_CHECK(!futex_wait(&word, 1, 0));
+    TEST_CHECK(!futex_wait(&word, 1, 3));
+    TEST_CHECK(task_get_current()->WaitContext == NULL);
+    word = 0;
+}
+
+static void test_wake_count(void) {
+    done_waiters = 0;
+    for (size_t i = 0; i < WAITERS; i++)
+        test_spawn(&waiter_thread, NULL, "WAITER", 2);
+    task_delay(2);
+
+    word = 1;
+    TEST_CHECK(futex_wake(&word, 1) == 1);
+    task_delay(2);
+    TEST_CHECK(done_waiters == 1);
+    TEST_CHECK(futex_wake(&word, SIZE_MAX) == WAITERS - 1);
+    task_delay(2);
+    TEST_CHECK(done_waiters == WAITERS);
+    TEST_CHECK(futex_wake(&word, SIZE_MAX) == 0);
+    word = 0;
+}
+
+static void test_changed_without_wake(void) {
+    waited = false;
+    TaskHandle_t waiter = test_spawn(&timed_waiter_thread, NULL, "WAITER", 2);
+    task_delay(1);
+
+    /* Times out to find the word changed, which counts as woken */
+    word = 1;
+    task_delay(5);
+    TEST_CHECK(waited);
+    TEST_CHECK(waiter->WaitContext == NULL);
+    task_notify(waiter, 0, NoAction);
+    word = 0;
+}
+
+static void runner_thread(OCTOS_UNUSED void *args) {
+    test_value_check();
+    test_wake_count();
+    test_changed_without_wake();
+    test_pass();
+}
+
+int main(void) { test_run(&runner_thread); }
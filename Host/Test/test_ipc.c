@@ -0,0 +1,131 @@
+/**
+ * @file test_ipc.c
+ * @brief Synchronous IPC: priority donation to the server alongside mutex
+ *        inheritance, donation along a blocking chain and timed out calls
+ */
+
+#include "test.h"
+
+#define REQUEST_PLAIN ((uint32_t) 1)
+#define REQUEST_LOCK ((uint32_t) 2)
+
+static OCTOS_IPC_DEFINE(endpoint, sizeof(uint32_t), sizeof(uint32_t));
+static OCTOS_MUTEX_DEFINE(server_mutex);
+static OCTOS_MUTEX_DEFINE(client_mutex);
+static volatile bool call_done;
+static volatile bool reply_done;
+
+/* Helper Tasks --------------------------------------------------------------*/
+
+/* Serves one call per notify, a locking call holds the mutex until notified */
+static void server_thread(OCTOS_UNUSED void *args) {
+    while (1) {
+        uint32_t request;
+        TaskHandle_t caller;
+
+        TEST_CHECK(ipc_recv(&endpoint, &request, &caller, UINT32_MAX));
+        if (request == REQUEST_LOCK) {
+            TEST_CHECK(mutex_acquire(&server_mutex, UINT32_MAX));
+            task_notify_wait(0, 0, NULL, UINT32_MAX);
+            TEST_CHECK(mutex_release(&server_mutex));
+        }
+        task_notify_wait(0, 0, NULL, UINT32_MAX);
+        reply_done = ipc_reply(&endpoint, caller, &request);
+    }
+}
+
+static void client_thread(void *args) {
+    uint32_t request = (uint32_t) (uintptr_t) args;
+    uint32_t response = 0;
+
+    call_done = ipc_call(&endpoint, &request, &response, UINT32_MAX) &&
+                response == request;
+}
+
+static void timed_client_thread(OCTOS_UNUSED void *args) {
+    uint32_t request = REQUEST_PLAIN;
+
+    call_done = ipc_call(&endpoint, &request, NULL, 3);
+}
+
+/* Calls the server while holding a mutex */
+static void chain_client_thread(OCTOS_UNUSED void *args) {
+    TEST_CHECK(mutex_acquire(&client_mutex, UINT32_MAX));
+    client_thread((void *) (uintptr_t) REQUEST_PLAIN);
+    TEST_CHECK(mutex_release(&client_mutex));
+}
+
+static void mutex_user_thread(void *args) {
+    Mutex_t *const mutex = args;
+
+    TEST_CHECK(mutex_acquire(mutex, UINT32_MAX));
+    TEST_CHECK(mutex_release(mutex));
+}
+
+/* Scenarios -----------------------------------------------------------------*/
+
+static void test_donation_with_mutex(TaskHandle_t server) {
+    call_done = false;
+    test_spawn(&client_thread, (void *) (uintptr_t) REQUEST_LOCK, "CLIENT", 3);
+    task_delay(2);
+    TEST_CHECK(server->Priority == 3);
+
+    /* Giving the mutex back to a lower waiter keeps the donation */
+    test_spawn(&mutex_user_thread, &server_mutex, "USER", 2);
+    task_delay(2);
+    TEST_CHECK(server->Priority == 3);
+    task_notify(server, 0, NoAction);
+    task_delay(2);
+    TEST_CHECK(server->Priority == 3);
+
+    task_notify(server, 0, NoAction);
+    task_delay(2);
+    TEST_CHECK(call_done);
+    TEST_CHECK(reply_done);
+    TEST_CHECK(server->Priority == 1);
+}
+
+static void test_donation_chain(TaskHandle_t server) {
+    call_done = false;
+    test_spawn(&chain_client_thread, NULL, "CLIENT", 1);
+    task_delay(2);
+    TEST_CHECK(server->Priority == 1);
+
+    /* A boost of the blocked caller reaches the server */
+    test_spawn(&mutex_user_thread, &client_mutex, "USER", 3);
+    task_delay(2);
+    TEST_CHECK(server->Priority == 3);
+
+    task_notify(server, 0, NoAction);
+    task_delay(2);
+    TEST_CHECK(call_done);
+    TEST_CHECK(reply_done);
+    TEST_CHECK(server->Priority == 1);
+}
+
+static void test_timed_out_call(TaskHandle_t server) {
+    call_done = true;
+    test_spawn(&timed_client_thread, NULL, "CLIENT", 2);
+    task_delay(1);
+    TEST_CHECK(server->Priority == 2);
+
+    /* The caller takes its donation back, the late reply is dropped */
+    task_delay(5);
+    TEST_CHECK(!call_done);
+    TEST_CHECK(server->Priority == 1);
+    task_notify(server, 0, NoAction);
+    task_delay(2);
+    TEST_CHECK(!reply_done);
+}
+
+static void runner_thread(OCTOS_UNUSED void *args) {
+    TaskHandle_t server = test_spawn(&server_thread, NULL, "SERVER", 1);
+    task_delay(2);
+
+    test_donation_with_mutex(server);
+    test_donation_chain(server);
+    test_timed_out_call(server);
+    test_pass();
+}
+
+int main(void) { test_run(&runner_thread); }
@@ -0,0 +1,80 @@
+/**
+ * @file test_isr_wake.c
+ * @brief ISR wake stack: tasks woken from an ISR at the priority of the
+ *        running task get their turn, and every wake is delivered once
+ */
+
+#include "test.h"
+
+#define WAKES 50
+
+#if OCTOS_HRTIMER
+static HrTimer_t timer;
+static volatile uint32_t wakes;
+
+/* Helper Tasks --------------------------------------------------------------*/
+
+static void notified_thread(OCTOS_UNUSED void *args) {
+    while (1) {
+        task_notify_wait(0, 0, NULL, UINT32_MAX);
+        wakes++;
+    }
+}
+
+static void suspended_thread(OCTOS_UNUSED void *args) {
+    while (1) {
+        task_suspend(NULL);
+        wakes++;
+    }
+}
+
+/* Hogs its priority level without ever blocking */
+static void spinner_thread(void *args) {
+    test_busy_ticks((uint32_t) (uintptr_t) args);
+}
+
+static void notify_from_timer(void *args, bool *const switch_required) {
+    task_notify_from_isr(args, 0, NoAction, switch_required);
+}
+
+static void resume_from_timer(void *args, bool *const switch_required) {
+    *switch_required = false;
+    task_resume_from_isr(args);
+}
+
+/* Scenarios -----------------------------------------------------------------*/
+
+/**
+ * @brief Wake a task at the priority of a spinning task from a timer ISR
+ * @param func: Timer function waking the task
+ * @param task: Handle of the woken task
+ * @return None
+ */
+static void test_same_priority_wake(HrTimerFunc_t func, TaskHandle_t task) {
+    wakes = 0;
+    hrtimer_init(&timer, func, task);
+
+    for (uint32_t i = 0; i < WAKES; i++) {
+        test_spawn(&spinner_thread, (void *) (uintptr_t) 10, "SPINNER", 2);
+        hrtimer_start(&timer, 300);
+        task_delay(5);
+        TEST_CHECK(wakes == i + 1);
+        task_delay(6);
+    }
+}
+
+static void runner_thread(OCTOS_UNUSED void *args) {
+    TaskHandle_t notified = test_spawn(&notified_thread, NULL, "NOTIFIED", 2);
+    TaskHandle_t suspended = test_spawn(&suspended_thread, NULL, "SUSPENDED", 2);
+    task_delay(2);
+
+    test_same_priority_wake(&notify_from_timer, notified);
+    test_same_priority_wake(&resume_from_timer, suspended);
+    test_pass();
+}
+#else
+/* The high-resolution timer is the only interrupt the tests can raise */
+static void runner_thread(OCTOS_UNUSED void *args) { test_pass(); }
+#endif
+
+int main(void) { test_run(&runner_thread); }
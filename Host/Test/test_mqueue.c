@@ -0,0 +1,112 @@
+/**
+ * @file test_mqueue.c
+ * @brief Message queue: blocked senders and receivers are served highest
+ *        priority first and in arrival order within a priority, also once
+ *        some waiters timed out of their priority bucket
+ */
+
+#include "test.h"
+
+#define QUEUE_SIZE 2
+#define WAITERS 4
+
+static OCTOS_MQUEUE_DEFINE(mqueue, sizeof(uint32_t), QUEUE_SIZE);
+static volatile uint32_t order[WAITERS];
+static volatile uint32_t served;
+
+/* Helper Tasks --------------------------------------------------------------*/
+
+static void receiver_thread(void *args) {
+    uint32_t value;
+
+    TEST_CHECK(mqueue_recv(&mqueue, &value, UINT32_MAX));
+    order[served++] = (uint32_t) (uintptr_t) args;
+}
+
+static void sender_thread(void *args) {
+    const uint32_t value = (uint32_t) (uintptr_t) args;
+
+    TEST_CHECK(mqueue_send(&mqueue, &value, UINT32_MAX));
+    order[served++] = value;
+}
+
+static void timed_receiver_thread(OCTOS_UNUSED void *args) {
+    uint32_t value;
+
+    TEST_CHECK(!mqueue_recv(&mqueue, &value, 3));
+}
+
+/* Scenarios -----------------------------------------------------------------*/
+
+/**
+ * @brief Block waiters of priorities 2, 1, 3 and 2 in that order
+ * @param func: Task function of the waiters
+ * @return None
+ */
+static void spawn_waiters(TaskFunc_t func) {
+    static const uint8_t priorities[WAITERS] = {2, 1, 3, 2};
+
+    served = 0;
+    for (uintptr_t i = 0; i < WAITERS; i++) {
+        test_spawn(func, (void *) i, "WAITER", priorities[i]);
+        task_delay(1);
+    }
+}
+
+static void test_receivers(void) {
+    spawn_waiters(&receiver_thread);
+
+    for (uint32_t i = 0; i < WAITERS; i++) {
+        TEST_CHECK(mqueue_send(&mqueue, &i, 0));
+        task_delay(1);
+    }
+
+    TEST_CHECK(served == WAITERS);
+    TEST_CHECK(order[0] == 2 && order[1] == 0);
+    TEST_CHECK(order[2] == 3 && order[3] == 1);
+}
+
+static void test_senders(void) {
+    uint32_t value;
+
+    for (uint32_t i = 0; i < QUEUE_SIZE; i++)
+        TEST_CHECK(mqueue_send(&mqueue, &i, 0));
+    spawn_waiters(&sender_thread);
+
+    for (uint32_t i = 0; i < WAITERS + QUEUE_SIZE; i++) {
+        TEST_CHECK(mqueue_recv(&mqueue, &value, 0));
+        task_delay(1);
+    }
+
+    TEST_CHECK(served == WAITERS);
+    TEST_CHECK(order[0] == 2 && order[1] == 0);
+    TEST_CHECK(order[2] == 3 && order[3] == 1);
+}
+
+static void test_timed_out_waiters(void) {
+    served = 0;
+
+    /* Empty the top bucket through timeouts, then the next is served */
+    test_spawn(&timed_receiver_thread, NULL, "TIMED", 3);
+    test_spawn(&timed_receiver_thread, NULL, "TIMED", 3);
+    test_spawn(&receiver_thread, (void *) 1, "WAITER", 1);
+    test_spawn(&receiver_thread, (void *) 2, "WAITER", 2);
+    task_delay(5);
+
+    for (uint32_t i = 0; i < 2; i++) {
+        TEST_CHECK(mqueue_send(&mqueue, &i, 0));
+        task_delay(1);
+    }
+
+    TEST_CHECK(served == 2);
+    TEST_CHECK(order[0] == 2 && order[1] == 1);
+}
+
+static void runner_thread(OCTOS_UNUSED void *args) {
+    test_receivers();
+    test_senders();
+    test_timed_out_waiters();
+    test_pass();
+}
+
+int main(void) { test_run(&runner_thread); }
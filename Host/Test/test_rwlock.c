@@ -0,0 +1,176 @@
+/**
+ * @file test_rwlock.c
+ * @brief Reader-writer lock: concurrent readers, writer preference, timeouts
+ *        and priority inheritance to every lock owner
+ */
+
+#include "test.h"
+
+#define READERS 8
+
+static OCTOS_RWLOCK_DEFINE(rwlock);
+static OCTOS_MUTEX_DEFINE(mutex);
+static volatile uint32_t active_readers;
+static volatile uint32_t max_active_readers;
+static volatile uint32_t done_readers;
+static volatile bool writer_done;
+
+/* Helper Tasks --------------------------------------------------------------*/
+
+static void reader_thread(OCTOS_UNUSED void *args) {
+    RwLockHold_t hold;
+
+    TEST_CHECK(rwlock_read_acquire(&rwlock, &hold, UINT32_MAX));
+    active_readers++;
+    if (active_readers > max_active_readers) max_active_readers = active_readers;
+    task_delay(5);
+    active_readers--;
+    TEST_CHECK(rwlock_read_release(&rwlock, &hold));
+    done_readers++;
+}
+
+static void writer_thread(void *args) {
+    const uint32_t timeout_ticks = (uint32_t) (uintptr_t) args;
+
+    writer_done = rwlock_write_acquire(&rwlock, timeout_ticks);
+    if (writer_done) TEST_CHECK(rwlock_write_release(&rwlock));
+}
+
+/* Holds the read lock and the mutex, each step waits for the runner */
+static void owner_thread(OCTOS_UNUSED void *args) {
+    RwLockHold_t hold;
+
+    TEST_CHECK(rwlock_read_acquire(&rwlock, &hold, UINT32_MAX));
+    TEST_CHECK(mutex_acquire(&mutex, UINT32_MAX));
+    task_notify_wait(0, 0, NULL, UINT32_MAX);
+    TEST_CHECK(mutex_release(&mutex));
+    task_notify_wait(0, 0, NULL, UINT32_MAX);
+    TEST_CHECK(rwlock_read_release(&rwlock, &hold));
+    task_notify_wait(0, 0, NULL, UINT32_MAX);
+}
+
+static void mutex_waiter_thread(OCTOS_UNUSED void *args) {
+    TEST_CHECK(!mutex_acquire(&mutex, 5));
+}
+
+/* Holds the mutex while blocked on the write lock */
+static void chain_thread(OCTOS_UNUSED void *args) {
+    TEST_CHECK(mutex_acquire(&mutex, UINT32_MAX));
+    TEST_CHECK(rwlock_write_acquire(&rwlock, UINT32_MAX));
+    TEST_CHECK(rwlock_write_release(&rwlock));
+    TEST_CHECK(mutex_release(&mutex));
+}
+
+static void mutex_user_thread(OCTOS_UNUSED void *args) {
+    TEST_CHECK(mutex_acquire(&mutex, UINT32_MAX));
+    TEST_CHECK(mutex_release(&mutex));
+}
+
+/* Scenarios -----------------------------------------------------------------*/
+
+static void test_concurrent_readers(void) {
+    for (size_t i = 0; i < READERS; i++)
+        test_spawn(&reader_thread, NULL, "READER", 2);
+
+    task_delay(20);
+    TEST_CHECK(done_readers == READERS);
+    TEST_CHECK(max_active_readers == READERS);
+}
+
+static void test_writer_preference(void) {
+    RwLockHold_t hold;
+
+    TaskHandle_t owner = test_spawn(&owner_thread, NULL, "OWNER", 1);
+    task_delay(2);
+    test_spawn(&writer_thread, (void *) (uintptr_t) UINT32_MAX, "WRITER", 2);
+    task_delay(2);
+
+    /* A waiting writer holds off new readers */
+    TEST_CHECK(!rwlock_read_acquire(&rwlock, &hold, 0));
+    TEST_CHECK(!rwlock_write_acquire(&rwlock, 0));
+
+    task_notify(owner, 0, NoAction);
+    task_delay(2);
+    task_notify(owner, 0, NoAction);
+    task_delay(2);
+    TEST_CHECK(writer_done);
+    task_notify(owner, 0, NoAction);
+
+    TEST_CHECK(rwlock_read_acquire(&rwlock, &hold, 0));
+    TEST_CHECK(rwlock_read_release(&rwlock, &hold));
+    TEST_CHECK(!rwlock_read_release(&rwlock, &hold));
+}
+
+static void test_priority_inheritance(void) {
+    writer_done = false;
+    TaskHandle_t owner = test_spawn(&owner_thread, NULL, "OWNER", 1);
+    task_delay(2);
+
+    /* A timed out writer takes back what it lent */
+    test_spawn(&writer_thread, (void *) (uintptr_t) 5, "WRITER", 2);
+    task_delay(2);
+    TEST_CHECK(owner->Priority == 2);
+    task_delay(6);
+    TEST_CHECK(!writer_done);
+    TEST_CHECK(owner->Priority == 1);
+
+    test_spawn(&writer_thread, (void *) (uintptr_t) UINT32_MAX, "WRITER", 3);
+    task_delay(2);
+    TEST_CHECK(owner->Priority == 3);
+
+    /* A mutex waiter coming and going does not drop the rwlock boost */
+    test_spawn(&mutex_waiter_thread, NULL, "WAITER", 2);
+    task_delay(2);
+    TEST_CHECK(owner->Priority == 3);
+    task_delay(6);
+    TEST_CHECK(owner->Priority == 3);
+
+    task_notify(owner, 0, NoAction);
+    task_delay(2);
+    TEST_CHECK(owner->Priority == 3);
+
+    task_notify(owner, 0, NoAction);
+    task_delay(2);
+    TEST_CHECK(writer_done);
+    TEST_CHECK(owner->Priority == 1);
+    task_notify(owner, 0, NoAction);
+}
+
+static void test_chain_propagation(void) {
+    RwLockHold_t hold;
+
+    TaskHandle_t owner = test_spawn(&owner_thread, NULL, "OWNER", 1);
+    task_delay(2);
+    /* Hand the mutex over, the owner keeps its read lock */
+    task_notify(owner, 0, NoAction);
+    task_delay(2);
+
+    /* Boost through the mutex of a writer blocked on the read lock */
+    TaskHandle_t writer = test_spawn(&chain_thread, NULL, "CHAIN", 1);
+    task_delay(2);
+    TEST_CHECK(!rwlock_read_acquire(&rwlock, &hold, 0));
+    TEST_CHECK(owner->Priority == 1);
+
+    test_spawn(&mutex_user_thread, NULL, "USER", 3);
+    task_delay(2);
+    TEST_CHECK(writer->Priority == 3);
+    TEST_CHECK(owner->Priority == 3);
+
+    task_notify(owner, 0, NoAction);
+    task_delay(2);
+    TEST_CHECK(owner->Priority == 1);
+    task_notify(owner, 0, NoAction);
+    task_delay(2);
+    TEST_CHECK(rwlock_read_acquire(&rwlock, &hold, 0));
+    TEST_CHECK(rwlock_read_release(&rwlock, &hold));
+}
+
+static void runner_thread(OCTOS_UNUSED void *args) {
+    test_concurrent_readers();
+    test_writer_preference();
+    test_priority_inheritance();
+    test_chain_propagation();
+    test_pass();
+}
+
+int main(void) { test_run(&runner_thread); }
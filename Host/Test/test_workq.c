@@ -0,0 +1,93 @@
+/**
+ * @file test_workq.c
+ * @brief Work queue: an item resubmitted while running runs again on one
+ *        worker at a time, and workers are only woken for queued work
+ */
+
+#include "test.h"
+
+#define WORKERS 2
+#define DELAYED 3
+
+static WorkQueue_t queue;
+static Work_t slow_work;
+static Work_t delayed_work[DELAYED];
+static volatile uint32_t active;
+static volatile uint32_t max_active;
+static volatile uint32_t slow_runs;
+static volatile uint32_t delayed_runs[DELAYED];
+
+/* Work Functions ------------------------------------------------------------*/
+
+static void slow_func(OCTOS_UNUSED void *args) {
+    active++;
+    if (active > max_active) max_active = active;
+    task_delay(3);
+    active--;
+    slow_runs++;
+}
+
+static void delayed_func(void *args) {
+    delayed_runs[(uintptr_t) args]++;
+}
+
+/* Scenarios -----------------------------------------------------------------*/
+
+static void test_resubmit_while_running(void) {
+    TEST_CHECK(workq_submit(&queue, &slow_work));
+    task_delay(1);
+    TEST_CHECK(work_is_running(&slow_work));
+    TEST_CHECK(!work_is_pending(&slow_work));
+
+    /* The idle worker must not pick it up while it runs */
+    TEST_CHECK(workq_submit(&queue, &slow_work));
+    TEST_CHECK(!workq_submit(&queue, &slow_work));
+    TEST_CHECK(work_is_pending(&slow_work));
+    TEST_CHECK(queue.Sema.Count == 0);
+
+    task_delay(10);
+    TEST_CHECK(slow_runs == 2);
+    TEST_CHECK(max_active == 1);
+    TEST_CHECK(!work_is_running(&slow_work));
+}
+
+static void test_cancel_rerun(void) {
+    slow_runs = 0;
+
+    TEST_CHECK(workq_submit(&queue, &slow_work));
+    task_delay(1);
+    TEST_CHECK(workq_submit(&queue, &slow_work));
+    TEST_CHECK(workq_cancel(&queue, &slow_work));
+    TEST_CHECK(!work_is_pending(&slow_work));
+
+    task_delay(10);
+    TEST_CHECK(slow_runs == 1);
+}
+
+static void test_delayed_wakes(void) {
+    /* Only the first due tick wakes an idle worker, later ones do not */
+    for (uintptr_t i = 0; i < DELAYED; i++) {
+        work_init(&delayed_work[i], &delayed_func, (void *) i, 1);
+        TEST_CHECK(workq_submit_delayed(&queue, &delayed_work[i], 5 + i * 5));
+    }
+    TEST_CHECK(queue.Sema.Count == 1);
+
+    task_delay(7);
+    TEST_CHECK(delayed_runs[0] == 1 && delayed_runs[1] == 0);
+    TEST_CHECK(workq_cancel(&queue, &delayed_work[2]));
+    task_delay(15);
+    TEST_CHECK(delayed_runs[1] == 1 && delayed_runs[2] == 0);
+}
+
+static void runner_thread(OCTOS_UNUSED void *args) {
+    work_init(&slow_work, &slow_func, NULL, 1);
+    TEST_CHECK(workq_init(&queue, "WORKER", 2, WORKERS, TEST_PAGE_SIZE));
+    task_delay(2);
+
+    test_resubmit_while_running();
+    test_cancel_rerun();
+    test_delayed_wakes();
+    test_pass();
+}
+
+int main(void) { test_run(&runner_thread); }